@@ -0,0 +1,98 @@
+/*
+ * Telemetry Airtime Report
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Prints LoRa time-on-air per telemetry packet at each spreading factor for
+ * the legacy JSON document and the binary frame (core only / every section
+ * of telemetry_frame.h populated).
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software airtime_report.cpp -o airtime_report
+ *   ./airtime_report
+ */
+
+#include <cstdio>
+
+#include "lora_airtime.h"
+#include "telemetry_delta.h"
+
+static TelemetrySnapshot sampleSnapshot(uint8_t sections) {
+  TelemetrySnapshot t = TelemetrySnapshot();
+  t.type = TELEMETRY_STATUS;
+  t.sequence = 42;
+  t.sections = sections;
+  t.timeSeconds = 1234;
+  t.state = 2;
+  t.threat = 3;
+  t.battery = 76.5f;
+  t.power = 14.8f;
+  t.altitude = 1234.5f;
+  t.verticalSpeed = -1.2f;
+  t.temperature = 23.5f;
+  t.birdConfidence = 87;
+  t.birdDistance = 45.0f;
+  t.birdBearing = 12.0f;
+  t.birdSpecies = 1;
+  t.enduranceSeconds = 3600.0f;
+  t.enduranceLowSeconds = 2900.0f;
+  t.enduranceHighSeconds = 4300.0f;
+  t.rangeMeters = 50000.0f;
+  t.rangeLowMeters = 40300.0f;
+  t.shedTier = 0;
+  t.shedEvents = 2;
+  t.eventCode = TELEMETRY_EVENT_STRIKE;
+  t.eventValue = 6;
+  t.powerMin = 9.1f;
+  t.powerMax = 22.4f;
+  t.verticalSpeedMin = -2.1f;
+  t.verticalSpeedMax = 0.8f;
+  t.packVoltageMin = 22.35f;
+  t.maxThreat = 3;
+  t.detections = 7;
+  t.stateChanges = 2;
+  t.airtimeUsage = 41.0f;
+  t.commandCounter = 517;
+  t.commandResult = 0;
+  t.healthFlags = 0x024;
+  t.freeHeapKb = 148.0f;
+  t.i2cErrors = 3;
+  t.loraTxFailures = 1;
+  t.loopOverruns = 12;
+  t.piRate = 10;
+  t.piAgeSeconds = 0.1f;
+  return t;
+}
+
+int main() {
+  // Legacy sendTelemetryData() JSON with a bird in view
+  char json[256];
+  int jsonBytes = snprintf(json, sizeof(json),
+                           "{\"timestamp\":1234567,\"state\":2,\"threat\":3,\"battery\":76.54321,"
+                           "\"power\":14.87654,\"altitude\":1234.567,\"temperature\":23.45,"
+                           "\"bird_detected\":true,\"bird_confidence\":87,\"bird_distance\":45.6789}");
+
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  TelemetrySnapshot core = sampleSnapshot(0);
+  TelemetrySnapshot full = sampleSnapshot(TELEMETRY_ALL_SECTIONS);
+  int coreBytes = (int)telemetryEncode(core, frame, sizeof(frame));
+  int fullBytes = (int)telemetryEncode(full, frame, sizeof(frame));
+
+  printf("Payload sizes: JSON %d B, binary core %d B, binary all sections %d B\n\n",
+         jsonBytes, coreBytes, fullBytes);
+
+  const uint8_t codingRates[] = {8, 5};
+  for (unsigned c = 0; c < sizeof(codingRates); c++) {
+    printf("BW 125 kHz, CR 4/%d - time on air (ms)\n", codingRates[c]);
+    printf("%4s %10s %10s %10s %12s\n", "SF", "JSON", "core", "all", "max Hz (all)");
+    for (uint8_t sf = 7; sf <= 12; sf++) {
+      LoRaModulation mod = {sf, 125000, codingRates[c]};
+      uint32_t tJson = loraTimeOnAirMicros(mod, jsonBytes);
+      uint32_t tCore = loraTimeOnAirMicros(mod, coreBytes);
+      uint32_t tFull = loraTimeOnAirMicros(mod, fullBytes);
+      printf("%4d %10.1f %10.1f %10.1f %12.2f\n", sf, tJson / 1000.0, tCore / 1000.0,
+             tFull / 1000.0, 1e6 / tFull);
+    }
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Black-Box Dump Decoder
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Decodes an image of the flight recorder partition (software/
+ * flight_recorder.h) read off the drone with
+ *   esptool.py read_flash 0x310000 0x4E0000 blackbox.bin
+ * The image is mmapped and walked sector by sector, oldest first. By
+ * default every block is written out as CSV, one line per sample:
+ *   <boot>,<ms since boot>,<record type>,<field values in FR_LAYOUTS order>
+ * Lines are in time order within a record type; types interleave block
+ * by block. With -c only one channel is pulled: blocks of other types are
+ * stepped over on their directories and only the time column and that
+ * field's column are decoded:
+ *   <boot>,<ms since boot>,<value>
+ * Torn pages from a power cut are skipped and counted.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software blackbox_dump.cpp -o blackbox_dump
+ *   ./blackbox_dump blackbox.bin [boot] > flight.csv
+ *   ./blackbox_dump -c imu.az blackbox.bin [boot] > az.csv
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "flight_recorder.h"
+
+struct SectorRef {
+  uint32_t index;
+  RecorderSectorHeader header;
+  bool operator<(const SectorRef &o) const { return header.sequence < o.header.sequence; }
+};
+
+static int usage() {
+  fprintf(stderr, "usage: blackbox_dump [-c <type>.<field>] <image> [boot]\n");
+  return 2;
+}
+
+// "imu.az" -> record type and field index
+static bool parseChannel(const char *name, int &type, int &field) {
+  const char *dot = strchr(name, '.');
+  if (!dot) return false;
+  for (type = 0; type < FR_RECORD_TYPES; type++) {
+    const FlightRecordLayout &layout = FR_LAYOUTS[type];
+    if (strlen(layout.name) != (size_t)(dot - name) || strncmp(name, layout.name, dot - name) != 0) continue;
+    for (field = 0; field < layout.fields; field++) {
+      if (strcmp(dot + 1, layout.fieldNames[field]) == 0) return true;
+    }
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  int arg = 1;
+  int channelType = -1, channelField = -1;
+  if (argc > 2 && strcmp(argv[1], "-c") == 0) {
+    if (!parseChannel(argv[2], channelType, channelField)) {
+      fprintf(stderr, "unknown channel %s\n", argv[2]);
+      return 2;
+    }
+    arg = 3;
+  }
+  if (arg >= argc) return usage();
+
+  int fd = open(argv[arg], O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    perror(argv[arg]);
+    return 1;
+  }
+  size_t size = (size_t)st.st_size;
+  if (size < FR_SECTOR_SIZE) {
+    fprintf(stderr, "%s: too small for a recorder image\n", argv[arg]);
+    return 1;
+  }
+  const uint8_t *image = (const uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (image == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  long onlyBoot = arg + 1 < argc ? atol(argv[arg + 1]) : -1;
+
+  std::vector<SectorRef> sectors;
+  for (uint32_t s = 0; (s + 1) * (size_t)FR_SECTOR_SIZE <= size; s++) {
+    SectorRef ref;
+    ref.index = s;
+    if (frParseSectorHeader(image + (size_t)s * FR_SECTOR_SIZE, ref.header)) sectors.push_back(ref);
+  }
+  std::sort(sectors.begin(), sectors.end());
+
+  uint32_t pages = 0, torn = 0, bad = 0, records[FR_RECORD_TYPES] = {0}, maxWear = 0;
+  size_t bytes[FR_RECORD_TYPES] = {0};
+  uint32_t ms[FR_BLOCK_SAMPLES];
+  float values[FR_MAX_FIELDS][FR_BLOCK_SAMPLES];
+  for (size_t i = 0; i < sectors.size(); i++) {
+    const SectorRef &ref = sectors[i];
+    if (ref.header.eraseCount > maxWear) maxWear = ref.header.eraseCount;
+    if (onlyBoot >= 0 && ref.header.boot != (uint32_t)onlyBoot) continue;
+
+    for (int p = 1; p < FR_PAGES_PER_SECTOR; p++) {
+      const uint8_t *page = image + (size_t)ref.index * FR_SECTOR_SIZE + p * FR_PAGE_SIZE;
+      uint32_t baseMs;
+      int payload = frPagePayload(page, baseMs);
+      if (payload < 0) {
+        if (frGet16(page) != 0xFFFF) torn++;
+        continue;
+      }
+      pages++;
+
+      size_t offset = 0, start = 0;
+      RecorderBlockView block;
+      for (; frNextBlock(page, payload, offset, block); start = offset) {
+        if (channelType >= 0 && block.type != channelType) continue;
+        int count = frDecodeTimes(block, ms);
+        if (count < 0) {
+          bad++;
+          continue;
+        }
+        records[block.type] += count;
+        bytes[block.type] += offset - start;
+
+        if (channelType >= 0) {
+          if (frDecodeChannel(block, channelField, values[0]) != count) {
+            bad++;
+            continue;
+          }
+          for (int s = 0; s < count; s++) {
+            printf("%u,%u,%g\n", (unsigned)ref.header.boot, (unsigned)ms[s], values[0][s]);
+          }
+          continue;
+        }
+
+        const FlightRecordLayout &layout = FR_LAYOUTS[block.type];
+        bool ok = true;
+        for (int f = 0; f < layout.fields; f++) ok = ok && frDecodeChannel(block, f, values[f]) == count;
+        if (!ok) {
+          bad++;
+          continue;
+        }
+        for (int s = 0; s < count; s++) {
+          printf("%u,%u,%s", (unsigned)ref.header.boot, (unsigned)ms[s], layout.name);
+          for (int f = 0; f < layout.fields; f++) printf(",%g", values[f][s]);
+          printf("\n");
+        }
+      }
+      if (offset != (size_t)payload) bad++;
+    }
+  }
+
+  fprintf(stderr, "%zu sectors in use (max erase count %u), %u pages, %u torn, %u malformed\n",
+          sectors.size(), (unsigned)maxWear, (unsigned)pages, (unsigned)torn, (unsigned)bad);
+  for (int t = 0; t < FR_RECORD_TYPES; t++) {
+    if (records[t] == 0) continue;
+    // Against 1 type + 2 time + 2 per field bytes a row
+    size_t rowBytes = records[t] * (3 + 2 * FR_LAYOUTS[t].fields);
+    fprintf(stderr, "  %-10s %u records, %.1f bytes each (%.1fx vs rows)\n", FR_LAYOUTS[t].name,
+            (unsigned)records[t], (double)bytes[t] / records[t], (double)rowBytes / bytes[t]);
+  }
+  munmap((void *)image, size);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Per-Mission Energy Report
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Reads controller serial / flight logs and turns the cumulative ENERGY
+ * records written by logEnergyProfile() into a per-mission breakdown of
+ * energy by SystemState and by actuator channel.
+ *
+ * Record format (one per line, anything before "ENERGY," is ignored so
+ * timestamped serial captures work as-is):
+ *   ENERGY,<ms>,<4 x state Wh>,<4 x state s>,<8 x channel Wh>
+ *
+ * Records are cumulative since boot, so the last record of a mission holds
+ * its totals. A new mission starts whenever the controller clock goes
+ * backwards (reboot / power cycle).
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 energy_report.cpp -o energy_report
+ *   ./energy_report flight1.log [flight2.log ...]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int NUM_STATES = 4;
+static const int NUM_CHANNELS = 8;
+
+static const char *STATE_NAMES[NUM_STATES] = {"STANDBY", "ALERT", "ACTIVE", "EMERGENCY"};
+static const char *CHANNEL_NAMES[NUM_CHANNELS] = {
+  "Strobe 1", "Strobe 2", "Strobe 3", "Strobe 4",
+  "Audio", "Raspberry Pi (5V)", "Controller (3V3)", "12V other"
+};
+
+struct EnergyRecord {
+  unsigned long ms;
+  double stateWh[NUM_STATES];
+  double stateSeconds[NUM_STATES];
+  double channelWh[NUM_CHANNELS];
+};
+
+struct Mission {
+  const char *source;
+  EnergyRecord last;
+  int records;
+};
+
+static bool parseRecord(const char *line, EnergyRecord &rec) {
+  const char *p = strstr(line, "ENERGY,");
+  if (!p) return false;
+  p += 7;
+
+  char *end;
+  rec.ms = strtoul(p, &end, 10);
+  if (end == p) return false;
+  p = end;
+
+  const int numFields = 2 * NUM_STATES + NUM_CHANNELS;
+  double *fields[numFields];
+  for (int i = 0; i < NUM_STATES; i++) fields[i] = &rec.stateWh[i];
+  for (int i = 0; i < NUM_STATES; i++) fields[NUM_STATES + i] = &rec.stateSeconds[i];
+  for (int i = 0; i < NUM_CHANNELS; i++) fields[2 * NUM_STATES + i] = &rec.channelWh[i];
+
+  for (int i = 0; i < numFields; i++) {
+    if (*p != ',') return false;
+    p++;
+    *fields[i] = strtod(p, &end);
+    if (end == p) return false;
+    p = end;
+  }
+  return true;
+}
+
+static void printMission(int index, const Mission &m) {
+  const double *stateWh = m.last.stateWh;
+  const double *stateSeconds = m.last.stateSeconds;
+  const double *channelWh = m.last.channelWh;
+  double seconds = m.last.ms / 1000.0;
+  double totalWh = 0, channelTotal = 0;
+  for (int i = 0; i < NUM_STATES; i++) totalWh += stateWh[i];
+  for (int i = 0; i < NUM_CHANNELS; i++) channelTotal += channelWh[i];
+
+  printf("Mission %d (%s): %.0f s, %d records, %.2f Wh, %.1f W average\n\n",
+         index, m.source, seconds, m.records, totalWh, seconds > 0 ? totalWh * 3600.0 / seconds : 0.0);
+
+  printf("  %-20s %10s %8s %10s %10s\n", "State", "Wh", "%", "time s", "avg W");
+  for (int i = 0; i < NUM_STATES; i++) {
+    double avgW = stateSeconds[i] > 0 ? stateWh[i] * 3600.0 / stateSeconds[i] : 0.0;
+    printf("  %-20s %10.3f %8.1f %10.0f %10.2f\n", STATE_NAMES[i], stateWh[i],
+           totalWh > 0 ? 100.0 * stateWh[i] / totalWh : 0.0, stateSeconds[i], avgW);
+  }
+
+  printf("\n  %-20s %10s %8s\n", "Channel", "Wh", "%");
+  for (int i = 0; i < NUM_CHANNELS; i++) {
+    printf("  %-20s %10.3f %8.1f\n", CHANNEL_NAMES[i], channelWh[i],
+           channelTotal > 0 ? 100.0 * channelWh[i] / channelTotal : 0.0);
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <log> [log ...]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<Mission> missions;
+  char line[512];
+
+  for (int f = 1; f < argc; f++) {
+    FILE *file = fopen(argv[f], "r");
+    if (!file) {
+      fprintf(stderr, "Cannot open %s\n", argv[f]);
+      return 2;
+    }
+
+    bool open = false;
+    while (fgets(line, sizeof(line), file)) {
+      EnergyRecord rec;
+      if (!parseRecord(line, rec)) continue;
+
+      if (!open || rec.ms < missions.back().last.ms) {
+        Mission m;
+        m.source = argv[f];
+        m.last = rec;
+        m.records = 1;
+        missions.push_back(m);
+        open = true;
+        continue;
+      }
+
+      Mission &m = missions.back();
+      m.last = rec;
+      m.records++;
+    }
+    fclose(file);
+  }
+
+  if (missions.empty()) {
+    fprintf(stderr, "No ENERGY records found\n");
+    return 1;
+  }
+
+  for (size_t i = 0; i < missions.size(); i++) printMission((int)i + 1, missions[i]);
+  return 0;
+}
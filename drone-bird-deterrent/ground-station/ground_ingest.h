@@ -0,0 +1,409 @@
+/*
+ * Ground-Station Telemetry Ingest
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * The pipeline behind ground_ingestd. Each source is one radio or serial
+ * bridge printing hex payloads, LoRa frames and ESP-NOW batches alike (as
+ * read by telemetry_decode), and stands for one drone. A reader per source
+ * parses lines into a lock-free single-producer / single-consumer queue;
+ * a pool of workers drains them. Every source belongs to exactly one
+ * worker, so its decoder state (keyframes, FEC groups), its store files
+ * and its latest-state slot have a single writer and need no locks, and a
+ * drone's frames stay in order.
+ *
+ * Store, appended to by the owning worker:
+ *   <dir>/<source>/<YYYYMMDD-HH>.tlm      one file per UTC hour of arrival
+ *     header   magic "GTS1"
+ *     record   ground ms 8 | drone ms 4 | frame length 1 | frame
+ * Deltas are resolved and parity is dropped before storing, so each
+ * record is a full telemetry frame that decodes on its own.
+ *
+ * Optionally the same samples also go to a compressed, queryable history
+ * (telemetry_store.h) under <history>/<source>/, timed by arrival with
+ * batch and rebuilt samples moved back by their drone-time offset. Its
+ * open block is sealed when full, after INGEST_HISTORY_SEAL_MS, and on stop.
+ *
+ * The latest state of each drone is published through a sequence lock:
+ * the worker never waits, and a query retries if it overlapped a write.
+ *
+ * Header only, C++11 threads; build with -I../software -pthread.
+ */
+
+#ifndef GROUND_INGEST_H
+#define GROUND_INGEST_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+#include "telemetry_decoder.h"
+#include "telemetry_delta.h"
+#include "telemetry_fec.h"
+#include "telemetry_store.h"
+#include "telemetry_transport.h"
+
+#define INGEST_QUEUE_SLOTS      4096     // Per source, a power of two
+#define INGEST_WORKER_BATCH     64       // Frames taken from one queue at a time
+#define INGEST_IDLE_US          200      // Worker sleep with every queue empty
+#define INGEST_FLUSH_MS         1000     // Store buffers written out at least this often
+#define INGEST_STORE_MAGIC      0x31535447UL  // "GTS1"
+#define INGEST_RECORD_HEADER    13
+#define INGEST_FILE_BUFFER      (64 * 1024)
+#define INGEST_HISTORY_SEAL_MS  60000    // Longest a history sample waits in an open block
+
+struct IngestFrame {
+  uint64_t groundMs;
+  uint8_t length;
+  uint8_t data[ESPNOW_MAX_PAYLOAD];
+};
+
+// Lamport ring: head written by the reader only, tail by the worker only,
+// each on its own cache line
+struct IngestQueue {
+  std::atomic<uint32_t> head;
+  uint8_t padHead[60];
+  std::atomic<uint32_t> tail;
+  uint8_t padTail[60];
+  IngestFrame slots[INGEST_QUEUE_SLOTS];
+};
+
+struct IngestLatest {
+  std::atomic<uint32_t> version;  // Odd while the worker is writing
+  TelemetrySnapshot snapshot;
+  uint64_t groundMs;
+  uint32_t droneMs;
+};
+
+struct IngestSource {
+  std::string name;
+  IngestQueue queue;
+
+  // Reader side
+  std::atomic<uint64_t> lines;
+  std::atomic<uint64_t> badLines;
+  std::atomic<uint64_t> stalls;          // Pushes that found the queue full
+
+  // Worker side
+  TelemetryDeltaDecoder delta;
+  FecDecoder fec;
+  FILE *file;
+  uint64_t fileHour;                     // Ground ms / 3600000 of the open file
+  std::atomic<uint64_t> frames;
+  std::atomic<uint64_t> samples;
+  std::atomic<uint64_t> undecodable;
+  std::atomic<uint64_t> storedBytes;
+  std::unique_ptr<TsWriter> history;     // Null without a history store
+  uint64_t historyOpenedMs;              // Wall time of the open block's first sample
+  uint64_t lastGroundMs;                 // Arrival and drone time of the newest sample
+  uint32_t lastDroneMs;
+
+  IngestLatest latest;
+};
+
+struct IngestPipeline {
+  std::string dir;
+  std::string historyDir;                // Empty without a history store
+  std::vector<std::unique_ptr<IngestSource> > sources;
+  std::vector<std::thread> workers;
+  std::atomic<bool> stopping;
+  std::atomic<uint64_t> storeErrors;
+};
+
+inline uint64_t ingestNowMs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+inline void ingestPut32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint32_t ingestGet32(const uint8_t *p) {
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline bool ingestQueuePush(IngestQueue &q, const IngestFrame &frame) {
+  uint32_t head = q.head.load(std::memory_order_relaxed);
+  if (head - q.tail.load(std::memory_order_acquire) == INGEST_QUEUE_SLOTS) return false;
+  IngestFrame &slot = q.slots[head & (INGEST_QUEUE_SLOTS - 1)];
+  slot.groundMs = frame.groundMs;
+  slot.length = frame.length;
+  memcpy(slot.data, frame.data, frame.length);
+  q.head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// The slot stays valid until ingestQueueRelease()
+inline const IngestFrame *ingestQueuePeek(IngestQueue &q) {
+  uint32_t tail = q.tail.load(std::memory_order_relaxed);
+  if (tail == q.head.load(std::memory_order_acquire)) return NULL;
+  return &q.slots[tail & (INGEST_QUEUE_SLOTS - 1)];
+}
+
+inline void ingestQueueRelease(IngestQueue &q) {
+  q.tail.store(q.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+inline void ingestPublish(IngestLatest &latest, const TelemetrySnapshot &t, uint64_t groundMs, uint32_t droneMs) {
+  uint32_t v = latest.version.load(std::memory_order_relaxed);
+  latest.version.store(v + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  latest.snapshot = t;
+  latest.groundMs = groundMs;
+  latest.droneMs = droneMs;
+  latest.version.store(v + 2, std::memory_order_release);
+}
+
+// Latest state of one source; false if nothing has been decoded yet
+inline bool ingestLatest(const IngestSource &source, TelemetrySnapshot &t, uint64_t &groundMs, uint32_t &droneMs) {
+  for (;;) {
+    uint32_t before = source.latest.version.load(std::memory_order_acquire);
+    if (before == 0) return false;
+    if (before & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    t = source.latest.snapshot;
+    groundMs = source.latest.groundMs;
+    droneMs = source.latest.droneMs;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (source.latest.version.load(std::memory_order_relaxed) == before) return true;
+  }
+}
+
+inline IngestSource *ingestFind(IngestPipeline &p, const char *name) {
+  for (size_t i = 0; i < p.sources.size(); i++) {
+    if (p.sources[i]->name == name) return p.sources[i].get();
+  }
+  return NULL;
+}
+
+// Reader side: parse one hex line and queue it, waiting while the worker
+// catches up rather than dropping
+inline bool ingestPushLine(IngestSource &source, const char *line, uint64_t groundMs) {
+  IngestFrame frame;
+  size_t length = telemetryParseHex(line, frame.data, sizeof(frame.data));
+  source.lines.fetch_add(1, std::memory_order_relaxed);
+  if (length == 0) {
+    source.badLines.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  frame.length = (uint8_t)length;
+  frame.groundMs = groundMs;
+  if (ingestQueuePush(source.queue, frame)) return true;
+  source.stalls.fetch_add(1, std::memory_order_relaxed);
+  while (!ingestQueuePush(source.queue, frame)) std::this_thread::yield();
+  return true;
+}
+
+// Append one record to the hour partition the frame arrived in
+inline bool ingestStore(IngestPipeline &p, IngestSource &s, uint64_t groundMs, uint32_t droneMs,
+                        const TelemetrySnapshot &t) {
+  uint64_t hour = groundMs / 3600000ULL;
+  if (!s.file || hour != s.fileHour) {
+    if (s.file) fclose(s.file);
+    time_t seconds = (time_t)(hour * 3600);
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char name[32];
+    strftime(name, sizeof(name), "/%Y%m%d-%H.tlm", &utc);
+    std::string path = p.dir + "/" + s.name + name;
+    s.file = fopen(path.c_str(), "ab");
+    s.fileHour = hour;
+    if (!s.file) return false;
+    setvbuf(s.file, NULL, _IOFBF, INGEST_FILE_BUFFER);
+    fseek(s.file, 0, SEEK_END);
+    if (ftell(s.file) == 0) {
+      uint8_t magic[4];
+      ingestPut32(magic, INGEST_STORE_MAGIC);
+      fwrite(magic, 1, sizeof(magic), s.file);
+    }
+  }
+
+  uint8_t record[INGEST_RECORD_HEADER + TELEMETRY_MAX_FRAME];
+  size_t length = telemetryEncode(t, record + INGEST_RECORD_HEADER, TELEMETRY_MAX_FRAME);
+  if (length == 0) return false;
+  ingestPut32(record, (uint32_t)groundMs);
+  ingestPut32(record + 4, (uint32_t)(groundMs >> 32));
+  ingestPut32(record + 8, droneMs);
+  record[12] = (uint8_t)length;
+  length += INGEST_RECORD_HEADER;
+  if (fwrite(record, 1, length, s.file) != length) return false;
+  s.storedBytes.fetch_add(length, std::memory_order_relaxed);
+  return true;
+}
+
+inline void ingestHistory(IngestPipeline &p, IngestSource &s, const TelemetrySnapshot &t, uint64_t sampleMs) {
+  float values[TS_METRICS];
+  tsSnapshotValues(t, values);
+  if (s.history->count == 0) s.historyOpenedMs = ingestNowMs();
+  if (!tsAppend(*s.history, (int64_t)sampleMs, values)) p.storeErrors.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Rebuilt (FEC) frames are older than what has already been published.
+// sampleMs is when the sample was taken, in ground time.
+inline void ingestSample(IngestPipeline &p, IngestSource &s, const TelemetrySnapshot &t, uint64_t groundMs,
+                         uint32_t droneMs, uint64_t sampleMs, bool rebuilt) {
+  if (!rebuilt) {
+    ingestPublish(s.latest, t, groundMs, droneMs);
+    s.lastGroundMs = groundMs;
+    s.lastDroneMs = droneMs;
+  }
+  if (!ingestStore(p, s, groundMs, droneMs, t)) p.storeErrors.fetch_add(1, std::memory_order_relaxed);
+  if (s.history) ingestHistory(p, s, t, sampleMs);
+  s.samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void ingestDecode(IngestPipeline &p, IngestSource &s, const IngestFrame &f) {
+  TelemetrySnapshot t = TelemetrySnapshot();
+  s.frames.fetch_add(1, std::memory_order_relaxed);
+
+  if (telemetryIsBatch(f.data, f.length)) {
+    size_t offset = 0;
+    uint32_t ms, lastMs = 0;
+    // The batch arrived with its newest sample; the others are older by their offset
+    if (s.history) {
+      while (telemetryBatchNext(f.data, f.length, offset, t, ms)) lastMs = ms;
+      offset = 0;
+    }
+    while (telemetryBatchNext(f.data, f.length, offset, t, ms)) {
+      ingestSample(p, s, t, f.groundMs, ms, f.groundMs - (lastMs - ms), false);
+    }
+    if (offset != f.length) s.undecodable.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  if (telemetryIsParity(f.data, f.length)) {
+    uint8_t rebuilt[FEC_MAX_PARITY][TELEMETRY_MAX_FRAME];
+    uint8_t rebuiltSequence[FEC_MAX_PARITY], rebuiltLength[FEC_MAX_PARITY];
+    int count = fecDecoderAddParity(s.fec, f.data, f.length, rebuilt, rebuiltSequence, rebuiltLength);
+    for (int i = 0; i < count; i++) {
+      if (telemetryDeltaDecode(s.delta, rebuilt[i], rebuiltLength[i], t)) {
+        uint32_t droneMs = t.timeSeconds * 1000;
+        uint64_t sampleMs = f.groundMs;
+        if (s.lastGroundMs > 0 && droneMs <= s.lastDroneMs) sampleMs = s.lastGroundMs - (s.lastDroneMs - droneMs);
+        ingestSample(p, s, t, f.groundMs, droneMs, sampleMs, true);
+      }
+    }
+    return;
+  }
+
+  if (f.length > TELEMETRY_MAX_FRAME || !telemetryDeltaDecode(s.delta, f.data, f.length, t)) {
+    s.undecodable.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  fecDecoderAddData(s.fec, telemetryFrameSequence(f.data, f.length), f.data, f.length);
+  ingestSample(p, s, t, f.groundMs, t.timeSeconds * 1000, f.groundMs, false);
+}
+
+inline void ingestWorker(IngestPipeline *p, size_t index, size_t workers) {
+  uint64_t lastFlush = ingestNowMs();
+  for (;;) {
+    bool stopping = p->stopping.load(std::memory_order_acquire);
+    size_t taken = 0;
+    for (size_t i = index; i < p->sources.size(); i += workers) {
+      IngestSource &s = *p->sources[i];
+      const IngestFrame *f;
+      for (int n = 0; n < INGEST_WORKER_BATCH && (f = ingestQueuePeek(s.queue)) != NULL; n++) {
+        ingestDecode(*p, s, *f);
+        ingestQueueRelease(s.queue);
+        taken++;
+      }
+    }
+
+    uint64_t now = ingestNowMs();
+    if (now - lastFlush >= INGEST_FLUSH_MS) {
+      for (size_t i = index; i < p->sources.size(); i += workers) {
+        IngestSource &s = *p->sources[i];
+        if (s.file) fflush(s.file);
+        if (s.history && s.history->count > 0 && now - s.historyOpenedMs >= INGEST_HISTORY_SEAL_MS &&
+            !tsSeal(*s.history)) {
+          p->storeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      lastFlush = now;
+    }
+    if (taken > 0) continue;
+    // Readers stop first, so an empty pass after stop means nothing is left
+    if (stopping) break;
+    std::this_thread::sleep_for(std::chrono::microseconds(INGEST_IDLE_US));
+  }
+
+  for (size_t i = index; i < p->sources.size(); i += workers) {
+    IngestSource &s = *p->sources[i];
+    if (s.file) fclose(s.file);
+    s.file = NULL;
+    if (s.history && !tsWriterClose(*s.history)) p->storeErrors.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+inline bool ingestOpen(IngestPipeline &p, const char *dir) {
+  p.dir = dir;
+  p.stopping.store(false);
+  p.storeErrors.store(0);
+  return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+// Keep a compressed history as well; before any ingestAddSource()
+inline bool ingestOpenHistory(IngestPipeline &p, const char *dir) {
+  p.historyDir = dir;
+  return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+// All sources are added before ingestStart()
+inline bool ingestAddSource(IngestPipeline &p, const std::string &name) {
+  std::string path = p.dir + "/" + name;
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) return false;
+
+  std::unique_ptr<IngestSource> s(new IngestSource());
+  s->name = name;
+  s->queue.head.store(0);
+  s->queue.tail.store(0);
+  s->lines.store(0);
+  s->badLines.store(0);
+  s->stalls.store(0);
+  telemetryDeltaDecoderInit(s->delta);
+  fecDecoderInit(s->fec);
+  s->file = NULL;
+  s->fileHour = 0;
+  s->frames.store(0);
+  s->samples.store(0);
+  s->undecodable.store(0);
+  s->storedBytes.store(0);
+  if (!p.historyDir.empty()) {
+    s->history.reset(new TsWriter());
+    if (!tsWriterOpen(*s->history, p.historyDir, name)) return false;
+  }
+  s->historyOpenedMs = 0;
+  s->lastGroundMs = 0;
+  s->lastDroneMs = 0;
+  s->latest.version.store(0);
+  p.sources.push_back(std::move(s));
+  return true;
+}
+
+inline void ingestStart(IngestPipeline &p, size_t workers) {
+  if (workers == 0) workers = 1;
+  if (workers > p.sources.size()) workers = p.sources.size();
+  for (size_t w = 0; w < workers; w++) p.workers.push_back(std::thread(ingestWorker, &p, w, workers));
+}
+
+// Call once the readers have stopped; returns when everything queued is stored
+inline void ingestStop(IngestPipeline &p) {
+  p.stopping.store(true, std::memory_order_release);
+  for (size_t w = 0; w < p.workers.size(); w++) p.workers[w].join();
+  p.workers.clear();
+}
+
+#endif
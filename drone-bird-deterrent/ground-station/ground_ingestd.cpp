@@ -0,0 +1,229 @@
+/*
+ * Ground Telemetry Ingest Daemon
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Ingests the telemetry of several drones at once (ground_ingest.h): one
+ * source per LoRa bridge or ESP-NOW ground node, each a file, FIFO or
+ * serial device printing one hex payload per line. Frames are decoded by
+ * a worker pool and stored under <dir>/<name>/ in hourly files. A serial
+ * device is set up beforehand, e.g. stty -F /dev/ttyUSB0 115200 raw.
+ * A source that is a regular file is read to the end once (importing a
+ * capture); the daemon exits when every source is such a file. With -H
+ * the samples also go to a compressed history for ts_query.
+ *
+ * Queries, one per line on a localhost TCP port, answered with JSON lines:
+ *   latest            latest state of every drone
+ *   latest <name>     latest state of one drone
+ *   stats             per-source counters
+ * e.g.  echo latest | nc localhost 5098
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -pthread -I../software ground_ingestd.cpp -o ground_ingestd
+ *   ./ground_ingestd [-w workers] [-p port] [-H history/] store/ alpha=/dev/ttyUSB0 bravo=/dev/ttyUSB1
+ */
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ground_ingest.h"
+
+#define QUERY_PORT          5098
+#define STATS_INTERVAL_MS   10000
+#define REOPEN_DELAY_MS     1000
+
+static volatile sig_atomic_t stopRequested = 0;
+static std::atomic<int> activeReaders(0);
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+static void readerThread(IngestSource *source, std::string path) {
+  char line[2 * ESPNOW_MAX_PAYLOAD + 16];
+  for (;;) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) {
+      perror(path.c_str());
+    } else {
+      while (fgets(line, sizeof(line), f)) ingestPushLine(*source, line, ingestNowMs());
+      fclose(f);
+    }
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) break;
+    // FIFO writer gone or device unplugged: wait for it to come back
+    std::this_thread::sleep_for(std::chrono::milliseconds(REOPEN_DELAY_MS));
+  }
+  activeReaders--;
+}
+
+static std::string latestJson(const IngestSource &s) {
+  TelemetrySnapshot t;
+  uint64_t groundMs;
+  uint32_t droneMs;
+  char json[1152];
+  if (!ingestLatest(s, t, groundMs, droneMs)) {
+    snprintf(json, sizeof(json), "{\"drone\":\"%s\",\"state\":null}", s.name.c_str());
+    return json;
+  }
+  char frame[1024];
+  telemetryFormatJson(t, frame, sizeof(frame));
+  snprintf(json, sizeof(json), "{\"drone\":\"%s\",\"ground_ms\":%llu,\"drone_ms\":%u,\"age_ms\":%lld,%s",
+           s.name.c_str(), (unsigned long long)groundMs, (unsigned)droneMs,
+           (long long)(ingestNowMs() - groundMs), frame + 1);
+  return json;
+}
+
+static std::string statsJson(const IngestSource &s) {
+  char json[512];
+  snprintf(json, sizeof(json),
+           "{\"drone\":\"%s\",\"lines\":%llu,\"bad_lines\":%llu,\"frames\":%llu,\"samples\":%llu,"
+           "\"undecodable\":%llu,\"stalls\":%llu,\"stored_bytes\":%llu}",
+           s.name.c_str(), (unsigned long long)s.lines.load(), (unsigned long long)s.badLines.load(),
+           (unsigned long long)s.frames.load(), (unsigned long long)s.samples.load(),
+           (unsigned long long)s.undecodable.load(), (unsigned long long)s.stalls.load(),
+           (unsigned long long)s.storedBytes.load());
+  return json;
+}
+
+static std::string answer(IngestPipeline &p, const char *query) {
+  std::string out;
+  if (strncmp(query, "latest", 6) == 0) {
+    const char *name = query + 6;
+    while (*name == ' ') name++;
+    if (*name) {
+      IngestSource *s = ingestFind(p, name);
+      return s ? latestJson(*s) + "\n" : "{\"error\":\"unknown drone\"}\n";
+    }
+    for (size_t i = 0; i < p.sources.size(); i++) out += latestJson(*p.sources[i]) + "\n";
+    return out;
+  }
+  if (strcmp(query, "stats") == 0) {
+    for (size_t i = 0; i < p.sources.size(); i++) out += statsJson(*p.sources[i]) + "\n";
+    return out;
+  }
+  return "{\"error\":\"unknown query\"}\n";
+}
+
+// One client at a time; queries are cheap and the workers never wait on them
+static void serveQueries(IngestPipeline &p, int client) {
+  char buffer[256];
+  size_t fill = 0;
+  for (;;) {
+    ssize_t n = recv(client, buffer + fill, sizeof(buffer) - 1 - fill, 0);
+    if (n <= 0) return;
+    fill += (size_t)n;
+    buffer[fill] = '\0';
+    char *end;
+    while ((end = strchr(buffer, '\n')) != NULL) {
+      *end = '\0';
+      if (end > buffer && end[-1] == '\r') end[-1] = '\0';
+      std::string reply = answer(p, buffer);
+      if (send(client, reply.data(), reply.size(), MSG_NOSIGNAL) < 0) return;
+      fill -= (size_t)(end + 1 - buffer);
+      memmove(buffer, end + 1, fill + 1);
+    }
+    if (fill == sizeof(buffer) - 1) return;  // Overlong line
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t workers = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+  int port = QUERY_PORT;
+  const char *history = NULL;
+  int arg = 1;
+  for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+    if (strcmp(argv[arg], "-w") == 0) workers = (size_t)atoi(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-p") == 0) port = atoi(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-H") == 0) history = argv[arg + 1];
+  }
+  if (arg + 1 >= argc) {
+    fprintf(stderr, "usage: ground_ingestd [-w workers] [-p port] [-H history dir] <store dir> <name>=<path> ...\n");
+    return 2;
+  }
+
+  static IngestPipeline pipeline;
+  if (!ingestOpen(pipeline, argv[arg])) {
+    perror(argv[arg]);
+    return 1;
+  }
+  if (history && !ingestOpenHistory(pipeline, history)) {
+    perror(history);
+    return 1;
+  }
+  std::vector<std::string> paths;
+  for (int i = arg + 1; i < argc; i++) {
+    const char *equals = strchr(argv[i], '=');
+    if (!equals || equals == argv[i] || !ingestAddSource(pipeline, std::string(argv[i], equals - argv[i]))) {
+      fprintf(stderr, "bad source %s (expected <name>=<path>)\n", argv[i]);
+      return 2;
+    }
+    paths.push_back(equals + 1);
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  ingestStart(pipeline, workers);
+  activeReaders = (int)paths.size();
+  for (size_t i = 0; i < paths.size(); i++) {
+    std::thread(readerThread, pipeline.sources[i].get(), paths[i]).detach();
+  }
+
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  int yes = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons((uint16_t)port);
+  if (server < 0 || bind(server, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(server, 4) != 0) {
+    perror("query port");
+    server = -1;
+  }
+  fprintf(stderr, "Ingesting %zu source(s) with %zu worker(s) into %s, queries on port %d\n",
+          pipeline.sources.size(), pipeline.workers.size(), argv[arg], port);
+
+  uint64_t lastStats = ingestNowMs(), lastSamples = 0;
+  while (!stopRequested && activeReaders > 0) {
+    struct pollfd pfd = {server, POLLIN, 0};
+    if (server >= 0 && poll(&pfd, 1, 200) > 0) {
+      int client = accept(server, NULL, NULL);
+      if (client >= 0) {
+        serveQueries(pipeline, client);
+        close(client);
+      }
+    } else if (server < 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    uint64_t now = ingestNowMs();
+    if (now - lastStats >= STATS_INTERVAL_MS) {
+      uint64_t samples = 0, stalls = 0, undecodable = 0;
+      for (size_t i = 0; i < pipeline.sources.size(); i++) {
+        samples += pipeline.sources[i]->samples.load();
+        stalls += pipeline.sources[i]->stalls.load();
+        undecodable += pipeline.sources[i]->undecodable.load();
+      }
+      fprintf(stderr, "%.0f samples/s, %llu stored, %llu undecodable, %llu queue stalls, %llu store errors\n",
+              (samples - lastSamples) * 1000.0 / (now - lastStats), (unsigned long long)samples,
+              (unsigned long long)undecodable, (unsigned long long)stalls,
+              (unsigned long long)pipeline.storeErrors.load());
+      lastStats = now;
+      lastSamples = samples;
+    }
+  }
+
+  // Whatever the readers queued is stored before exiting
+  ingestStop(pipeline);
+  for (size_t i = 0; i < pipeline.sources.size(); i++) fprintf(stderr, "%s\n", statsJson(*pipeline.sources[i]).c_str());
+  if (server >= 0) close(server);
+  // Readers of devices may still be blocked in a read; don't tear down under them
+  if (activeReaders > 0) _exit(0);
+  return 0;
+}
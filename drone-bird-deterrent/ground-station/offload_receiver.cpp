@@ -0,0 +1,70 @@
+/*
+ * Log Offload Receiver
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Listens for drones offloading their black box after landing (software/
+ * log_offload.h) and stores each image in <dir> as bbx-<boot>-<sequence>.bin,
+ * resuming interrupted transfers. One line per connection with the
+ * throughput; decode finished images with blackbox_dump.
+ *
+ * The drone finds this host from NVS namespace "offload" (keys "ssid",
+ * "pass", "host", "port"), see docs/implementation-guide.md.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software offload_receiver.cpp -o offload_receiver
+ *   ./offload_receiver flights/ [port]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "offload_receiver.h"
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: offload_receiver <dir> [port]\n");
+    return 2;
+  }
+  int port = argc > 2 ? atoi(argv[2]) : OFFLOAD_PORT;
+
+  int server = socket(AF_INET, SOCK_STREAM, 0);
+  int yes = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons((uint16_t)port);
+  if (server < 0 || bind(server, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(server, 4) != 0) {
+    perror("listen");
+    return 1;
+  }
+  fprintf(stderr, "Waiting for offloads on port %d, storing in %s\n", port, argv[1]);
+
+  for (;;) {
+    struct sockaddr_in peer;
+    socklen_t peerLength = sizeof(peer);
+    int client = accept(server, (struct sockaddr *)&peer, &peerLength);
+    if (client < 0) continue;
+    // Large receive buffer so the drone's window never closes on us
+    int buffer = 1 << 20;
+    setsockopt(client, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    OffloadSessionStats stats;
+    offloadServe(client, argv[1], stats);
+    close(client);
+
+    double received = (double)(stats.verified - stats.resumedAt);
+    printf("%s %s: %.2f MB in %.2f s (%.2f MB/s image, %.2f MB/s on the wire), resumed at %.2f MB, %u/%u chunks erased, %s\n",
+           inet_ntoa(peer.sin_addr), stats.path.c_str(), received / 1e6, stats.seconds,
+           stats.seconds > 0 ? received / 1e6 / stats.seconds : 0.0,
+           stats.seconds > 0 ? stats.wireBytes / 1e6 / stats.seconds : 0.0, stats.resumedAt / 1e6,
+           (unsigned)stats.erasedChunks, (unsigned)stats.chunks,
+           stats.complete ? "complete" : "interrupted");
+    fflush(stdout);
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * Ground-Station Log Offload Receiver
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Receiving side of the post-landing offload (software/log_offload.h) on
+ * one accepted TCP connection. Each image is kept as
+ *   <dir>/bbx-<boot>-<sequence>.bin        partition image for blackbox_dump
+ *   <dir>/bbx-<boot>-<sequence>.progress   bytes verified and synced
+ * so a later connection for the same image resumes where this one
+ * stopped. A chunk that fails its CRC ends the connection; the drone
+ * reconnects and resends from the last ack.
+ *
+ * Header only, POSIX sockets; build with -I../software.
+ */
+
+#ifndef OFFLOAD_RECEIVER_H
+#define OFFLOAD_RECEIVER_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "log_offload.h"
+
+struct OffloadSessionStats {
+  OffloadImage image;
+  std::string path;
+  uint32_t resumedAt;
+  uint32_t verified;
+  uint32_t chunks, erasedChunks;
+  uint64_t wireBytes;
+  double seconds;
+  bool complete;
+};
+
+inline double offloadNow() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+inline bool offloadReadExact(int fd, void *buffer, size_t length) {
+  uint8_t *p = (uint8_t *)buffer;
+  while (length > 0) {
+    ssize_t n = recv(fd, p, length, 0);
+    if (n <= 0) return false;
+    p += n;
+    length -= (size_t)n;
+  }
+  return true;
+}
+
+inline bool offloadWriteExact(int fd, const void *buffer, size_t length) {
+  const uint8_t *p = (const uint8_t *)buffer;
+  while (length > 0) {
+    ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    p += n;
+    length -= (size_t)n;
+  }
+  return true;
+}
+
+inline uint32_t offloadLoadProgress(const std::string &path) {
+  unsigned long verified = 0;
+  FILE *f = fopen(path.c_str(), "r");
+  if (f) {
+    if (fscanf(f, "%lu", &verified) != 1) verified = 0;
+    fclose(f);
+  }
+  return (uint32_t)verified;
+}
+
+// Written to a temporary file and renamed, so a crash leaves the old value
+inline bool offloadSaveProgress(const std::string &path, uint32_t verified) {
+  std::string temporary = path + ".tmp";
+  FILE *f = fopen(temporary.c_str(), "w");
+  if (!f) return false;
+  fprintf(f, "%lu\n", (unsigned long)verified);
+  fflush(f);
+  fsync(fileno(f));
+  fclose(f);
+  return rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// Data synced before the progress that vouches for it
+inline bool offloadCommit(int data, const std::string &progress, uint32_t verified, int socket) {
+  uint8_t ack[OFFLOAD_ACK_LENGTH];
+  if (fsync(data) != 0 || !offloadSaveProgress(progress, verified)) return false;
+  offloadEncodeAck(verified, ack);
+  return offloadWriteExact(socket, ack, sizeof(ack));
+}
+
+// Serve one connection until the image is complete or the link drops.
+// Returns true when the image is complete.
+inline bool offloadServe(int socket, const char *dir, OffloadSessionStats &stats) {
+  memset(&stats.image, 0, sizeof(stats.image));
+  stats.resumedAt = stats.verified = 0;
+  stats.chunks = stats.erasedChunks = 0;
+  stats.wireBytes = 0;
+  stats.seconds = 0.0;
+  stats.complete = false;
+  double start = offloadNow();
+
+  uint8_t hello[OFFLOAD_HELLO_LENGTH];
+  if (!offloadReadExact(socket, hello, sizeof(hello)) || !offloadParseHello(hello, stats.image)) return false;
+  const OffloadImage &image = stats.image;
+
+  char name[64];
+  snprintf(name, sizeof(name), "/bbx-%lu-%lu", (unsigned long)image.boot, (unsigned long)image.sequence);
+  stats.path = std::string(dir) + name + ".bin";
+  std::string progress = std::string(dir) + name + ".progress";
+  int data = open(stats.path.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (data < 0) {
+    perror(stats.path.c_str());
+    return false;
+  }
+
+  uint32_t verified = offloadLoadProgress(progress);
+  if (verified > image.size || verified % image.chunkSize != 0) verified = 0;
+  stats.resumedAt = stats.verified = verified;
+  uint8_t resume[OFFLOAD_RESUME_LENGTH];
+  offloadEncodeResume(verified, resume);
+  bool linkUp = offloadWriteExact(socket, resume, sizeof(resume));
+
+  std::vector<uint8_t> frame(OFFLOAD_FRAME_MAX);
+  std::vector<uint8_t> erased(image.chunkSize, 0xFF);
+  uint32_t sinceAck = 0;
+  while (linkUp && verified < image.size) {
+    if (!offloadReadExact(socket, &frame[0], OFFLOAD_CHUNK_HEADER)) break;
+    size_t remaining = offloadChunkRemaining(&frame[0], image);
+    if (remaining == 0 || frGet32(&frame[1]) != verified) break;  // Out of step: resync by reconnecting
+    if (!offloadReadExact(socket, &frame[OFFLOAD_CHUNK_HEADER], remaining)) break;
+    if (!offloadCheckChunk(&frame[0], OFFLOAD_CHUNK_HEADER + remaining)) break;
+    stats.wireBytes += OFFLOAD_CHUNK_HEADER + remaining;
+
+    bool isErased = frame[0] == OFFLOAD_CHUNK_ERASED;
+    const uint8_t *payload = isErased ? &erased[0] : &frame[OFFLOAD_CHUNK_HEADER];
+    if (pwrite(data, payload, image.chunkSize, verified) != (ssize_t)image.chunkSize) break;
+    verified += image.chunkSize;
+    stats.chunks++;
+    if (isErased) stats.erasedChunks++;
+
+    if (++sinceAck >= OFFLOAD_ACK_CHUNKS || verified == image.size) {
+      linkUp = offloadCommit(data, progress, verified, socket);
+      if (linkUp) stats.verified = verified;
+      sinceAck = 0;
+    }
+  }
+  // Keep what arrived intact even if the link dropped between acks
+  if (verified > stats.verified && fsync(data) == 0 && offloadSaveProgress(progress, verified)) {
+    stats.verified = verified;
+  }
+  close(data);
+
+  stats.seconds = offloadNow() - start;
+  stats.complete = stats.verified == image.size;
+  return stats.complete;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Telemetry Decode Tool
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Reads one hex-encoded LoRa payload per line (as printed by a LoRa serial
+ * bridge) and writes one JSON object per decoded frame. Delta frames are
+ * rebuilt against the keyframes seen earlier in the stream, and frames lost
+ * on air are rebuilt from FEC parity frames where the group allows.
+ * ESP-NOW batches (software/telemetry_transport.h) from the close-in ground
+ * node may be mixed in; each of their samples becomes one object with its
+ * time in ms as "ms".
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software telemetry_decode.cpp -o telemetry_decode
+ *   ./telemetry_decode < packets.hex
+ */
+
+#include <cstdio>
+
+#include "telemetry_decoder.h"
+#include "telemetry_delta.h"
+#include "telemetry_fec.h"
+#include "telemetry_transport.h"
+
+static bool emitFrame(TelemetryDeltaDecoder &decoder, const uint8_t *frame, size_t length) {
+  char json[1024];
+  TelemetrySnapshot t = TelemetrySnapshot();
+  if (!telemetryDeltaDecode(decoder, frame, length, t)) return false;
+  telemetryFormatJson(t, json, sizeof(json));
+  puts(json);
+  return true;
+}
+
+// One object per sample, with the sample time the batch carries
+static int emitBatch(const uint8_t *batch, size_t length, int &lost) {
+  static bool started = false;
+  static uint8_t expected = 0;
+  if (started) lost += (uint8_t)(batch[1] - expected);
+  started = true;
+  expected = (uint8_t)(batch[1] + 1);
+
+  char json[1024];
+  size_t offset = 0;
+  int samples = 0;
+  TelemetrySnapshot t = TelemetrySnapshot();
+  uint32_t ms;
+  while (telemetryBatchNext(batch, length, offset, t, ms)) {
+    int n = telemetryFormatJson(t, json, sizeof(json));
+    if (n > 0 && n < (int)sizeof(json)) snprintf(json + n - 1, sizeof(json) - n + 1, ",\"ms\":%u}", (unsigned)ms);
+    puts(json);
+    samples++;
+    t = TelemetrySnapshot();
+  }
+  return samples;
+}
+
+int main() {
+  char line[2 * ESPNOW_MAX_PAYLOAD + 16];
+  uint8_t frame[ESPNOW_MAX_PAYLOAD];
+  int bad = 0, frames = 0, deltas = 0, parity = 0, batches = 0, samples = 0, batchesLost = 0;
+  unsigned long bytes = 0;
+  TelemetryDeltaDecoder decoder;
+  telemetryDeltaDecoderInit(decoder);
+  static FecDecoder fec;
+  fecDecoderInit(fec);
+
+  while (fgets(line, sizeof(line), stdin)) {
+    size_t length = telemetryParseHex(line, frame, sizeof(frame));
+    if (telemetryIsBatch(frame, length)) {
+      batches++;
+      samples += emitBatch(frame, length, batchesLost);
+      continue;
+    }
+    if (length > 0 && telemetryIsParity(frame, length)) {
+      parity++;
+      uint8_t rebuilt[FEC_MAX_PARITY][TELEMETRY_MAX_FRAME];
+      uint8_t rebuiltSequence[FEC_MAX_PARITY], rebuiltLength[FEC_MAX_PARITY];
+      int count = fecDecoderAddParity(fec, frame, length, rebuilt, rebuiltSequence, rebuiltLength);
+      for (int i = 0; i < count; i++) {
+        if (emitFrame(decoder, rebuilt[i], rebuiltLength[i])) frames++;
+      }
+      continue;
+    }
+    if (length == 0 || length > TELEMETRY_MAX_FRAME || !emitFrame(decoder, frame, length)) {
+      bad++;
+      continue;
+    }
+    fecDecoderAddData(fec, telemetryFrameSequence(frame, length), frame, length);
+    frames++;
+    bytes += length;
+    if (telemetryIsDelta(frame, length)) deltas++;
+  }
+
+  if (frames) {
+    fprintf(stderr, "%d frames (%d deltas), %.1f B/frame\n", frames, deltas, (double)bytes / frames);
+  }
+  if (parity) {
+    fprintf(stderr, "%d parity frames, %u frames rebuilt, %u groups unrecoverable\n", parity,
+            (unsigned)fec.recovered, (unsigned)fec.unrecoverable);
+  }
+  if (batches) {
+    fprintf(stderr, "%d ESP-NOW batches, %d samples (%.1f per batch), %d batches missing\n", batches, samples,
+            (double)samples / batches, batchesLost);
+  }
+  if (bad) fprintf(stderr, "%d undecodable lines (%u missing keyframe)\n", bad, (unsigned)decoder.unresolved);
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Ground-Station Telemetry Decoder
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Decodes binary telemetry frames received over LoRa (software/
+ * telemetry_frame.h) and renders them as the JSON the ground tools used
+ * to receive, so existing consumers keep working.
+ *
+ * Header only; build with -I../software.
+ */
+
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+#include <cstdio>
+#include <cstring>
+
+#include "health_monitor.h"
+#include "telemetry_frame.h"
+
+static const char *const TELEMETRY_STATE_NAMES[] = {"STANDBY", "ALERT", "ACTIVE", "EMERGENCY"};
+static const char *const TELEMETRY_THREAT_NAMES[] = {"NONE", "LOW", "MEDIUM", "HIGH"};
+static const char *const TELEMETRY_EVENT_NAMES[] = {"threat", "state", "strike", "?", "?", "?", "?", "?"};
+static const char *const TELEMETRY_COMMAND_RESULTS[] = {"ok", "stale", "bad_param", "unsupported",
+                                                        "?", "?", "?", "?"};
+
+inline int telemetryHexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Parse "0a1b2c..." into bytes; returns the byte count, 0 on bad input.
+// Hand-rolled rather than sscanf: the ingest daemon parses every line.
+inline size_t telemetryParseHex(const char *hex, uint8_t *buffer, size_t capacity) {
+  size_t count = 0;
+  while (*hex && *hex != '\n' && *hex != '\r') {
+    if (*hex == ' ') {
+      hex++;
+      continue;
+    }
+    int high = telemetryHexDigit(hex[0]);
+    int low = high < 0 ? -1 : telemetryHexDigit(hex[1]);
+    if (count >= capacity || low < 0) return 0;
+    buffer[count++] = (uint8_t)(high << 4 | low);
+    hex += 2;
+  }
+  return count;
+}
+
+// JSON rendering of a decoded frame; returns the length written
+inline int telemetryFormatJson(const TelemetrySnapshot &t, char *out, size_t size) {
+  int n = snprintf(out, size,
+                   "{\"type\":\"%s\",\"seq\":%u,\"time\":%u,\"state\":\"%s\",\"threat\":\"%s\",\"battery\":%.0f,"
+                   "\"power\":%.1f,\"altitude\":%.1f,\"vspeed\":%.1f,\"temperature\":%.1f",
+                   t.type == TELEMETRY_EVENT ? "event" : "status", t.sequence, (unsigned)t.timeSeconds, TELEMETRY_STATE_NAMES[t.state & 3],
+                   TELEMETRY_THREAT_NAMES[t.threat & 3], t.battery, t.power, t.altitude,
+                   t.verticalSpeed, t.temperature);
+  if (t.sections & TELEMETRY_SECTION_BIRD) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0,
+                  ",\"bird_detected\":true,\"bird_confidence\":%u,\"bird_distance\":%.0f,"
+                  "\"bird_bearing\":%.1f,\"bird_species\":%u",
+                  t.birdConfidence, t.birdDistance, t.birdBearing, t.birdSpecies);
+  }
+  if (t.sections & TELEMETRY_SECTION_ENDURANCE) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0,
+                  ",\"endurance_s\":%.0f,\"endurance_lo\":%.0f,\"endurance_hi\":%.0f,"
+                  "\"range_m\":%.0f,\"range_lo\":%.0f",
+                  t.enduranceSeconds, t.enduranceLowSeconds, t.enduranceHighSeconds, t.rangeMeters,
+                  t.rangeLowMeters);
+  }
+  if (t.sections & TELEMETRY_SECTION_POWER) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0, ",\"shed_tier\":%u,\"shed_events\":%u",
+                  t.shedTier, t.shedEvents);
+  }
+  if (t.sections & TELEMETRY_SECTION_EVENT) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0, ",\"event\":\"%s\",\"event_value\":%u",
+                  TELEMETRY_EVENT_NAMES[t.eventCode & 7], t.eventValue);
+  }
+  if (t.sections & TELEMETRY_SECTION_WINDOW) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0,
+                  ",\"power_min\":%.1f,\"power_max\":%.1f,\"vspeed_min\":%.1f,\"vspeed_max\":%.1f,"
+                  "\"voltage_min\":%.2f,\"max_threat\":\"%s\",\"detections\":%u,\"state_changes\":%u,"
+                  "\"airtime_pct\":%.0f",
+                  t.powerMin, t.powerMax, t.verticalSpeedMin, t.verticalSpeedMax, t.packVoltageMin,
+                  TELEMETRY_THREAT_NAMES[t.maxThreat & 3], t.detections, t.stateChanges, t.airtimeUsage);
+  }
+  if (t.sections & TELEMETRY_SECTION_COMMAND) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0, ",\"cmd_counter\":%u,\"cmd_result\":\"%s\"",
+                  t.commandCounter, TELEMETRY_COMMAND_RESULTS[t.commandResult & 7]);
+  }
+  if (t.sections & TELEMETRY_SECTION_HEALTH) {
+    n += snprintf(out + n, n < (int)size ? size - n : 0, ",\"health\":[");
+    const char *separator = "";
+    for (int f = 0; f < HEALTH_FLAG_COUNT; f++) {
+      if (!(t.healthFlags & (1 << f))) continue;
+      n += snprintf(out + n, n < (int)size ? size - n : 0, "%s\"%s\"", separator, HEALTH_FLAG_NAMES[f]);
+      separator = ",";
+    }
+    n += snprintf(out + n, n < (int)size ? size - n : 0,
+                  "],\"free_heap_kb\":%.0f,\"i2c_errors\":%u,\"lora_tx_failures\":%u,\"loop_overruns\":%u,"
+                  "\"pi_rate\":%u,\"pi_age_s\":%.1f",
+                  t.freeHeapKb, t.i2cErrors, t.loraTxFailures, t.loopOverruns, t.piRate, t.piAgeSeconds);
+  }
+  n += snprintf(out + n, n < (int)size ? size - n : 0, "}");
+  return n;
+}
+
+#endif
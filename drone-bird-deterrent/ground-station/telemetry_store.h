@@ -0,0 +1,600 @@
+/*
+ * Ground-Station Telemetry History Store
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Append-only, compressed fleet history: one file per drone and UTC day,
+ *   <dir>/<drone>/<YYYYMMDD>.gts
+ * holding self-describing blocks of up to TS_BLOCK_SAMPLES samples, a
+ * column per metric (TS_METRIC_NAMES):
+ *
+ *   magic "GTB1" 4 | block bytes 4 | count 2 | metrics 1 | 0 1
+ *   first time 8 | min time 8 | max time 8        ms since the epoch
+ *   per metric:  min 4 | max 4 | column bytes 4   floats; NaN-free range
+ *   time column bytes 4
+ *   time column, then the metric columns
+ *
+ * Times are delta-of-delta coded and values XOR coded against the
+ * previous float, with the same bucket and window layout as the on-board
+ * recorder (software/flight_recorder.h). A metric whose telemetry section
+ * was absent is NaN, which costs one bit per repeated sample.
+ *
+ * Readers mmap the files and keep only the block headers in memory. Time
+ * ranges skip blocks on their min/max time, threshold queries skip blocks
+ * whose value range cannot match, and min/max over a range comes from the
+ * headers of the blocks it fully covers; only the time column and the one
+ * metric column of the remaining blocks are decoded. A block cut short by
+ * a crash ends the file's index. Blocks written before a metric was added
+ * read it as absent (NaN).
+ *
+ * Header only; build with -I../software.
+ */
+
+#ifndef TELEMETRY_STORE_H
+#define TELEMETRY_STORE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "telemetry_frame.h"
+
+#define TS_BLOCK_SAMPLES     1024
+#define TS_BLOCK_MAGIC       0x31425447UL  // "GTB1"
+#define TS_BLOCK_FIXED       36            // Up to the metric directory
+#define TS_METRIC_ENTRY      12
+#define TS_DAY_MS            86400000LL
+
+enum TsMetric {
+  TS_STATE, TS_THREAT, TS_BATTERY, TS_POWER, TS_ALTITUDE, TS_VSPEED, TS_TEMPERATURE,
+  TS_BIRD_CONFIDENCE, TS_BIRD_DISTANCE, TS_BIRD_BEARING, TS_ENDURANCE, TS_RANGE, TS_RANGE_LOW,
+  TS_METRICS
+};
+
+static const char *const TS_METRIC_NAMES[TS_METRICS] = {
+  "state", "threat", "battery", "power", "altitude", "vspeed", "temperature",
+  "bird_confidence", "bird_distance", "bird_bearing", "endurance_s", "range_m", "range_lo"
+};
+
+inline int tsMetricIndex(const char *name) {
+  for (int m = 0; m < TS_METRICS; m++) {
+    if (strcmp(name, TS_METRIC_NAMES[m]) == 0) return m;
+  }
+  return -1;
+}
+
+inline void tsSnapshotValues(const TelemetrySnapshot &t, float *values) {
+  const float none = NAN;
+  bool bird = (t.sections & TELEMETRY_SECTION_BIRD) != 0;
+  values[TS_STATE] = t.state;
+  values[TS_THREAT] = t.threat;
+  values[TS_BATTERY] = t.battery;
+  values[TS_POWER] = t.power;
+  values[TS_ALTITUDE] = t.altitude;
+  values[TS_VSPEED] = t.verticalSpeed;
+  values[TS_TEMPERATURE] = t.temperature;
+  values[TS_BIRD_CONFIDENCE] = bird ? t.birdConfidence : none;
+  values[TS_BIRD_DISTANCE] = bird ? t.birdDistance : none;
+  values[TS_BIRD_BEARING] = bird ? t.birdBearing : none;
+  bool endurance = (t.sections & TELEMETRY_SECTION_ENDURANCE) != 0;
+  values[TS_ENDURANCE] = endurance ? t.enduranceSeconds : none;
+  values[TS_RANGE] = endurance ? t.rangeMeters : none;
+  values[TS_RANGE_LOW] = endurance ? t.rangeLowMeters : none;
+}
+
+inline void tsPut32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint32_t tsGet32(const uint8_t *p) {
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline void tsPut64(uint8_t *p, int64_t v) {
+  tsPut32(p, (uint32_t)v);
+  tsPut32(p + 4, (uint32_t)((uint64_t)v >> 32));
+}
+
+inline int64_t tsGet64(const uint8_t *p) {
+  return (int64_t)(tsGet32(p) | (uint64_t)tsGet32(p + 4) << 32);
+}
+
+inline float tsFloat(uint32_t bits) {
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+inline uint32_t tsBits(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+// MSB-first bit writer, a 64-bit word at a time
+struct TsBitWriter {
+  std::vector<uint8_t> *out;
+  uint64_t word;
+  int used;
+};
+
+inline void tsBitWriterInit(TsBitWriter &w, std::vector<uint8_t> &out) {
+  w.out = &out;
+  w.word = 0;
+  w.used = 0;
+}
+
+inline void tsPutBits(TsBitWriter &w, uint64_t value, int n) {
+  if (n == 0) return;
+  if (n < 64) value &= (1ULL << n) - 1;
+  if (w.used + n <= 64) {
+    w.word |= n == 64 ? value : value << (64 - w.used - n);
+    w.used += n;
+  } else {
+    int first = 64 - w.used;
+    w.word |= value >> (n - first);
+    w.used = 64;
+    for (int i = 7; i >= 0; i--) w.out->push_back((uint8_t)(w.word >> (8 * i)));
+    n -= first;
+    w.word = value << (64 - n);
+    w.used = n;
+    return;
+  }
+  if (w.used == 64) {
+    for (int i = 7; i >= 0; i--) w.out->push_back((uint8_t)(w.word >> (8 * i)));
+    w.word = 0;
+    w.used = 0;
+  }
+}
+
+inline void tsFlushBits(TsBitWriter &w) {
+  for (int i = 0; i * 8 < w.used; i++) w.out->push_back((uint8_t)(w.word >> (56 - 8 * i)));
+  w.word = 0;
+  w.used = 0;
+}
+
+struct TsBitReader {
+  const uint8_t *data;
+  size_t length;            // Bytes
+  size_t position;          // Next byte to load
+  uint64_t word;            // Loaded bits, MSB first
+  int available;
+  bool overrun;
+};
+
+inline void tsBitReaderInit(TsBitReader &r, const uint8_t *data, size_t length) {
+  r.data = data;
+  r.length = length;
+  r.position = 0;
+  r.word = 0;
+  r.available = 0;
+  r.overrun = false;
+}
+
+inline void tsRefill(TsBitReader &r) {
+  while (r.available <= 56) {
+    uint64_t byte = 0;
+    if (r.position < r.length) {
+      byte = r.data[r.position];
+    } else if (r.position > r.length + 8) {
+      r.overrun = true;
+    }
+    r.position++;
+    r.word |= byte << (56 - r.available);
+    r.available += 8;
+  }
+}
+
+// Up to 32 bits
+inline uint32_t tsGetBits(TsBitReader &r, int n) {
+  if (n == 0) return 0;
+  if (r.available < n) tsRefill(r);
+  uint32_t value = (uint32_t)(r.word >> (64 - n));
+  r.word <<= n;
+  r.available -= n;
+  return value;
+}
+
+inline bool tsReaderOk(const TsBitReader &r) {
+  return !r.overrun && r.position - (size_t)(r.available / 8) <= r.length + 1;
+}
+
+inline void tsEncodeTimes(const int64_t *ms, int count, std::vector<uint8_t> &out) {
+  TsBitWriter w;
+  tsBitWriterInit(w, out);
+  int64_t last = ms[0], delta = 0;
+  for (int i = 1; i < count; i++) {
+    int64_t d = ms[i] - last;
+    int64_t dod = d - delta;
+    if (dod == 0) {
+      tsPutBits(w, 0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+      tsPutBits(w, 0x2, 2);
+      tsPutBits(w, (uint64_t)(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+      tsPutBits(w, 0x6, 3);
+      tsPutBits(w, (uint64_t)(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+      tsPutBits(w, 0xE, 4);
+      tsPutBits(w, (uint64_t)(dod + 2047), 12);
+    } else {
+      tsPutBits(w, 0xF, 4);
+      tsPutBits(w, (uint64_t)(uint32_t)(int32_t)dod, 32);
+    }
+    last = ms[i];
+    delta = d;
+  }
+  tsFlushBits(w);
+}
+
+inline void tsEncodeValues(const float *values, int count, std::vector<uint8_t> &out) {
+  TsBitWriter w;
+  tsBitWriterInit(w, out);
+  uint32_t previous = 0;
+  int lead = -1, trail = 0;
+  for (int i = 0; i < count; i++) {
+    uint32_t value = tsBits(values[i]);
+    uint32_t x = value ^ previous;
+    previous = value;
+    if (x == 0) {
+      tsPutBits(w, 0, 1);
+      continue;
+    }
+    int l = __builtin_clz(x), t = __builtin_ctz(x);
+    if (lead >= 0 && l >= lead && t >= trail) {
+      tsPutBits(w, 0x2, 2);
+      tsPutBits(w, x >> trail, 32 - lead - trail);
+      continue;
+    }
+    lead = l;
+    trail = t;
+    int n = 32 - l - t;
+    tsPutBits(w, 0x3, 2);
+    tsPutBits(w, (uint64_t)l, 5);
+    tsPutBits(w, (uint64_t)(n - 1), 5);
+    tsPutBits(w, x >> t, n);
+  }
+  tsFlushBits(w);
+}
+
+inline bool tsDecodeTimes(const uint8_t *column, size_t length, int64_t first, int count, int64_t *ms) {
+  TsBitReader r;
+  tsBitReaderInit(r, column, length);
+  int64_t last = first, delta = 0;
+  ms[0] = first;
+  for (int i = 1; i < count; i++) {
+    int64_t dod;
+    if (tsGetBits(r, 1) == 0) {
+      dod = 0;
+    } else if (tsGetBits(r, 1) == 0) {
+      dod = (int64_t)tsGetBits(r, 7) - 63;
+    } else if (tsGetBits(r, 1) == 0) {
+      dod = (int64_t)tsGetBits(r, 9) - 255;
+    } else if (tsGetBits(r, 1) == 0) {
+      dod = (int64_t)tsGetBits(r, 12) - 2047;
+    } else {
+      dod = (int32_t)tsGetBits(r, 32);
+    }
+    delta += dod;
+    last += delta;
+    ms[i] = last;
+  }
+  return tsReaderOk(r);
+}
+
+inline bool tsDecodeValues(const uint8_t *column, size_t length, int count, float *values) {
+  TsBitReader r;
+  tsBitReaderInit(r, column, length);
+  uint32_t previous = 0;
+  int lead = 0, n = 0;
+  for (int i = 0; i < count; i++) {
+    if (tsGetBits(r, 1) == 1) {
+      if (tsGetBits(r, 1) == 1) {
+        lead = (int)tsGetBits(r, 5);
+        n = (int)tsGetBits(r, 5) + 1;
+      }
+      int trail = 32 - lead - n;
+      if (n == 0 || trail < 0) return false;
+      previous ^= tsGetBits(r, n) << trail;
+    }
+    values[i] = tsFloat(previous);
+  }
+  return tsReaderOk(r);
+}
+
+// Writing side: one per drone, a single writer
+struct TsWriter {
+  std::string dir;          // <store>/<drone>
+  FILE *file;
+  int64_t fileDay;
+  int count;
+  int64_t times[TS_BLOCK_SAMPLES];
+  float values[TS_METRICS][TS_BLOCK_SAMPLES];
+  std::vector<uint8_t> block;
+  uint64_t blocks, samples, bytes;
+};
+
+inline bool tsWriterOpen(TsWriter &w, const std::string &store, const std::string &drone) {
+  w.dir = store + "/" + drone;
+  w.file = NULL;
+  w.fileDay = -1;
+  w.count = 0;
+  w.blocks = w.samples = w.bytes = 0;
+  if (mkdir(store.c_str(), 0755) != 0 && errno != EEXIST) return false;
+  return mkdir(w.dir.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+// Encode and append the open block; false on a write error
+inline bool tsSeal(TsWriter &w) {
+  if (w.count == 0) return true;
+  int count = w.count;
+  w.count = 0;
+
+  int64_t day = w.times[0] / TS_DAY_MS;
+  if (!w.file || day != w.fileDay) {
+    if (w.file) fclose(w.file);
+    time_t seconds = (time_t)(day * 86400);
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char name[32];
+    strftime(name, sizeof(name), "/%Y%m%d.gts", &utc);
+    w.file = fopen((w.dir + name).c_str(), "ab");
+    w.fileDay = day;
+    if (!w.file) return false;
+  }
+
+  std::vector<uint8_t> &b = w.block;
+  size_t directory = TS_BLOCK_FIXED;
+  size_t columns = directory + TS_METRICS * TS_METRIC_ENTRY + 4;
+  b.assign(columns, 0);
+  tsPut32(&b[0], TS_BLOCK_MAGIC);
+  b[8] = (uint8_t)count;
+  b[9] = (uint8_t)(count >> 8);
+  b[10] = TS_METRICS;
+  int64_t tMin = w.times[0], tMax = w.times[0];
+  for (int i = 1; i < count; i++) {
+    tMin = std::min(tMin, w.times[i]);
+    tMax = std::max(tMax, w.times[i]);
+  }
+  tsPut64(&b[12], w.times[0]);
+  tsPut64(&b[20], tMin);
+  tsPut64(&b[28], tMax);
+
+  size_t before = b.size();
+  tsEncodeTimes(w.times, count, b);
+  tsPut32(&b[columns - 4], (uint32_t)(b.size() - before));
+  for (int m = 0; m < TS_METRICS; m++) {
+    float lo = INFINITY, hi = -INFINITY;
+    for (int i = 0; i < count; i++) {
+      float v = w.values[m][i];
+      if (v < lo) lo = v;
+      if (v > hi) hi = v;
+    }
+    before = b.size();
+    tsEncodeValues(w.values[m], count, b);
+    uint8_t *entry = &b[directory + m * TS_METRIC_ENTRY];
+    tsPut32(entry, tsBits(lo));
+    tsPut32(entry + 4, tsBits(hi));
+    tsPut32(entry + 8, (uint32_t)(b.size() - before));
+  }
+  tsPut32(&b[4], (uint32_t)b.size());
+
+  w.blocks++;
+  w.bytes += b.size();
+  return fwrite(&b[0], 1, b.size(), w.file) == b.size() && fflush(w.file) == 0;
+}
+
+// Blocks are sealed when full and when the day changes
+inline bool tsAppend(TsWriter &w, int64_t ms, const float *values) {
+  bool ok = true;
+  if (w.count == TS_BLOCK_SAMPLES || (w.count > 0 && ms / TS_DAY_MS != w.times[0] / TS_DAY_MS)) ok = tsSeal(w);
+  w.times[w.count] = ms;
+  for (int m = 0; m < TS_METRICS; m++) w.values[m][w.count] = values[m];
+  w.count++;
+  w.samples++;
+  return ok;
+}
+
+inline bool tsWriterClose(TsWriter &w) {
+  bool ok = tsSeal(w);
+  if (w.file) fclose(w.file);
+  w.file = NULL;
+  return ok;
+}
+
+// Reading side
+struct TsBlock {
+  const uint8_t *data;
+  int count;
+  int metrics;              // Columns written, the first metrics of TsMetric
+  int64_t first, tMin, tMax;
+};
+
+struct TsMapping {
+  const uint8_t *data;
+  size_t size;
+};
+
+struct TsReader {
+  std::vector<TsMapping> files;
+  std::vector<TsBlock> blocks;     // Day files in name order, blocks in file order
+  uint64_t samples;
+};
+
+inline float tsBlockMin(const TsBlock &b, int metric) {
+  if (metric >= b.metrics) return INFINITY;  // As a column with no values
+  return tsFloat(tsGet32(b.data + TS_BLOCK_FIXED + metric * TS_METRIC_ENTRY));
+}
+
+inline float tsBlockMax(const TsBlock &b, int metric) {
+  if (metric >= b.metrics) return -INFINITY;
+  return tsFloat(tsGet32(b.data + TS_BLOCK_FIXED + metric * TS_METRIC_ENTRY + 4));
+}
+
+// Map every day file of one drone and index its blocks
+inline bool tsReaderOpen(TsReader &r, const std::string &store, const std::string &drone) {
+  r.samples = 0;
+  std::string dir = store + "/" + drone;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return false;
+  std::vector<std::string> names;
+  struct dirent *e;
+  while ((e = readdir(d)) != NULL) {
+    size_t n = strlen(e->d_name);
+    if (n > 4 && strcmp(e->d_name + n - 4, ".gts") == 0) names.push_back(e->d_name);
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+
+  for (size_t i = 0; i < names.size(); i++) {
+    int fd = open((dir + "/" + names[i]).c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+      if (fd >= 0) close(fd);
+      continue;
+    }
+    TsMapping map;
+    map.size = (size_t)st.st_size;
+    map.data = (const uint8_t *)mmap(NULL, map.size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map.data == MAP_FAILED) continue;
+    r.files.push_back(map);
+
+    for (size_t at = 0; at + TS_BLOCK_FIXED <= map.size;) {
+      const uint8_t *p = map.data + at;
+      uint32_t bytes = tsGet32(p + 4);
+      size_t directory = TS_BLOCK_FIXED + p[10] * TS_METRIC_ENTRY + 4;
+      if (tsGet32(p) != TS_BLOCK_MAGIC || p[10] == 0 || p[10] > TS_METRICS || bytes < directory ||
+          at + bytes > map.size) {
+        break;
+      }
+      TsBlock b;
+      b.data = p;
+      b.count = p[8] | p[9] << 8;
+      b.metrics = p[10];
+      b.first = tsGet64(p + 12);
+      b.tMin = tsGet64(p + 20);
+      b.tMax = tsGet64(p + 28);
+      if (b.count == 0 || b.count > TS_BLOCK_SAMPLES) break;
+      r.blocks.push_back(b);
+      r.samples += b.count;
+      at += bytes;
+    }
+  }
+  return true;
+}
+
+inline void tsReaderClose(TsReader &r) {
+  for (size_t i = 0; i < r.files.size(); i++) munmap((void *)r.files[i].data, r.files[i].size);
+  r.files.clear();
+  r.blocks.clear();
+}
+
+// Times and one metric of a block; false if the block is malformed
+inline bool tsDecodeBlock(const TsBlock &b, int metric, int64_t *ms, float *values) {
+  const uint8_t *directory = b.data + TS_BLOCK_FIXED;
+  size_t offset = TS_BLOCK_FIXED + b.metrics * TS_METRIC_ENTRY + 4;
+  size_t timeBytes = tsGet32(directory + b.metrics * TS_METRIC_ENTRY);
+  if (!tsDecodeTimes(b.data + offset, timeBytes, b.first, b.count, ms)) return false;
+  if (metric >= b.metrics) {
+    for (int i = 0; i < b.count; i++) values[i] = NAN;
+    return true;
+  }
+  offset += timeBytes;
+  for (int m = 0; m < metric; m++) offset += tsGet32(directory + m * TS_METRIC_ENTRY + 8);
+  return tsDecodeValues(b.data + offset, tsGet32(directory + metric * TS_METRIC_ENTRY + 8), b.count, values);
+}
+
+struct TsQueryStats {
+  uint64_t blocksDecoded, blocksSkipped;
+};
+
+// Calls visit(ms, value) for every sample of the metric in [from, to) for
+// which keep(blockMin, blockMax) holds on its block and the value is
+// wanted by accept(value). Returns the samples visited.
+template <class Keep, class Accept, class Visit>
+inline uint64_t tsQuery(const TsReader &r, int metric, int64_t from, int64_t to, Keep keep, Accept accept,
+                        Visit visit, TsQueryStats &stats) {
+  int64_t ms[TS_BLOCK_SAMPLES];
+  float values[TS_BLOCK_SAMPLES];
+  uint64_t visited = 0;
+  stats.blocksDecoded = stats.blocksSkipped = 0;
+  for (size_t i = 0; i < r.blocks.size(); i++) {
+    const TsBlock &b = r.blocks[i];
+    if (b.tMax < from || b.tMin >= to || !keep(tsBlockMin(b, metric), tsBlockMax(b, metric))) {
+      stats.blocksSkipped++;
+      continue;
+    }
+    stats.blocksDecoded++;
+    if (!tsDecodeBlock(b, metric, ms, values)) continue;
+    for (int s = 0; s < b.count; s++) {
+      if (ms[s] < from || ms[s] >= to || !accept(values[s])) continue;
+      visit(ms[s], values[s]);
+      visited++;
+    }
+  }
+  return visited;
+}
+
+struct TsAnyBlock {
+  bool operator()(float, float) const { return true; }
+};
+
+struct TsAnyValue {
+  bool operator()(float) const { return true; }
+};
+
+// Samples above a threshold; blocks whose maximum is not are never decoded
+struct TsBlockAbove {
+  float threshold;
+  bool operator()(float, float hi) const { return hi > threshold; }
+};
+
+struct TsValueAbove {
+  float threshold;
+  bool operator()(float v) const { return v > threshold; }
+};
+
+// Minimum and maximum of a metric over [from, to): blocks inside the range
+// answer from their header, only the blocks at its edges are decoded.
+// False if there is no value in the range.
+inline bool tsRangeMinMax(const TsReader &r, int metric, int64_t from, int64_t to, float &lo, float &hi,
+                          TsQueryStats &stats) {
+  int64_t ms[TS_BLOCK_SAMPLES];
+  float values[TS_BLOCK_SAMPLES];
+  lo = INFINITY;
+  hi = -INFINITY;
+  stats.blocksDecoded = stats.blocksSkipped = 0;
+  for (size_t i = 0; i < r.blocks.size(); i++) {
+    const TsBlock &b = r.blocks[i];
+    if (b.tMax < from || b.tMin >= to) continue;
+    if (b.tMin >= from && b.tMax < to) {
+      lo = std::min(lo, tsBlockMin(b, metric));
+      hi = std::max(hi, tsBlockMax(b, metric));
+      stats.blocksSkipped++;
+      continue;
+    }
+    stats.blocksDecoded++;
+    if (!tsDecodeBlock(b, metric, ms, values)) continue;
+    for (int s = 0; s < b.count; s++) {
+      if (ms[s] < from || ms[s] >= to || std::isnan(values[s])) continue;
+      lo = std::min(lo, values[s]);
+      hi = std::max(hi, values[s]);
+    }
+  }
+  return lo <= hi;
+}
+
+#endif
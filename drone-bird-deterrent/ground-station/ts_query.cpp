@@ -0,0 +1,106 @@
+/*
+ * Telemetry History Query
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Reads the compressed history written by ground_ingestd -H
+ * (telemetry_store.h) for one drone and one metric (state, threat,
+ * battery, power, altitude, vspeed, temperature, bird_confidence,
+ * bird_distance, bird_bearing, endurance_s, range_m, range_lo) over a UTC
+ * time range:
+ *   default   every sample as CSV, <ms since epoch>,<value>
+ *   -a <x>    only samples above x; blocks whose maximum is not are skipped
+ *   -r        minimum and maximum only, mostly from the block index
+ * Times are ms since the epoch or YYYY-MM-DDTHH:MM[:SS] in UTC; the range
+ * defaults to everything. Absent values (no bird in view) print as nan.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software ts_query.cpp -o ts_query
+ *   ./ts_query history/ alpha altitude 2026-05-01T00:00 2026-05-08T00:00 > alt.csv
+ *   ./ts_query -a 90 history/ alpha altitude
+ *   ./ts_query -r history/ alpha power 2026-05-03T06:00 2026-05-03T18:00
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "telemetry_store.h"
+
+struct PrintSample {
+  void operator()(int64_t ms, float value) const { printf("%lld,%g\n", (long long)ms, value); }
+};
+
+static bool parseTime(const char *text, int64_t &ms) {
+  char *end;
+  long long value = strtoll(text, &end, 10);
+  if (*end == '\0') {
+    ms = value;
+    return true;
+  }
+  struct tm utc;
+  memset(&utc, 0, sizeof(utc));
+  const char *rest = strptime(text, "%Y-%m-%dT%H:%M", &utc);
+  if (!rest) return false;
+  if (*rest == ':') rest = strptime(rest, ":%S", &utc);
+  if (!rest || *rest != '\0') return false;
+  ms = (int64_t)timegm(&utc) * 1000;
+  return true;
+}
+
+int main(int argc, char **argv) {
+  bool above = false, range = false;
+  float threshold = 0;
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; arg++) {
+    if (strcmp(argv[arg], "-r") == 0) {
+      range = true;
+    } else if (strcmp(argv[arg], "-a") == 0 && arg + 1 < argc) {
+      above = true;
+      threshold = (float)atof(argv[++arg]);
+    } else {
+      break;
+    }
+  }
+  if (argc - arg < 3 || argc - arg > 5) {
+    fprintf(stderr, "usage: ts_query [-a threshold | -r] <history dir> <drone> <metric> [from [to]]\n");
+    return 2;
+  }
+  int metric = tsMetricIndex(argv[arg + 2]);
+  int64_t from = INT64_MIN, to = INT64_MAX;
+  if (metric < 0) {
+    fprintf(stderr, "unknown metric %s\n", argv[arg + 2]);
+    return 2;
+  }
+  if ((argc - arg > 3 && !parseTime(argv[arg + 3], from)) || (argc - arg > 4 && !parseTime(argv[arg + 4], to))) {
+    fprintf(stderr, "bad time (ms since the epoch or YYYY-MM-DDTHH:MM[:SS])\n");
+    return 2;
+  }
+
+  TsReader reader;
+  if (!tsReaderOpen(reader, argv[arg], argv[arg + 1])) {
+    perror(argv[arg + 1]);
+    return 1;
+  }
+
+  TsQueryStats stats;
+  uint64_t count = 0;
+  if (range) {
+    float lo, hi;
+    if (tsRangeMinMax(reader, metric, from, to, lo, hi, stats)) {
+      printf("min %g\nmax %g\n", lo, hi);
+    } else {
+      printf("no values\n");
+    }
+  } else if (above) {
+    TsBlockAbove keep = {threshold};
+    TsValueAbove accept = {threshold};
+    count = tsQuery(reader, metric, from, to, keep, accept, PrintSample(), stats);
+  } else {
+    count = tsQuery(reader, metric, from, to, TsAnyBlock(), TsAnyValue(), PrintSample(), stats);
+  }
+  fprintf(stderr, "%llu sample(s) out of %llu in %zu file(s); %llu block(s) decoded, %llu settled by the index\n",
+          (unsigned long long)count, (unsigned long long)reader.samples, reader.files.size(),
+          (unsigned long long)stats.blocksDecoded, (unsigned long long)stats.blocksSkipped);
+  tsReaderClose(reader);
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Uplink Command Tool
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Signs one uplink command (software/lora_uplink.h) and prints it as hex
+ * for the ground LoRa bridge, which appends it to its next link ack. The
+ * bridge repeats it until a telemetry frame acknowledges the counter (the
+ * "cmd_counter" / "cmd_result" fields from telemetry_decode). On a "stale"
+ * result, re-sign with a counter above the one reported.
+ *
+ * Commands:
+ *   ping
+ *   mute <seconds>             0 lifts the mute
+ *   set <parameter> <value>    threat_low | threat_medium | threat_high | alert_strobe
+ *   dump                       serial profile and energy reports now
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software uplink_command.cpp -o uplink_command
+ *   ./uplink_command <32 hex digit key> <counter> mute 120
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "lora_uplink.h"
+
+static const char *PARAM_NAMES[UPLINK_PARAMS] = {"threat_low", "threat_medium", "threat_high", "alert_strobe"};
+
+static bool parseKey(const char *hex, uint8_t *key) {
+  if (strlen(hex) != 2 * UPLINK_KEY_LENGTH) return false;
+  for (int i = 0; i < UPLINK_KEY_LENGTH; i++) {
+    unsigned value;
+    if (sscanf(hex + 2 * i, "%2x", &value) != 1) return false;
+    key[i] = (uint8_t)value;
+  }
+  return true;
+}
+
+static int usage() {
+  fprintf(stderr, "usage: uplink_command <key hex> <counter> ping | mute <s> | set <parameter> <value> | dump\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  uint8_t key[UPLINK_KEY_LENGTH];
+  if (argc < 4 || !parseKey(argv[1], key)) return usage();
+
+  UplinkCommand cmd;
+  long counter = strtol(argv[2], 0, 0);
+  if (counter < 1 || counter > 0xFFFF) {
+    fprintf(stderr, "counter must be 1..65535\n");
+    return 2;
+  }
+  cmd.counter = (uint16_t)counter;
+  cmd.parameter = 0;
+  cmd.value = 0;
+
+  const char *op = argv[3];
+  if (strcmp(op, "ping") == 0) {
+    cmd.opcode = UPLINK_PING;
+  } else if (strcmp(op, "dump") == 0) {
+    cmd.opcode = UPLINK_LOG_DUMP;
+  } else if (strcmp(op, "mute") == 0 && argc == 5) {
+    cmd.opcode = UPLINK_MUTE_AUDIO;
+    cmd.value = (int16_t)atoi(argv[4]);
+  } else if (strcmp(op, "set") == 0 && argc == 6) {
+    cmd.opcode = UPLINK_SET_PARAM;
+    cmd.parameter = UPLINK_PARAMS;
+    for (int i = 0; i < UPLINK_PARAMS; i++) {
+      if (strcmp(argv[4], PARAM_NAMES[i]) == 0) cmd.parameter = (uint8_t)i;
+    }
+    cmd.value = (int16_t)atoi(argv[5]);
+  } else {
+    return usage();
+  }
+
+  // The drone would refuse it anyway; say why here
+  if (uplinkValidate(cmd) != UPLINK_OK) {
+    fprintf(stderr, "argument out of range\n");
+    return 1;
+  }
+
+  uint8_t frame[UPLINK_COMMAND_LENGTH];
+  size_t length = uplinkEncode(cmd, key, frame);
+  for (size_t i = 0; i < length; i++) printf("%02X", frame[i]);
+  printf("\n");
+  return 0;
+}
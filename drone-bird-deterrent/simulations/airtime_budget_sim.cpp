@@ -0,0 +1,251 @@
+/*
+ * LoRa Airtime Budget Simulation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Runs the controller's status path in 1 ms steps against the 915MHz
+ * budget (400ms dwell, 400ms in any 20s, a quarter kept for events):
+ * 1Hz status snapshots priced and shed as serviceTelemetryQueue() does,
+ * the link adapter picking the SF from ground acks, the delta encoder
+ * falling back to keyframes until one is acked, and nothing sent while
+ * the radio listens for an ack.
+ *
+ * Cases:
+ *   boot      SF12 and no acked keyframe - the first status must go out
+ *             at once, at an SF whose airtime fits the status share
+ *   fallback  the ground goes silent for 30s, so the adapter falls back
+ *             to SF12; status must be on air within a budget window of
+ *             the ground returning (the share may be spent) and acked
+ * Each reports time to the first status on air and to the first ack,
+ * statuses sent / acked, the longest gap between statuses on air, peak
+ * window use and the SFs used. Budget and dwell must never be exceeded.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software airtime_budget_sim.cpp -o airtime_budget_sim
+ *   ./airtime_budget_sim
+ */
+
+#include <cmath>
+#include <cstdio>
+
+#include "airtime_budget.h"
+#include "lora_link_adapter.h"
+#include "telemetry_delta.h"
+
+// As in esp32_main_controller.cpp
+#define LORA_MAX_DWELL_MS         400
+#define LORA_DUTY_WINDOW_MS       20000
+#define LORA_DUTY_LIMIT_MS        400
+#define LORA_EVENT_RESERVE        0.25f
+#define LORA_BUDGET_RETRY_MS      100
+#define LORA_STATUS_INTERVAL_MS   1000
+#define LORA_RX_TURNAROUND_MS     60
+#define LORA_RX_MARGIN_MS         40
+#define STATUS_MAX_AGE_MS         3000
+
+#define RUN_MS                    180000
+#define LINK_MARGIN_DB            22.0f   // Above the SF12 floor at full power
+
+struct Case {
+  const char *name;
+  uint32_t silentFromMs, silentToMs;      // Ground hears nothing
+  uint32_t firstStatusLimitMs;            // From boot / from the link returning
+  uint32_t firstAckLimitMs;
+};
+
+static const Case CASES[] = {
+  {"boot", 0, 0, 1100, 5000},
+  {"fallback", 60000, 90000, LORA_DUTY_WINDOW_MS, LORA_DUTY_WINDOW_MS + 5000},
+};
+
+struct Result {
+  uint32_t firstStatusMs, firstAckMs;     // After the case's reference time, UINT32_MAX if never
+  uint32_t sent, acked, delayed, stale;
+  uint32_t longestGapMs;
+  uint32_t peakMicros, maxAirtimeMicros;
+  uint32_t sfCount[LINK_MAX_SF + 1];
+};
+
+static TelemetrySnapshot statusAt(uint32_t ms) {
+  TelemetrySnapshot t = TelemetrySnapshot();
+  float s = ms / 1000.0f;
+  t.type = TELEMETRY_STATUS;
+  t.sections = TELEMETRY_SECTION_ENDURANCE | TELEMETRY_SECTION_POWER | TELEMETRY_SECTION_WINDOW;
+  t.timeSeconds = ms / 1000;
+  t.state = 1;
+  t.battery = 95.0f - s * 0.01f;
+  t.power = 9.0f + 0.4f * sinf(s * 1.3f);
+  t.altitude = 60.0f + 3.0f * sinf(s * 0.05f);
+  t.verticalSpeed = 0.15f * cosf(s * 0.05f);
+  t.temperature = 20.0f;
+  t.enduranceSeconds = 3000.0f - s;
+  t.enduranceLowSeconds = t.enduranceSeconds - 300.0f;
+  t.enduranceHighSeconds = t.enduranceSeconds + 300.0f;
+  t.powerMin = t.power - 0.4f;
+  t.powerMax = t.power + 0.4f;
+  t.verticalSpeedMin = t.verticalSpeed - 0.1f;
+  t.verticalSpeedMax = t.verticalSpeed + 0.1f;
+  t.packVoltageMin = 22.8f;
+  return t;
+}
+
+// telemetryAirtime(): priced at the SF transmitLoRaPacket() will use
+static uint32_t statusAirtime(const AirtimeBudget &budget, const LinkAdapter &link,
+                              const TelemetryDeltaEncoder &enc, const TelemetrySnapshot &t, float reserve) {
+  TelemetryDeltaEncoder trial = enc;
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  size_t length = telemetryDeltaEncode(trial, t, frame, sizeof(frame));
+  LoRaModulation mod = {link.spreadingFactor, 125000, 8};
+  mod.spreadingFactor = airtimeShareSpreadingFactor(budget, mod, (uint16_t)length, reserve);
+  return loraTimeOnAirMicros(mod, (uint16_t)length);
+}
+
+static Result run(const Case &c) {
+  AirtimeBudget budget;
+  airtimeBudgetInit(budget, LORA_DUTY_WINDOW_MS, LORA_DUTY_LIMIT_MS * 1000UL, LORA_MAX_DWELL_MS * 1000UL, 0);
+  LinkAdapter link;
+  linkAdapterInit(link);
+  TelemetryDeltaEncoder enc;
+  telemetryDeltaInit(enc);
+
+  Result r = Result();
+  r.firstStatusMs = r.firstAckMs = UINT32_MAX;
+  uint32_t referenceMs = c.silentToMs;
+
+  bool statusWaiting = false;
+  uint32_t statusQueuedMs = 0, retryAt = 0, lastSentMs = 0;
+  bool txBusy = false, listening = false, ackDue = false;
+  uint32_t txEndMs = 0, windowEndMs = 0, ackAtMs = 0;
+  uint8_t sequence = 0, ackSequence = 0;
+  int ackPower = LINK_MAX_POWER_DBM;
+  uint8_t txSf = LINK_MAX_SF;
+
+  for (uint32_t ms = 0; ms < RUN_MS; ms++) {
+    airtimeBudgetAdvance(budget, ms);
+    if (ms % LORA_STATUS_INTERVAL_MS == 0) {
+      statusWaiting = true;  // Replaces one still waiting
+      statusQueuedMs = ms;
+    }
+    if (statusWaiting && ms - statusQueuedMs > STATUS_MAX_AGE_MS) {
+      statusWaiting = false;
+      r.stale++;
+    }
+
+    // TX done: listen for the ack and a command
+    if (txBusy && ms >= txEndMs) {
+      txBusy = false;
+      listening = true;
+      LoRaModulation downlink = {txSf, 125000, 8};  // Ground acks at the SF it heard
+      uint32_t ackMs = loraTimeOnAirMicros(downlink, LINK_ACK_LENGTH) / 1000;
+      windowEndMs = ms + LORA_RX_TURNAROUND_MS + LORA_RX_MARGIN_MS + ackMs;
+      ackAtMs = ms + LORA_RX_TURNAROUND_MS + ackMs;
+    }
+    if (listening && ackDue && ms >= ackAtMs) {
+      ackDue = false;
+      listening = false;
+      LinkAck ack;
+      ack.sequence = ackSequence;
+      ack.snr = LINK_MARGIN_DB + LINK_SNR_FLOOR_DB[LINK_MAX_SF] - (LINK_MAX_POWER_DBM - ackPower);
+      ack.rssi = -100;
+      if (linkAdapterOnAck(link, ack, ackPower)) r.acked++;
+      telemetryDeltaOnAck(enc, ack.sequence);
+      if (ms >= referenceMs && r.firstAckMs == UINT32_MAX) r.firstAckMs = ms - referenceMs;
+    }
+    if (listening && ms >= windowEndMs) {
+      listening = false;
+      ackDue = false;
+    }
+
+    // serviceTelemetryQueue()
+    if (txBusy || listening || !statusWaiting || ms < retryAt) continue;
+    TelemetrySnapshot t = statusAt(statusQueuedMs);
+    t.sequence = sequence;
+    t.airtimeUsage = airtimeBudgetUsage(budget) * 100.0f;
+    if (!airtimeBudgetAllows(budget, statusAirtime(budget, link, enc, t, LORA_EVENT_RESERVE), LORA_EVENT_RESERVE)) {
+      const uint8_t sheddable[] = {TELEMETRY_SECTION_ENDURANCE | TELEMETRY_SECTION_POWER, TELEMETRY_SECTION_WINDOW};
+      bool fits = false;
+      for (int i = 0; i < 2 && !fits; i++) {
+        t.sections &= ~sheddable[i];
+        fits = airtimeBudgetAllows(budget, statusAirtime(budget, link, enc, t, LORA_EVENT_RESERVE),
+                                   LORA_EVENT_RESERVE);
+      }
+      if (!fits) {
+        r.delayed++;
+        retryAt = ms + LORA_BUDGET_RETRY_MS;
+        continue;
+      }
+    }
+
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    size_t length = telemetryDeltaEncode(enc, t, frame, sizeof(frame));
+    statusWaiting = false;
+    sequence++;
+
+    // transmitLoRaPacket()
+    linkAdapterOnSend(link, t.sequence);
+    LoRaModulation mod = {link.spreadingFactor, 125000, 8};
+    mod.spreadingFactor = airtimeShareSpreadingFactor(budget, mod, (uint16_t)length, LORA_EVENT_RESERVE);
+    uint32_t airtime = loraTimeOnAirMicros(mod, (uint16_t)length);
+    airtimeBudgetRecord(budget, ms, airtime);
+    if (airtime > r.maxAirtimeMicros) r.maxAirtimeMicros = airtime;
+    r.sfCount[mod.spreadingFactor]++;
+    r.sent++;
+    if (ms >= referenceMs) {
+      if (r.firstStatusMs == UINT32_MAX) r.firstStatusMs = ms - referenceMs;
+      if (r.sent > 1 && ms - lastSentMs > r.longestGapMs) r.longestGapMs = ms - lastSentMs;
+    }
+    lastSentMs = ms;
+
+    txBusy = true;
+    txEndMs = ms + (airtime + 999) / 1000;
+    ackDue = !(ms >= c.silentFromMs && ms < c.silentToMs);
+    ackSequence = t.sequence;
+    ackPower = link.txPowerDbm;
+    txSf = mod.spreadingFactor;
+  }
+  r.peakMicros = budget.peakMicros;
+  return r;
+}
+
+int main() {
+  // The boot keyframe as priced before the share clamp: dwell only
+  AirtimeBudget budget;
+  airtimeBudgetInit(budget, LORA_DUTY_WINDOW_MS, LORA_DUTY_LIMIT_MS * 1000UL, LORA_MAX_DWELL_MS * 1000UL, 0);
+  TelemetryDeltaEncoder enc;
+  telemetryDeltaInit(enc);
+  TelemetrySnapshot t = statusAt(0);
+  t.sections = 0;
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  uint16_t keyframe = (uint16_t)telemetryDeltaEncode(enc, t, frame, sizeof(frame));
+  LoRaModulation mod = {LINK_MAX_SF, 125000, 8};
+  mod.spreadingFactor = airtimeShareSpreadingFactor(budget, mod, keyframe, 0.0f);
+  uint32_t dwellOnly = loraTimeOnAirMicros(mod, keyframe);
+  uint8_t dwellSf = mod.spreadingFactor;
+  mod.spreadingFactor = airtimeShareSpreadingFactor(budget, mod, keyframe, LORA_EVENT_RESERVE);
+  uint32_t shareFit = loraTimeOnAirMicros(mod, keyframe);
+  printf("Boot keyframe, %u B, everything shed: dwell clamp SF%u %.0f ms (%s), share clamp SF%u %.0f ms (%s)\n\n",
+         keyframe, dwellSf, dwellOnly / 1000.0, airtimeBudgetAllows(budget, dwellOnly, LORA_EVENT_RESERVE) ?
+         "fits" : "never fits", mod.spreadingFactor, shareFit / 1000.0,
+         airtimeBudgetAllows(budget, shareFit, LORA_EVENT_RESERVE) ? "fits" : "never fits");
+
+  printf("%-9s %10s %10s %6s %6s %8s %6s %9s %8s %9s  %s\n", "case", "status ms", "ack ms", "sent", "acked",
+         "delayed", "stale", "max gap s", "peak %", "max air", "SFs used");
+  bool pass = true;
+  for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    const Case &c = CASES[i];
+    Result r = run(c);
+    char sfs[64] = "";
+    int n = 0;
+    for (int sf = LINK_MIN_SF; sf <= LINK_MAX_SF; sf++) {
+      if (r.sfCount[sf]) n += snprintf(sfs + n, sizeof(sfs) - n, "SF%d:%u ", sf, r.sfCount[sf]);
+    }
+    bool ok = r.firstStatusMs <= c.firstStatusLimitMs && r.firstAckMs <= c.firstAckLimitMs &&
+              r.peakMicros <= LORA_DUTY_LIMIT_MS * 1000UL && r.maxAirtimeMicros <= LORA_MAX_DWELL_MS * 1000UL;
+    pass = pass && ok;
+    printf("%-9s %10d %10d %6u %6u %8u %6u %9.1f %8.0f %6.0f ms  %s%s\n", c.name, (int)r.firstStatusMs,
+           (int)r.firstAckMs, r.sent, r.acked, r.delayed, r.stale, r.longestGapMs / 1000.0,
+           100.0 * r.peakMicros / (LORA_DUTY_LIMIT_MS * 1000.0), r.maxAirtimeMicros / 1000.0, sfs,
+           ok ? "" : " <- FAIL");
+  }
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
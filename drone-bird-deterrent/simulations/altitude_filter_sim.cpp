@@ -0,0 +1,137 @@
+/*
+ * Altitude Filter Host Simulation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Runs software/altitude_estimator.h against synthetic climb / descent
+ * profiles with noisy, biased accelerometer and barometer models, and
+ * compares it with the previous BMP280 FILTER_X16 configuration.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software altitude_filter_sim.cpp -o altitude_filter_sim
+ *   ./altitude_filter_sim
+ *
+ * Exits non-zero if the fused estimate misses the accuracy targets.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "altitude_estimator.h"
+
+static const float IMU_DT = 0.010f;   // 100Hz
+static const int BARO_DIVIDER = 4;    // 25Hz
+static const float BARO_NOISE_M = 0.35f;
+static const float ACCEL_NOISE_MSS = 0.25f;
+static const float ACCEL_BIAS_MSS = 0.15f;
+
+// Targets for the fused estimate
+static const float MAX_ALTITUDE_RMS_M = 0.5f;
+static const float MAX_VSPEED_RMS_MS = 0.4f;
+
+struct Profile {
+  const char *name;
+  float duration;
+  float (*velocity)(float t);
+};
+
+static float hoverProfile(float) { return 0.0f; }
+static float climbProfile(float t) { return (t > 5.0f && t < 25.0f) ? 3.0f : 0.0f; }
+static float descentProfile(float t) { return (t > 5.0f && t < 25.0f) ? -2.0f : 0.0f; }
+static float pumpProfile(float t) { return 2.5f * sinf(2.0f * 3.14159265f * t / 8.0f); }
+static float stepProfile(float t) {
+  if (t < 5.0f) return 0.0f;
+  if (t < 10.0f) return 4.0f;
+  if (t < 15.0f) return 0.0f;
+  if (t < 20.0f) return -4.0f;
+  return 0.0f;
+}
+
+struct Result {
+  float fusedAltRms, fusedVsRms;
+  float legacyAltRms, rawAltRms, rawVsRms;
+};
+
+static Result runProfile(const Profile &profile, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> baroNoise(0.0f, BARO_NOISE_M);
+  std::normal_distribution<float> accelNoise(0.0f, ACCEL_NOISE_MSS);
+
+  AltitudeEstimator est;
+  altitudeEstimatorInit(est);
+
+  const float startAltitude = 850.0f;  // Hilly terrain launch site
+  float trueAlt = startAltitude;
+  float trueVs = 0.0f;
+  float legacyAlt = startAltitude;     // IIR x16 at ~2Hz output rate
+  float prevBaro = startAltitude;
+  float rawVs = 0.0f;
+
+  double fusedAltSq = 0, fusedVsSq = 0, legacyAltSq = 0, rawAltSq = 0, rawVsSq = 0;
+  int samples = 0;
+  int steps = (int)(profile.duration / IMU_DT);
+  const float warmup = 2.0f;
+
+  for (int i = 0; i < steps; i++) {
+    float t = i * IMU_DT;
+    float newVs = profile.velocity(t);
+    float trueAccel = (newVs - trueVs) / IMU_DT;
+    trueAlt += 0.5f * (trueVs + newVs) * IMU_DT;
+    trueVs = newVs;
+
+    float baro = trueAlt + baroNoise(rng);
+    if (i % BARO_DIVIDER == 0) {
+      altitudeEstimatorCorrect(est, baro);
+      rawVs = (baro - prevBaro) / (IMU_DT * BARO_DIVIDER);
+      prevBaro = baro;
+    }
+    if (i % 53 == 0) {  // STANDBY_MS_500 + conversion time
+      legacyAlt += (baro - legacyAlt) / 16.0f;
+    }
+
+    altitudeEstimatorPredict(est, trueAccel + ACCEL_BIAS_MSS + accelNoise(rng), IMU_DT);
+
+    if (t < warmup) continue;
+    float e;
+    e = est.altitude - trueAlt; fusedAltSq += e * e;
+    e = est.verticalSpeed - trueVs; fusedVsSq += e * e;
+    e = legacyAlt - trueAlt; legacyAltSq += e * e;
+    e = prevBaro - trueAlt; rawAltSq += e * e;
+    e = rawVs - trueVs; rawVsSq += e * e;
+    samples++;
+  }
+
+  Result r;
+  r.fusedAltRms = sqrt(fusedAltSq / samples);
+  r.fusedVsRms = sqrt(fusedVsSq / samples);
+  r.legacyAltRms = sqrt(legacyAltSq / samples);
+  r.rawAltRms = sqrt(rawAltSq / samples);
+  r.rawVsRms = sqrt(rawVsSq / samples);
+  return r;
+}
+
+int main() {
+  const Profile profiles[] = {
+    {"hover", 30.0f, hoverProfile},
+    {"climb 3 m/s", 30.0f, climbProfile},
+    {"descent 2 m/s", 30.0f, descentProfile},
+    {"sine +/-2.5 m/s", 40.0f, pumpProfile},
+    {"step +/-4 m/s", 30.0f, stepProfile},
+  };
+
+  printf("Altitude filter simulation (tau=%.1fs, IMU 100Hz, baro 25Hz)\n\n", ALTITUDE_FILTER_TAU);
+  printf("%-18s | %10s %10s %10s | %10s %10s\n", "profile",
+         "fused alt", "raw baro", "FILTER_X16", "fused vs", "baro diff");
+  printf("%-18s | %10s %10s %10s | %10s %10s\n", "", "RMS m", "RMS m", "RMS m", "RMS m/s", "RMS m/s");
+
+  bool pass = true;
+  for (unsigned i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+    Result r = runProfile(profiles[i], 1234 + i);
+    printf("%-18s | %10.3f %10.3f %10.3f | %10.3f %10.3f\n", profiles[i].name,
+           r.fusedAltRms, r.rawAltRms, r.legacyAltRms, r.fusedVsRms, r.rawVsRms);
+    if (r.fusedAltRms > MAX_ALTITUDE_RMS_M || r.fusedVsRms > MAX_VSPEED_RMS_MS) pass = false;
+  }
+
+  printf("\n%s\n", pass ? "PASS" : "FAIL: fused estimate outside accuracy targets");
+  return pass ? 0 : 1;
+}
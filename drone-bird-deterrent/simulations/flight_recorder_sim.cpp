@@ -0,0 +1,411 @@
+/*
+ * Flight Recorder Power-Loss Simulation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Runs software/flight_recorder.h against an emulated NOR flash partition
+ * (program only clears bits, erase sets a 4 KB sector to 0xFF, SX-style
+ * timings) through many boots, each ended by a power cut at a random
+ * point - mid page write, mid sector erase or mid header. The logging
+ * load is the ACTIVE sample rate profile of esp32_main_controller.cpp,
+ * with signals shaped like the real ones (slow drift plus a few codes of
+ * sensor noise) so the column codecs see realistic input.
+ *
+ * A clean run first checks that every sample decodes back to exactly
+ * its quantised value, channel by channel, and reports how large each
+ * record type is on flash against the old row layout.
+ *
+ * After the last boot the partition is read back the way
+ * ground-station/blackbox_dump does and checked:
+ *   - every page whose write completed and whose sector was not since
+ *     reused is recovered byte for byte, in write order
+ *   - nothing else is recovered (torn pages are rejected)
+ *   - no records were dropped for lack of RAM pages, and the append path
+ *     never touched flash
+ *   - sectors were erased evenly: one lap apart at most, plus one for
+ *     each erase cut short (it is redone on the next boot), and the erase
+ *     counts kept in the sector headers stay within one of the real ones
+ *     (two where an erase of that sector was cut short and its header lost)
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software flight_recorder_sim.cpp -o flight_recorder_sim
+ *   ./flight_recorder_sim [image.bin]    optionally keep the partition image
+ *   ../ground-station/blackbox_dump image.bin > flight.csv
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "flight_recorder.h"
+
+#define SIM_SECTORS          96          // 384 KB: wraps several times
+#define SIM_BOOTS            40
+#define PAGE_WRITE_MS        1           // 256-byte program incl. overhead
+#define SECTOR_ERASE_MS      45
+#define DRAIN_PERIOD_MS      10          // RECORDER_DRAIN_MS
+#define CLEAN_RUN_MS         60000
+
+struct NorFlash {
+  std::vector<uint8_t> bytes;
+  std::mt19937 rng;
+  long budget;              // Bytes that can still be programmed / erased before the cut
+  bool dead;
+  int opsInAppend;          // Flash calls made while the loop was appending
+  bool inAppend;
+  int busyMs;               // Drain task time the last call took
+  uint32_t erases[SIM_SECTORS];
+  bool cutAt[SIM_SECTORS];
+  uint32_t erasesCut;
+
+  // Successful page writes still expected to be readable: offset -> content
+  std::map<uint32_t, std::vector<uint8_t> > expected;
+  std::vector<uint32_t> writeOrder;  // Offsets in write order, for ordering checks
+
+  NorFlash() : bytes(SIM_SECTORS * FR_SECTOR_SIZE, 0xFF), rng(3), budget(0), dead(false),
+               opsInAppend(0), inAppend(false), busyMs(0) {
+    memset(erases, 0, sizeof(erases));
+    memset(cutAt, 0, sizeof(cutAt));
+    erasesCut = 0;
+  }
+};
+
+static bool flashRead(void *context, uint32_t offset, void *data, size_t length) {
+  NorFlash &f = *(NorFlash *)context;
+  if (f.dead) return false;
+  if (f.inAppend) f.opsInAppend++;
+  memcpy(data, &f.bytes[offset], length);
+  return true;
+}
+
+static bool flashWrite(void *context, uint32_t offset, const void *data, size_t length) {
+  NorFlash &f = *(NorFlash *)context;
+  if (f.dead) return false;
+  if (f.inAppend) f.opsInAppend++;
+  const uint8_t *src = (const uint8_t *)data;
+  size_t programmed = length;
+  if ((long)length > f.budget) {
+    programmed = f.budget > 0 ? (size_t)f.budget : 0;
+    f.dead = true;
+  }
+  f.budget -= (long)programmed;
+  for (size_t i = 0; i < programmed; i++) f.bytes[offset + i] &= src[i];
+  f.busyMs += PAGE_WRITE_MS;
+  if (f.dead) return false;
+  if (offset % FR_SECTOR_SIZE != 0) {
+    f.expected[offset] = std::vector<uint8_t>(src, src + length);
+    f.writeOrder.push_back(offset);
+  }
+  return true;
+}
+
+static bool flashErase(void *context, uint32_t offset, size_t length) {
+  NorFlash &f = *(NorFlash *)context;
+  if (f.dead) return false;
+  if (f.inAppend) f.opsInAppend++;
+  for (uint32_t p = offset; p < offset + length; p += FR_PAGE_SIZE) f.expected.erase(p);
+  f.busyMs += SECTOR_ERASE_MS;
+  f.erases[offset / FR_SECTOR_SIZE]++;
+  if ((long)length > f.budget) {
+    // Interrupted erase: the sector is left in no defined state
+    for (size_t i = 0; i < length; i++) f.bytes[offset + i] = (uint8_t)f.rng();
+    f.dead = true;
+    f.erasesCut++;
+    f.cutAt[offset / FR_SECTOR_SIZE] = true;
+    return false;
+  }
+  f.budget -= (long)length;
+  memset(&f.bytes[offset], 0xFF, length);
+  return true;
+}
+
+// Signals shaped like the controller's: drift plus sensor noise
+static void makeSample(int type, int ms, std::mt19937 &rng, float *v) {
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  float t = ms / 1000.0f;
+  int phase = ms / 10000;
+  switch (type) {
+    case FR_IMU:
+      v[0] = 0.3f * sinf(t / 3.0f) + 0.05f * noise(rng);
+      v[1] = 0.2f * cosf(t / 4.0f) + 0.05f * noise(rng);
+      v[2] = 9.81f + 0.08f * noise(rng);
+      for (int i = 3; i < 6; i++) v[i] = 0.05f * sinf(t / (i + 1)) + 0.003f * noise(rng);
+      break;
+    case FR_ALTITUDE:
+      v[1] = 120.0f + 10.0f * sinf(t / 20.0f);
+      v[0] = v[1] + 0.3f * noise(rng);
+      v[2] = 0.5f * cosf(t / 20.0f);
+      v[3] = 0.05f * sinf(t / 2.0f) + 0.002f * noise(rng);
+      v[4] = 0.04f * cosf(t / 3.0f) + 0.002f * noise(rng);
+      v[5] = 21.5f + 0.02f * noise(rng);
+      break;
+    case FR_POWER:
+      v[0] = 16.2f - t * 0.001f + 0.004f * noise(rng);
+      v[1] = 2.1f + 0.02f * noise(rng);
+      v[2] = 5.02f + 0.003f * noise(rng);
+      v[3] = 0.8f + 0.01f * noise(rng);
+      v[4] = 3.3f + 0.002f * noise(rng);
+      v[5] = 0.12f + 0.003f * noise(rng);
+      v[6] = 85.0f - t * 0.01f;
+      break;
+    case FR_DETECTION:
+      v[0] = (float)(rng() % 4 == 0);
+      v[1] = (float)(rng() % 101);
+      v[2] = 5.0f + (rng() % 750) / 10.0f;
+      v[3] = (rng() % 3600) / 10.0f;
+      v[4] = (float)(rng() % 6);
+      v[5] = (float)(rng() % 4);
+      break;
+    case FR_STATE:
+      for (int i = 0; i < 3; i++) v[i] = (float)(rng() % 4);
+      break;
+    default:
+      for (int i = 0; i < 4; i++) v[i] = phase % 3 == 0 ? 255.0f : 0.0f;
+      v[4] = (float)(phase % 2);
+      v[5] = 0.0f;
+      break;
+  }
+}
+
+// Appends whatever the ACTIVE profile has due this ms: 200Hz IMU, 25Hz
+// baro, 50Hz power, 20Hz control, 5Hz detections, rare state changes
+static int dueTypes(int ms, int *types) {
+  int n = 0;
+  if (ms % 5 == 0) types[n++] = FR_IMU;
+  if (ms % 40 == 0) types[n++] = FR_ALTITUDE;
+  if (ms % 20 == 0) types[n++] = FR_POWER;
+  if (ms % 50 == 0) types[n++] = FR_ACTUATORS;
+  if (ms % 200 == 0) types[n++] = FR_DETECTION;
+  if (ms % 5000 == 0) types[n++] = FR_STATE;
+  return n;
+}
+
+// What frAppend stores for a value
+static float quantised(int type, int field, float value) {
+  float scale = FR_LAYOUTS[type].scale[field];
+  float code = value / scale;
+  code += code < 0.0f ? -0.5f : 0.5f;
+  if (code > 32767.0f) code = 32767.0f;
+  if (code < -32768.0f) code = -32768.0f;
+  return (float)(int16_t)code * scale;
+}
+
+struct Sample {
+  uint32_t ms;
+  float values[FR_MAX_FIELDS];
+};
+
+// Pages of an image in log order: sectors by sequence, then page index
+static std::vector<const uint8_t *> logPages(const NorFlash &flash) {
+  std::vector<std::pair<uint32_t, uint32_t> > order;  // (sequence, sector)
+  for (uint32_t s = 0; s < SIM_SECTORS; s++) {
+    RecorderSectorHeader h;
+    if (frParseSectorHeader(&flash.bytes[s * FR_SECTOR_SIZE], h)) order.push_back(std::make_pair(h.sequence, s));
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<const uint8_t *> pages;
+  for (size_t i = 0; i < order.size(); i++) {
+    for (int p = 1; p < FR_PAGES_PER_SECTOR; p++) {
+      pages.push_back(&flash.bytes[order[i].second * FR_SECTOR_SIZE + p * FR_PAGE_SIZE]);
+    }
+  }
+  return pages;
+}
+
+int main(int argc, char **argv) {
+  static NorFlash flash;
+  RecorderFlash ops;
+  ops.context = &flash;
+  ops.size = SIM_SECTORS * FR_SECTOR_SIZE;
+  ops.read = flashRead;
+  ops.write = flashWrite;
+  ops.erase = flashErase;
+  static FlightRecorder rec;
+  std::mt19937 rng(17);
+  int types[FR_RECORD_TYPES];
+
+  // Clean run: every sample must come back exactly, one channel at a time
+  std::vector<Sample> appended[FR_RECORD_TYPES];
+  flash.budget = 1L << 30;
+  frInit(rec, ops);
+  for (int ms = 0; ms < CLEAN_RUN_MS; ms++) {
+    int n = dueTypes(ms, types);
+    for (int i = 0; i < n; i++) {
+      Sample sample;
+      sample.ms = ms;
+      makeSample(types[i], ms, rng, sample.values);
+      frAppend(rec, (uint8_t)types[i], ms, sample.values);
+      for (int f = 0; f < FR_LAYOUTS[types[i]].fields; f++) {
+        sample.values[f] = quantised(types[i], f, sample.values[f]);
+      }
+      appended[types[i]].push_back(sample);
+    }
+    frSealIfOlder(rec, ms, FR_FLUSH_MS);
+    if (ms % DRAIN_PERIOD_MS == 0) frDrain(rec, FR_RAM_PAGES);
+  }
+  frSeal(rec);
+  frDrain(rec, FR_RAM_PAGES);
+
+  std::vector<const uint8_t *> pages = logPages(flash);
+  size_t decoded[FR_RECORD_TYPES] = {0}, blockBytes[FR_RECORD_TYPES] = {0}, flashBytes = 0;
+  uint32_t mismatches = 0;
+  for (int t = 0; t < FR_RECORD_TYPES; t++) {
+    for (int f = 0; f < FR_LAYOUTS[t].fields; f++) {
+      size_t next = 0;
+      for (size_t i = 0; i < pages.size(); i++) {
+        uint32_t baseMs;
+        int payload = frPagePayload(pages[i], baseMs);
+        if (payload < 0) continue;
+        if (t == 0 && f == 0) flashBytes += FR_PAGE_SIZE;
+        size_t offset = 0, start = 0;
+        RecorderBlockView block;
+        for (; frNextBlock(pages[i], payload, offset, block); start = offset) {
+          if (block.type != t) continue;
+          uint32_t ms[FR_BLOCK_SAMPLES];
+          float values[FR_BLOCK_SAMPLES];
+          int count = frDecodeTimes(block, ms);
+          if (count < 0 || frDecodeChannel(block, f, values) != count) {
+            mismatches++;
+            continue;
+          }
+          if (f == 0) blockBytes[t] += offset - start;
+          for (int s = 0; s < count; s++, next++) {
+            if (next >= appended[t].size() || appended[t][next].ms != ms[s] ||
+                appended[t][next].values[f] != values[s]) {
+              mismatches++;
+            }
+          }
+        }
+        if (offset != (size_t)payload) mismatches++;
+      }
+      if (next != appended[t].size()) mismatches++;
+      decoded[t] = next;
+    }
+  }
+
+  printf("Clean %d s run, decoded channel by channel:\n", CLEAN_RUN_MS / 1000);
+  printf("%-10s %8s %12s %12s %8s\n", "type", "records", "row bytes", "block bytes", "ratio");
+  size_t rowTotal = 0;
+  for (int t = 0; t < FR_RECORD_TYPES; t++) {
+    size_t rowBytes = decoded[t] * (3 + 2 * FR_LAYOUTS[t].fields);
+    rowTotal += rowBytes;
+    printf("%-10s %8zu %12zu %12zu %7.1fx\n", FR_LAYOUTS[t].name, decoded[t], rowBytes, blockBytes[t],
+           blockBytes[t] ? (double)rowBytes / blockBytes[t] : 0.0);
+  }
+  double perSecond = (double)flashBytes / (CLEAN_RUN_MS / 1000);
+  printf("Flash %.2f KB/s incl. page headers and slack (rows %.2f KB/s); blackbox partition holds %.0f min\n",
+         perSecond / 1024, (double)rowTotal / (CLEAN_RUN_MS / 1000) / 1024,
+         0x4E0000 * (FR_PAGES_PER_SECTOR - 1.0) / FR_PAGES_PER_SECTOR / perSecond / 60);
+  printf("Decode mismatches %u\n\n", (unsigned)mismatches);
+
+  // Power-cut runs on a fresh partition
+  std::fill(flash.bytes.begin(), flash.bytes.end(), 0xFF);
+  flash.expected.clear();
+  flash.writeOrder.clear();
+  memset(flash.erases, 0, sizeof(flash.erases));
+  memset(flash.cutAt, 0, sizeof(flash.cutAt));
+  std::uniform_int_distribution<int> bootLength(20000, 90000);    // ms
+  uint32_t totalRecords = 0, totalDropped = 0, maxBacklog = 0;
+
+  for (int boot = 0; boot < SIM_BOOTS; boot++) {
+    // Power stays on for some random amount of flash activity
+    flash.dead = false;
+    flash.budget = std::uniform_int_distribution<long>(20000, 400000)(rng);
+    flash.busyMs = 0;
+    if (!frInit(rec, ops)) continue;
+
+    int drainBusyUntil = 0;
+    int length = bootLength(rng);
+    for (int ms = 0; ms < length && !flash.dead; ms++) {
+      flash.inAppend = true;
+      int n = dueTypes(ms, types);
+      for (int i = 0; i < n; i++) {
+        float v[FR_MAX_FIELDS];
+        makeSample(types[i], ms, rng, v);
+        frAppend(rec, (uint8_t)types[i], ms, v);
+      }
+      frSealIfOlder(rec, ms, FR_FLUSH_MS);
+      flash.inAppend = false;
+
+      uint32_t backlog = rec.sealed.load() - rec.drained.load();
+      if (backlog > maxBacklog) maxBacklog = backlog;
+
+      // Drain task: wakes every period unless still inside a slow flash op
+      if (ms >= drainBusyUntil && ms % DRAIN_PERIOD_MS == 0) {
+        flash.busyMs = 0;
+        frDrain(rec, FR_RAM_PAGES);
+        drainBusyUntil = ms + flash.busyMs;
+      }
+    }
+    totalRecords += rec.records;
+    totalDropped += rec.dropped;
+  }
+
+  // Read back like blackbox_dump
+  pages = logPages(flash);
+  uint32_t recovered = 0, torn = 0, wrong = 0;
+  std::vector<uint32_t> readOrder;
+  for (size_t i = 0; i < pages.size(); i++) {
+    uint32_t offset = (uint32_t)(pages[i] - &flash.bytes[0]);
+    uint32_t baseMs;
+    if (frPagePayload(pages[i], baseMs) < 0) {
+      if (frGet16(pages[i]) != 0xFFFF) torn++;
+      continue;
+    }
+    std::map<uint32_t, std::vector<uint8_t> >::const_iterator e = flash.expected.find(offset);
+    if (e == flash.expected.end() || memcmp(&e->second[0], pages[i], FR_PAGE_SIZE) != 0) {
+      wrong++;
+      continue;
+    }
+    recovered++;
+    readOrder.push_back(offset);
+  }
+
+  // Write order of the pages still expected, compared with read order
+  std::vector<uint32_t> expectedOrder;
+  std::map<uint32_t, size_t> lastWrite;
+  for (size_t i = 0; i < flash.writeOrder.size(); i++) lastWrite[flash.writeOrder[i]] = i;
+  for (size_t i = 0; i < flash.writeOrder.size(); i++) {
+    uint32_t offset = flash.writeOrder[i];
+    if (flash.expected.count(offset) && lastWrite[offset] == i) expectedOrder.push_back(offset);
+  }
+  bool ordered = expectedOrder == readOrder;
+
+  uint32_t minWear = 0xFFFFFFFF, maxWear = 0, countOff = 0;
+  for (uint32_t s = 0; s < SIM_SECTORS; s++) {
+    if (flash.erases[s] < minWear) minWear = flash.erases[s];
+    if (flash.erases[s] > maxWear) maxWear = flash.erases[s];
+    RecorderSectorHeader h;
+    if (!frParseSectorHeader(&flash.bytes[s * FR_SECTOR_SIZE], h)) continue;
+    int diff = (int)h.eraseCount - (int)flash.erases[s];
+    int tolerance = flash.cutAt[s] ? 2 : 1;
+    if (diff < -tolerance || diff > tolerance) countOff++;
+  }
+
+  if (argc > 1) {
+    FILE *out = fopen(argv[1], "wb");
+    if (out) {
+      fwrite(&flash.bytes[0], 1, flash.bytes.size(), out);
+      fclose(out);
+    }
+  }
+
+  printf("%d boots, each ended by a power cut; %u sectors (%u KB)\n", SIM_BOOTS, SIM_SECTORS,
+         SIM_SECTORS * FR_SECTOR_SIZE / 1024);
+  printf("Records appended        %u (%u dropped, max RAM backlog %u of %d pages)\n",
+         (unsigned)totalRecords, (unsigned)totalDropped, (unsigned)maxBacklog, FR_RAM_PAGES);
+  printf("Flash calls from append %d\n", flash.opsInAppend);
+  printf("Pages expected          %zu\n", flash.expected.size());
+  printf("Pages recovered         %u (%u torn rejected, %u wrong, order %s)\n", (unsigned)recovered,
+         (unsigned)torn, (unsigned)wrong, ordered ? "kept" : "BROKEN");
+  printf("Sector erases           %u..%u (%u cut short, %u header counts off)\n",
+         (unsigned)minWear, (unsigned)maxWear, (unsigned)flash.erasesCut, (unsigned)countOff);
+
+  bool pass = mismatches == 0 && totalDropped == 0 && flash.opsInAppend == 0 && wrong == 0 && ordered &&
+              recovered == flash.expected.size() && maxWear - minWear <= 1 + flash.erasesCut && countOff == 0;
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/*
+ * Ground Ingest Load Benchmark
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Synthetic fleet load for ground-station/ground_ingest.h, no radios
+ * needed. Each drone gets a pre-generated hex line stream of the kind its
+ * bridge would print: LoRa keyframes / deltas with FEC parity, alternating
+ * with 50Hz ESP-NOW batches when close in. One producer thread per drone
+ * stands in for the source reader and pushes its stream as fast as the
+ * pipeline takes it, with drone time as arrival time so the store rolls
+ * over hourly partitions. Per worker count it reports the sustained line
+ * and sample rates and how many drones at 100Hz that covers, then checks:
+ * every sample stored and re-read from the store files, no undecodable
+ * frames, and the latest state of every drone equal to its last sample.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -pthread -I../software -I../ground-station ground_ingest_bench.cpp -o ground_ingest_bench
+ *   ./ground_ingest_bench [drones] [lines per drone]
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <ftw.h>
+
+#include "ground_ingest.h"
+
+#define PHASE_LINES          500      // Lines per LoRa / ESP-NOW phase
+#define BATCH_SAMPLES        5        // 100 ms of 50Hz samples
+#define FEC_GROUP            4
+#define FLEET_RATE_HZ        100
+
+struct DroneStream {
+  std::vector<std::string> lines;
+  uint64_t samples;
+  TelemetrySnapshot last;
+  std::vector<uint64_t> groundMs;     // Arrival time of each line
+};
+
+static std::string toHex(const uint8_t *data, size_t length) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex(length * 2, '0');
+  for (size_t i = 0; i < length; i++) {
+    hex[2 * i] = digits[data[i] >> 4];
+    hex[2 * i + 1] = digits[data[i] & 15];
+  }
+  return hex + "\n";
+}
+
+static TelemetrySnapshot sampleAt(int drone, uint32_t ms) {
+  TelemetrySnapshot t = TelemetrySnapshot();
+  bool engaged = (ms / 45000 + drone) % 4 == 0;
+  t.type = TELEMETRY_STATUS;
+  t.sections = engaged ? TELEMETRY_SECTION_BIRD : 0;
+  t.timeSeconds = ms / 1000;
+  t.state = engaged ? 2 : 0;
+  t.threat = engaged ? 3 : 0;
+  t.battery = 95.0f - ms / 60000.0f;
+  t.power = (engaged ? 22.0f : 9.0f) + 0.4f * sinf(ms / 700.0f + drone);
+  t.altitude = 60.0f + 20.0f * sinf(ms / 40000.0f + drone);
+  t.verticalSpeed = 0.5f * cosf(ms / 40000.0f + drone);
+  t.temperature = 20.0f;
+  t.birdConfidence = 85;
+  t.birdDistance = 80.0f;
+  t.birdBearing = 20.0f;
+  t.birdSpecies = 1;
+  return t;
+}
+
+static void generate(int drone, size_t count, uint64_t epochMs, DroneStream &s) {
+  TelemetryDeltaEncoder delta;
+  telemetryDeltaInit(delta);
+  FecEncoder fec;
+  fecEncoderInit(fec, FEC_GROUP, 1);
+  uint8_t frame[ESPNOW_MAX_PAYLOAD];
+  uint8_t loraSequence = 0, batchSequence = 0, sampleSequence = 0;
+  uint32_t ms = (uint32_t)drone * 137;
+  s.samples = 0;
+
+  while (s.lines.size() < count) {
+    bool espNow = (s.lines.size() / PHASE_LINES) % 2 == 1 || s.lines.size() + PHASE_LINES > count;
+    if (espNow) {
+      TelemetryBatch batch;
+      telemetryBatchClear(batch);
+      for (int i = 0; i < BATCH_SAMPLES; i++, ms += 20) {
+        TelemetrySnapshot t = sampleAt(drone, ms);
+        t.sequence = sampleSequence++;
+        telemetryBatchAdd(batch, batchSequence, t, ms);
+        s.last = t;
+      }
+      batchSequence++;
+      s.samples += BATCH_SAMPLES;
+      s.lines.push_back(toHex(batch.data, batch.length));
+      s.groundMs.push_back(epochMs + ms);
+      continue;
+    }
+
+    ms += 1000;
+    TelemetrySnapshot t = sampleAt(drone, ms);
+    t.sequence = loraSequence++;
+    size_t length = telemetryDeltaEncode(delta, t, frame, TELEMETRY_MAX_FRAME);
+    telemetryDeltaOnAck(delta, t.sequence);
+    s.lines.push_back(toHex(frame, length));
+    s.groundMs.push_back(epochMs + ms);
+    s.samples++;
+    s.last = t;
+    if (fecEncoderAdd(fec, t.sequence, frame, length)) {
+      size_t parity = fecEncoderParity(fec, 0, frame, sizeof(frame));
+      s.lines.push_back(toHex(frame, parity));
+      s.groundMs.push_back(epochMs + ms);
+    }
+  }
+}
+
+static void producer(IngestSource *source, const DroneStream *s) {
+  for (size_t i = 0; i < s->lines.size(); i++) ingestPushLine(*source, s->lines[i].c_str(), s->groundMs[i]);
+}
+
+static bool sameSample(const TelemetrySnapshot &a, const TelemetrySnapshot &b) {
+  uint8_t x[TELEMETRY_MAX_FRAME], y[TELEMETRY_MAX_FRAME];
+  size_t n = telemetryEncode(a, x, sizeof(x)), m = telemetryEncode(b, y, sizeof(y));
+  return n > 0 && n == m && memcmp(x, y, n) == 0;
+}
+
+// Depth first, so files go before the directories holding them
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *) {
+  return remove(path);
+}
+
+static void removeTree(const char *dir) {
+  nftw(dir, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+// Records in every partition file of one drone, each decoded
+static uint64_t countStored(const std::string &dir, uint64_t &bad, int &files) {
+  uint64_t records = 0;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return 0;
+  struct dirent *e;
+  std::vector<uint8_t> data;
+  while ((e = readdir(d)) != NULL) {
+    if (!strstr(e->d_name, ".tlm")) continue;
+    files++;
+    FILE *f = fopen((dir + "/" + e->d_name).c_str(), "rb");
+    if (!f) continue;
+    data.clear();
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+    fclose(f);
+    if (data.size() < 4 || ingestGet32(&data[0]) != INGEST_STORE_MAGIC) {
+      bad++;
+      continue;
+    }
+    for (size_t at = 4; at + INGEST_RECORD_HEADER <= data.size();) {
+      size_t length = data[at + 12];
+      TelemetrySnapshot t;
+      if (at + INGEST_RECORD_HEADER + length > data.size() ||
+          !telemetryDecode(&data[at + INGEST_RECORD_HEADER], length, t)) {
+        bad++;
+        break;
+      }
+      records++;
+      at += INGEST_RECORD_HEADER + length;
+    }
+  }
+  closedir(d);
+  return records;
+}
+
+int main(int argc, char **argv) {
+  int drones = argc > 1 ? atoi(argv[1]) : 16;
+  size_t linesPerDrone = argc > 2 ? (size_t)atol(argv[2]) : 20000;
+  uint64_t epochMs = 1767225600000ULL;  // 2026-01-01 00:00 UTC
+
+  std::vector<DroneStream> streams(drones);
+  uint64_t totalLines = 0, totalSamples = 0, hexBytes = 0;
+  for (int d = 0; d < drones; d++) {
+    generate(d, linesPerDrone, epochMs, streams[d]);
+    totalLines += streams[d].lines.size();
+    totalSamples += streams[d].samples;
+    for (size_t i = 0; i < streams[d].lines.size(); i++) hexBytes += streams[d].lines[i].size();
+  }
+  printf("%d drones, %llu lines (%.1f MB of hex), %llu samples, %u hardware threads\n\n", drones,
+         (unsigned long long)totalLines, hexBytes / 1e6, (unsigned long long)totalSamples,
+         std::thread::hardware_concurrency());
+  printf("%8s %12s %14s %12s %10s %12s\n", "workers", "lines/s", "samples/s", "MB/s hex", "stalls",
+         "drones@100Hz");
+
+  bool pass = true;
+  const size_t workerCounts[] = {1, 2, 4, 8};
+  for (size_t w = 0; w < sizeof(workerCounts) / sizeof(workerCounts[0]); w++) {
+    char dir[] = "/tmp/ingest_XXXXXX";
+    if (!mkdtemp(dir)) return 1;
+    std::unique_ptr<IngestPipeline> p(new IngestPipeline());
+    ingestOpen(*p, dir);
+    for (int d = 0; d < drones; d++) {
+      char name[16];
+      snprintf(name, sizeof(name), "drone%02d", d);
+      ingestAddSource(*p, name);
+    }
+
+    uint64_t start = ingestNowMs();
+    ingestStart(*p, workerCounts[w]);
+    std::vector<std::thread> producers;
+    for (int d = 0; d < drones; d++) producers.push_back(std::thread(producer, p->sources[d].get(), &streams[d]));
+    for (size_t i = 0; i < producers.size(); i++) producers[i].join();
+    ingestStop(*p);
+    double seconds = (ingestNowMs() - start) / 1000.0;
+
+    uint64_t samples = 0, stalls = 0, undecodable = 0, stored = 0, storeBad = 0;
+    int mismatched = 0, files = 0;
+    for (int d = 0; d < drones; d++) {
+      IngestSource &s = *p->sources[d];
+      samples += s.samples;
+      stalls += s.stalls;
+      undecodable += s.undecodable + s.badLines;
+      stored += countStored(std::string(dir) + "/" + s.name, storeBad, files);
+      TelemetrySnapshot t;
+      uint64_t groundMs;
+      uint32_t droneMs;
+      if (!ingestLatest(s, t, groundMs, droneMs) || !sameSample(t, streams[d].last)) mismatched++;
+    }
+    double samplesPerSecond = samples / seconds;
+    printf("%8zu %12.0f %14.0f %12.1f %10llu %12.0f\n", workerCounts[w], totalLines / seconds, samplesPerSecond,
+           hexBytes / 1e6 / seconds, (unsigned long long)stalls, samplesPerSecond / FLEET_RATE_HZ);
+
+    bool ok = samples == totalSamples && stored == totalSamples && storeBad == 0 && undecodable == 0 &&
+              mismatched == 0 && p->storeErrors == 0;
+    if (!ok) {
+      printf("  %llu/%llu samples ingested, %llu stored (%llu bad), %llu undecodable, %d latest mismatched\n",
+             (unsigned long long)samples, (unsigned long long)totalSamples, (unsigned long long)stored,
+             (unsigned long long)storeBad, (unsigned long long)undecodable, mismatched);
+    }
+    if (w == 0) printf("  (%d hourly partition files)\n", files);
+    pass = pass && ok;
+    p.reset();
+    removeTree(dir);
+  }
+
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+/*
+ * Health Monitor Host Evaluation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Drives software/health_monitor.h at the controller's ACTIVE rates
+ * (1kHz loop, 200Hz IMU, 25Hz baro, 1Hz GPS, 10Hz Pi messages, a 50Hz
+ * INA219 sweep of three rails) through ten minutes with one fault at a
+ * time: IMU dropout, baro dropout, GPS loss, an I2C error burst, a stalled
+ * and a slowed Pi, a lost LoRa transmission, runs of slow loop passes and
+ * a heap drop. Each second's flags are compared with the fault schedule: a
+ * fault's flag must be up while it lasts and nothing else may be, except
+ * at its edges (one check, plus the staleness limit) and the flags it
+ * legitimately drags along (a dead IMU also fails its I2C reads).
+ *
+ * Throughout, the controller's routine reporting stalls single passes as
+ * it does on the bench: a 20ms pass every 10s (energy CSV line) and every
+ * 30s (rate profile report), landing in the same second. Those isolated
+ * passes must not raise the loop overrun flag.
+ *
+ * Cost: the hooks and the once-a-second evaluation are timed on the host
+ * and scaled by HOST_TO_ESP32 for a 240MHz ESP32-S3, against the 1% CPU
+ * budget. The controller reports the measured share of its checks too.
+ *
+ * Also round-trips the telemetry health section through full and delta
+ * frames, and checks that a version 1 frame still decodes.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software health_monitor_sim.cpp -o health_monitor_sim
+ *   ./health_monitor_sim
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "health_monitor.h"
+#include "telemetry_delta.h"
+
+#define RUN_SECONDS          600
+#define LOOP_US              1000
+#define IMU_MS               5
+#define BARO_MS              40
+#define PI_MS                100
+#define POWER_MS             20
+#define HEAP_BYTES           180000
+#define REPORT_TICK_US       20000    // A report burst's loop pass
+#define HOST_TO_ESP32        20.0     // Conservative host / ESP32-S3 speed ratio
+#define CPU_BUDGET_PERCENT   1.0
+
+struct Fault {
+  const char *name;
+  uint16_t flag;
+  uint16_t also;            // Other flags it may raise
+  uint32_t fromMs, toMs;
+  uint32_t settleMs;        // Beyond one check before the flag follows an edge
+};
+
+static const Fault FAULTS[] = {
+  {"IMU dropout",     HEALTH_IMU_STALE,       HEALTH_I2C_ERRORS, 60000,  63000,  HEALTH_IMU_STALE_MS},
+  {"baro dropout",    HEALTH_BARO_STALE,      HEALTH_I2C_ERRORS, 100000, 106000, HEALTH_BARO_STALE_MS},
+  {"GPS lost",        HEALTH_GPS_STALE,       0,                 150000, 160000, HEALTH_GPS_STALE_MS},
+  {"I2C errors (5%)", HEALTH_I2C_ERRORS,      0,                 200000, 205000, 0},
+  {"Pi stalled",      HEALTH_PI_SILENT,       HEALTH_PI_SLOW,    250000, 255000, HEALTH_PI_SILENT_MS},
+  {"Pi at 1 msg/s",   HEALTH_PI_SLOW,         0,                 300000, 310000, HEALTH_CHECK_INTERVAL_MS},
+  {"LoRa TX lost",    HEALTH_LORA_TX_FAILING, 0,                 350000, 350001, 0},
+  {"loop overruns",   HEALTH_LOOP_OVERRUN,    0,                 400000, 403000, 0},
+  {"heap low",        HEALTH_LOW_HEAP,        0,                 450000, 455000, 0},
+};
+#define FAULT_COUNT (sizeof(FAULTS) / sizeof(FAULTS[0]))
+
+static bool active(int f, uint32_t ms) {
+  return ms >= FAULTS[f].fromMs && ms < FAULTS[f].toMs;
+}
+
+// A fault's flag is required while it lasts and allowed, with what it
+// drags along, around its edges
+static void expectedFlags(uint32_t checkMs, uint16_t &required, uint16_t &allowed) {
+  required = allowed = 0;
+  for (size_t f = 0; f < FAULT_COUNT; f++) {
+    const Fault &fault = FAULTS[f];
+    uint32_t settle = HEALTH_CHECK_INTERVAL_MS + fault.settleMs;
+    bool edge = (checkMs >= fault.fromMs && checkMs < fault.fromMs + settle) ||
+                (checkMs >= fault.toMs && checkMs < fault.toMs + settle);
+    if (edge || active((int)f, checkMs)) allowed |= fault.flag | fault.also;
+    if (!edge && active((int)f, checkMs)) required |= fault.flag;
+  }
+}
+
+static double nowNs() {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool sameHealth(const TelemetrySnapshot &a, const TelemetrySnapshot &b) {
+  return a.healthFlags == b.healthFlags && a.freeHeapKb == b.freeHeapKb && a.i2cErrors == b.i2cErrors &&
+         a.loraTxFailures == b.loraTxFailures && a.loopOverruns == b.loopOverruns && a.piRate == b.piRate &&
+         fabsf(a.piAgeSeconds - b.piAgeSeconds) < 0.01f;
+}
+
+static int frameChecks() {
+  int failures = 0;
+  TelemetrySnapshot t = TelemetrySnapshot();
+  t.sections = TELEMETRY_SECTION_HEALTH | TELEMETRY_SECTION_ENDURANCE;
+  t.timeSeconds = 1234;
+  t.battery = 80.0f;
+  t.altitude = 60.0f;
+  t.enduranceSeconds = 1800.0f;
+  t.healthFlags = HEALTH_GPS_STALE | HEALTH_LOW_HEAP;
+  t.freeHeapKb = 28.0f;
+  t.i2cErrors = 17;
+  t.loraTxFailures = 3;
+  t.loopOverruns = 250;
+  t.piRate = 9;
+  t.piAgeSeconds = 0.3f;
+
+  // Full frame
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  TelemetrySnapshot decoded = TelemetrySnapshot();
+  size_t length = telemetryEncode(t, frame, sizeof(frame));
+  if (length == 0 || !telemetryDecode(frame, length, decoded) || !sameHealth(t, decoded)) failures++;
+
+  // Every section at once still fits
+  TelemetrySnapshot all = t;
+  all.sections = TELEMETRY_ALL_SECTIONS;
+  size_t allLength = telemetryEncode(all, frame, sizeof(frame));
+  if (allLength == 0) failures++;
+
+  // Delta against an acked keyframe, counters moving
+  TelemetryDeltaEncoder enc;
+  TelemetryDeltaDecoder dec;
+  telemetryDeltaInit(enc);
+  telemetryDeltaDecoderInit(dec);
+  size_t deltaLength = 0;
+  for (int i = 0; i < 3; i++) {
+    t.sequence = (uint8_t)i;
+    t.i2cErrors += i;
+    t.healthFlags ^= i == 2 ? HEALTH_PI_SLOW : 0;
+    size_t n = telemetryDeltaEncode(enc, t, frame, sizeof(frame));
+    telemetryDeltaOnAck(enc, t.sequence);
+    decoded = TelemetrySnapshot();
+    if (n == 0 || !telemetryDeltaDecode(dec, frame, n, decoded) || !sameHealth(t, decoded)) failures++;
+    if (i > 0) deltaLength = n;
+  }
+
+  // Version 1 frame: 6-bit section bitmap, no health section
+  TelemetrySnapshot old = TelemetrySnapshot();
+  old.sequence = 42;
+  old.sections = TELEMETRY_SECTION_BIRD;
+  old.altitude = 75.0f;
+  old.birdDistance = 60.0f;
+  BitWriter w;
+  bitWriterInit(w, frame, sizeof(frame));
+  bitWrite(w, 1, 3);
+  bitWrite(w, TELEMETRY_STATUS, 3);
+  bitWrite(w, old.sequence, 8);
+  bitWrite(w, old.sections, 6);
+  telemetryWriteCore(w, old);
+  telemetryWriteSections(w, old);
+  decoded = TelemetrySnapshot();
+  bool oldOk = telemetryDecode(frame, bitWriterBytes(w), decoded) && decoded.sequence == 42 &&
+               decoded.sections == TELEMETRY_SECTION_BIRD && decoded.altitude == 75.0f &&
+               decoded.birdDistance == 60.0f;
+  if (!oldOk) failures++;
+
+  printf("Health section: full frame %zu B (all sections %zu B), delta %zu B; version 1 decode %s\n", length,
+         allLength, deltaLength, oldOk ? "ok" : "FAILED");
+  return failures;
+}
+
+int main() {
+  HealthMonitor h;
+  healthMonitorInit(h, 0);
+  uint32_t powerTransactions = 0, powerErrors = 0, loraFailures = 0;
+  uint32_t lastImu = 0, lastBaro = 0, lastPi = 0, lastPower = 0, lastGps = 0;
+  uint32_t seed = 1;
+  int mismatches[FAULT_COUNT] = {0}, raised[FAULT_COUNT] = {0}, spurious = 0;
+  double hookNs = 0, checkNs = 0;
+  uint32_t hookCalls = 0;
+  uint32_t reportTicks = 0, reportTickOverruns = 0;
+
+  for (uint32_t us = 0; us < RUN_SECONDS * 1000000UL; us += LOOP_US) {
+    uint32_t ms = us / 1000;
+    double start = nowNs();
+    if (ms - lastImu >= IMU_MS) {
+      lastImu = ms;
+      bool ok = !active(0, ms);
+      healthI2c(h, 1, ok);
+      if (ok) healthSensorGood(h, HEALTH_SENSOR_IMU, ms);
+      hookCalls++;
+    }
+    if (ms - lastBaro >= BARO_MS) {
+      lastBaro = ms;
+      bool ok = !active(1, ms);
+      healthI2c(h, 2, ok);
+      if (ok) healthSensorGood(h, HEALTH_SENSOR_BARO, ms);
+      hookCalls++;
+    }
+    if (ms - lastGps >= 1000) {
+      lastGps = ms;
+      if (!active(2, ms)) healthSensorGood(h, HEALTH_SENSOR_GPS, ms);
+      hookCalls++;
+    }
+    uint32_t piInterval = active(5, ms) ? 1000 : PI_MS;
+    if (ms - lastPi >= piInterval && !active(4, ms)) {
+      lastPi = ms;
+      healthPiMessage(h, ms);
+      hookCalls++;
+    }
+    // INA219 counts its own transactions and errors; 5% fail in the burst
+    if (ms - lastPower >= POWER_MS) {
+      lastPower = ms;
+      for (int r = 0; r < 6; r++) {
+        seed = seed * 1103515245u + 12345u;
+        powerTransactions++;
+        if (active(3, ms) && (seed >> 16) % 100 < 5) powerErrors++;
+      }
+    }
+    if (active(6, ms)) loraFailures++;
+    // Faulty: 10 slow passes in a row twice a second; routine: isolated report ticks
+    uint32_t loopMicros = active(7, ms) && ms % 500 < 10 ? 7000 : 600;
+    bool reportTick = ms % 10000 == 5 || ms % 30000 == 505;
+    if (reportTick) {
+      loopMicros = REPORT_TICK_US;
+      reportTicks++;
+    }
+    healthLoopPass(h, loopMicros, IMU_MS * 1000);
+    hookCalls++;
+    double hooksDone = nowNs();
+    hookNs += hooksDone - start;
+
+    if (ms > 0 && ms % HEALTH_CHECK_INTERVAL_MS == 0 && us % 1000 == 0) {
+      uint32_t heap = active(8, ms) ? 24000 : HEAP_BYTES;
+      uint16_t flags = healthEvaluate(h, ms, powerTransactions, powerErrors, loraFailures, heap);
+      checkNs += nowNs() - hooksDone;
+
+      uint16_t required, allowed;
+      expectedFlags(ms, required, allowed);
+      for (size_t f = 0; f < FAULT_COUNT; f++) {
+        if ((required & FAULTS[f].flag) && !(flags & FAULTS[f].flag)) mismatches[f]++;
+        if (flags & FAULTS[f].flag) raised[f]++;
+      }
+      if (flags & ~allowed) spurious++;
+      if ((flags & HEALTH_LOOP_OVERRUN) && !(allowed & HEALTH_LOOP_OVERRUN) && ms % 10000 == 1000) {
+        reportTickOverruns++;
+      }
+    }
+  }
+
+  printf("%-20s %10s %10s %8s\n", "fault", "window s", "flagged s", "missed");
+  int total = 0;
+  for (size_t f = 0; f < FAULT_COUNT; f++) {
+    printf("%-20s %10.1f %10d %8d\n", FAULTS[f].name, (FAULTS[f].toMs - FAULTS[f].fromMs) / 1000.0, raised[f],
+           mismatches[f]);
+    total += mismatches[f] + (raised[f] == 0);
+  }
+  printf("Spurious checks: %d; %lu flag raises over %lu checks\n", spurious, (unsigned long)h.flagRaises,
+         (unsigned long)h.checks);
+  printf("Isolated %d ms report ticks: %u, loop overrun raised after %u\n\n", REPORT_TICK_US / 1000,
+         (unsigned)reportTicks, (unsigned)reportTickOverruns);
+
+  double hostPercent = 100.0 * (hookNs + checkNs) / (RUN_SECONDS * 1e9);
+  double esp32Percent = hostPercent * HOST_TO_ESP32;
+  printf("Host cost: %.1f ns per hook (%u calls/s), %.0f ns per check\n", hookNs / hookCalls,
+         (unsigned)(hookCalls / RUN_SECONDS), checkNs / h.checks);
+  printf("CPU share: %.4f%% on the host, ~%.3f%% on an ESP32-S3 (x%.0f), budget %.0f%%\n\n", hostPercent,
+         esp32Percent, HOST_TO_ESP32, CPU_BUDGET_PERCENT);
+
+  int frameFailures = frameChecks();
+  bool pass = total == 0 && spurious == 0 && reportTickOverruns == 0 && esp32Percent < CPU_BUDGET_PERCENT && frameFailures == 0;
+  if (frameFailures) printf("%d telemetry round-trip failures\n", frameFailures);
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/*
+ * Log Offload Loopback Test
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Runs the ground receiver (ground-station/offload_receiver.h) on a
+ * loopback socket against a stand-in drone that sends a partition image
+ * the way logOffloadTask() in esp32_main_controller.cpp does: HELLO,
+ * RESUME, then sector chunks read straight into the send buffer. Two
+ * transfers:
+ *   clean   one connection, reports throughput
+ *   faulty  the link is cut and chunks are corrupted at random points;
+ *           the drone reconnects each time and must resume from the last
+ *           ack rather than from zero
+ * Both images must arrive byte for byte.
+ *
+ * The image is the given file (e.g. the one flight_recorder_sim writes)
+ * or a synthetic 4 MB partition that is 60% written.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -pthread -I../software -I../ground-station offload_loopback_sim.cpp -o offload_loopback_sim
+ *   ./offload_loopback_sim [image.bin]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "offload_receiver.h"
+
+#define SYNTHETIC_SIZE       (4 * 1024 * 1024)
+#define FAULTS               8
+
+static int chunksSent = 0;
+
+struct Receiver {
+  int server;
+  int port;
+  std::string dir;
+  std::mutex lock;
+  std::vector<OffloadSessionStats> sessions;
+};
+
+static void receiverThread(Receiver *receiver) {
+  for (;;) {
+    int client = accept(receiver->server, NULL, NULL);
+    if (client < 0) return;  // Listening socket closed
+    OffloadSessionStats stats;
+    offloadServe(client, receiver->dir.c_str(), stats);
+    close(client);
+    std::lock_guard<std::mutex> guard(receiver->lock);
+    receiver->sessions.push_back(stats);
+  }
+}
+
+// What can go wrong on one connection: cut after n chunks, or corrupt one
+struct Fault {
+  int chunk;                // -1 = none
+  bool corrupt;
+};
+
+// Stand-in drone: one connection. Returns the last offset acknowledged.
+static uint32_t sendConnection(int port, const OffloadImage &image, const std::vector<uint8_t> &flash,
+                               const Fault &fault, uint32_t &resumedAt) {
+  int s = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons((uint16_t)port);
+  int yes = 1;
+  setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  if (connect(s, (struct sockaddr *)&address, sizeof(address)) != 0) {
+    close(s);
+    return 0;
+  }
+
+  uint8_t hello[OFFLOAD_HELLO_LENGTH], resume[OFFLOAD_RESUME_LENGTH];
+  offloadEncodeHello(image, hello);
+  uint32_t offset = 0, acked = 0;
+  if (!offloadWriteExact(s, hello, sizeof(hello)) || !offloadReadExact(s, resume, sizeof(resume)) ||
+      !offloadParseResume(resume, offset)) {
+    close(s);
+    return 0;
+  }
+  resumedAt = acked = offset;
+
+  static uint8_t frame[OFFLOAD_FRAME_MAX];
+  uint8_t ack[OFFLOAD_ACK_LENGTH];
+  size_t ackFill = 0;
+  for (int sent = 0; offset < image.size; sent++, offset += image.chunkSize) {
+    if (sent == fault.chunk && !fault.corrupt) {
+      close(s);  // Link cut
+      return acked;
+    }
+    memcpy(frame + OFFLOAD_CHUNK_HEADER, &flash[offset], image.chunkSize);  // esp_partition_read
+    size_t length = offloadFinishChunk(frame, offset, image.chunkSize);
+    if (sent == fault.chunk) frame[length / 2] ^= 0x10;
+    if (!offloadWriteExact(s, frame, length)) break;
+    chunksSent++;
+
+    // Acks as they arrive, without stalling the stream
+    ssize_t n;
+    while ((n = recv(s, ack + ackFill, sizeof(ack) - ackFill, MSG_DONTWAIT)) > 0) {
+      ackFill += (size_t)n;
+      if (ackFill == sizeof(ack)) {
+        offloadParseAck(ack, acked);
+        ackFill = 0;
+      }
+    }
+  }
+  // Final ack, or the receiver hanging up
+  while (acked < image.size && offloadReadExact(s, ack + ackFill, sizeof(ack) - ackFill)) {
+    offloadParseAck(ack, acked);
+    ackFill = 0;
+  }
+  close(s);
+  return acked;
+}
+
+static bool sameFile(const std::string &path, const std::vector<uint8_t> &expected) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  std::vector<uint8_t> got(expected.size() + 1);
+  size_t n = fread(&got[0], 1, got.size(), f);
+  fclose(f);
+  return n == expected.size() && memcmp(&got[0], &expected[0], n) == 0;
+}
+
+int main(int argc, char **argv) {
+  std::vector<uint8_t> flash;
+  if (argc > 1) {
+    FILE *f = fopen(argv[1], "rb");
+    if (!f) {
+      perror(argv[1]);
+      return 1;
+    }
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) flash.insert(flash.end(), chunk, chunk + n);
+    fclose(f);
+    flash.resize(flash.size() / OFFLOAD_CHUNK_SIZE * OFFLOAD_CHUNK_SIZE);
+  } else {
+    std::mt19937 rng(5);
+    flash.assign(SYNTHETIC_SIZE, 0xFF);
+    for (size_t i = 0; i < SYNTHETIC_SIZE * 6 / 10; i++) flash[i] = (uint8_t)rng();
+  }
+
+  Receiver receiver;
+  char dir[] = "/tmp/offload_XXXXXX";
+  if (!mkdtemp(dir) || flash.empty()) return 1;
+  receiver.dir = dir;
+  receiver.server = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t length = sizeof(address);
+  if (bind(receiver.server, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(receiver.server, 4) != 0 || getsockname(receiver.server, (struct sockaddr *)&address, &length) != 0) {
+    perror("listen");
+    return 1;
+  }
+  receiver.port = ntohs(address.sin_port);
+  std::thread serving(receiverThread, &receiver);
+
+  OffloadImage image;
+  image.boot = 7;
+  image.sequence = 1000;
+  image.size = (uint32_t)flash.size();
+  image.chunkSize = OFFLOAD_CHUNK_SIZE;
+
+  // Clean transfer
+  Fault none = {-1, false};
+  uint32_t resumedAt = 0;
+  double start = offloadNow();
+  uint32_t acked = sendConnection(receiver.port, image, flash, none, resumedAt);
+  double seconds = offloadNow() - start;
+  bool cleanOk = acked == image.size && sameFile(std::string(dir) + "/bbx-7-1000.bin", flash);
+
+  // Faulty link: same drone, next flight
+  image.sequence = 2000;
+  std::mt19937 rng(11);
+  int chunks = (int)(image.size / image.chunkSize);
+  int connections = 0, badResumes = 0;
+  chunksSent = 0;
+  uint32_t lastAcked = 0;
+  acked = 0;
+  while (acked < image.size && connections < 100) {
+    Fault fault = {-1, false};
+    if (connections < FAULTS) {
+      fault.chunk = std::uniform_int_distribution<int>(0, chunks / FAULTS)(rng);
+      fault.corrupt = connections % 2 == 1;
+    }
+    acked = sendConnection(receiver.port, image, flash, fault, resumedAt);
+    // Each reconnect picks up at or after the last ack seen by the drone
+    if (resumedAt < lastAcked) badResumes++;
+    if (acked > lastAcked) lastAcked = acked;
+    connections++;
+  }
+  bool faultyOk = acked == image.size && sameFile(std::string(dir) + "/bbx-7-2000.bin", flash);
+
+  shutdown(receiver.server, SHUT_RDWR);
+  close(receiver.server);
+  serving.join();
+
+  uint32_t erased = 0;
+  for (size_t i = 0; i < receiver.sessions.size(); i++) {
+    if (receiver.sessions[i].image.sequence == 1000) erased = receiver.sessions[i].erasedChunks;
+  }
+
+  printf("Image %.2f MB, %d chunks of %d bytes (%u erased, sent as headers)\n", image.size / 1e6, chunks,
+         OFFLOAD_CHUNK_SIZE, (unsigned)erased);
+  printf("Clean:  1 connection, %.3f s, %.1f MB/s over loopback, image %s\n", seconds,
+         image.size / 1e6 / seconds, cleanOk ? "identical" : "DIFFERENT");
+  printf("Faulty: %d connections (%d cuts / corruptions), %d chunks sent for %d, %d resumes behind the last ack, image %s\n",
+         connections, FAULTS, chunksSent, chunks, badResumes, faultyOk ? "identical" : "DIFFERENT");
+
+  bool pass = cleanOk && faultyOk && badResumes == 0 && connections == FAULTS + 1;
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+/*
+ * Battery SoC Estimator Host Evaluation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Replays a discharge trace through software/battery_soc.h and compares it
+ * with the old linear 9.0V-12.6V voltage map. Passes when the estimator's
+ * RMS error is below RMS_LIMIT_PERCENT and below the linear map's.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software soc_estimator_sim.cpp -o soc_estimator_sim
+ *   ./soc_estimator_sim                 # synthetic mission discharge
+ *   ./soc_estimator_sim trace.csv       # recorded trace
+ *
+ * Trace CSV columns: time_s,pack_voltage_v,pack_current_a[,true_soc_pct]
+ * Without a true_soc column the reference is built by coulomb counting
+ * backwards from the OCV of the final sample, so recorded traces should end
+ * with a rest period.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "battery_soc.h"
+
+#define RMS_LIMIT_PERCENT  3.0
+
+struct TraceSample {
+  float time, voltage, current, trueSoc;  // trueSoc 0..1
+};
+
+// 3S pack model: OCV curve, series resistance and one RC polarisation
+// branch, so the terminal voltage sags under strobe pulses and relaxes slowly.
+static std::vector<TraceSample> syntheticTrace() {
+  std::vector<TraceSample> trace;
+  std::mt19937 rng(42);
+  std::normal_distribution<float> voltageNoise(0.0f, 0.03f);
+  std::normal_distribution<float> currentNoise(0.0f, 0.05f);
+
+  const float dt = 0.1f;
+  const float capacityAh = 3.0f * 0.97f;  // Real pack slightly below nominal
+  const float r0 = 0.075f, r1 = 0.035f, tau1 = 25.0f;
+  const float sensorGain = 1.02f, sensorOffset = 0.02f;
+
+  float soc = 0.95f;
+  float polarisation = 0.0f;
+  float t = 0.0f;
+
+  while (soc > 0.08f) {
+    // Standby ~0.9A (Pi + ESP32); every 5 minutes a 60s engagement at 4.5A
+    // with 1Hz audio bursts on top
+    float load = 0.9f;
+    float cycle = fmodf(t, 300.0f);
+    if (cycle > 200.0f && cycle < 260.0f) {
+      load = 4.5f + ((int)cycle % 2 ? 1.2f : 0.0f);
+    }
+
+    soc -= load * dt / 3600.0f / capacityAh;
+    polarisation += (load * r1 - polarisation) * dt / tau1;
+    float terminal = BATTERY_CELLS * batterySocToOcv(soc) - load * r0 - polarisation;
+
+    TraceSample s;
+    s.time = t;
+    s.voltage = terminal + voltageNoise(rng);
+    s.current = load * sensorGain + sensorOffset + currentNoise(rng);
+    s.trueSoc = soc;
+    trace.push_back(s);
+    t += dt;
+  }
+  return trace;
+}
+
+static bool loadTrace(const char *path, std::vector<TraceSample> &trace) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  bool hasTruth = false;
+  while (fgets(line, sizeof(line), f)) {
+    TraceSample s;
+    int n = sscanf(line, "%f,%f,%f,%f", &s.time, &s.voltage, &s.current, &s.trueSoc);
+    if (n < 3) continue;  // Header / blank
+    if (n == 4) {
+      s.trueSoc /= 100.0f;
+      hasTruth = true;
+    }
+    trace.push_back(s);
+  }
+  fclose(f);
+
+  if (!hasTruth && !trace.empty()) {
+    // Reference: backwards coulomb count from the final rested OCV
+    BatterySocEstimator ref;
+    batterySocInit(ref);
+    const TraceSample &last = trace.back();
+    float soc = batterySocFromVoltage(ref, last.voltage, last.current);
+    for (size_t i = trace.size(); i-- > 0;) {
+      trace[i].trueSoc = soc;
+      if (i > 0) {
+        float dt = trace[i].time - trace[i - 1].time;
+        soc += trace[i].current * dt / 3600.0f / BATTERY_CAPACITY_AH;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<TraceSample> trace;
+  if (argc > 1) {
+    if (!loadTrace(argv[1], trace)) {
+      fprintf(stderr, "Cannot read trace %s\n", argv[1]);
+      return 2;
+    }
+    printf("Trace: %s (%zu samples)\n", argv[1], trace.size());
+  } else {
+    trace = syntheticTrace();
+    printf("Trace: synthetic 3S mission discharge (%zu samples)\n", trace.size());
+  }
+  if (trace.size() < 2) return 2;
+
+  BatterySocEstimator est;
+  batterySocInit(est);
+
+  double estSq = 0, linSq = 0;
+  float estMax = 0, linMax = 0;
+  float prevTime = trace[0].time;
+  int samples = 0;
+
+  for (size_t i = 0; i < trace.size(); i++) {
+    const TraceSample &s = trace[i];
+    batterySocUpdate(est, s.voltage, s.current, s.time - prevTime);
+    prevTime = s.time;
+
+    float linear = (s.voltage - 9.0f) / (12.6f - 9.0f);
+    if (linear < 0.0f) linear = 0.0f;
+    if (linear > 1.0f) linear = 1.0f;
+
+    float e1 = 100.0f * (est.soc - s.trueSoc);
+    float e2 = 100.0f * (linear - s.trueSoc);
+    estSq += e1 * e1;
+    linSq += e2 * e2;
+    if (fabsf(e1) > estMax) estMax = fabsf(e1);
+    if (fabsf(e2) > linMax) linMax = fabsf(e2);
+    samples++;
+  }
+
+  printf("Duration %.0f s, learned pack resistance %.3f Ohm\n\n",
+         trace.back().time - trace[0].time, est.internalResistance);
+  printf("%-22s %10s %10s\n", "estimator", "RMS %", "max %");
+  double estRms = sqrt(estSq / samples), linRms = sqrt(linSq / samples);
+  printf("%-22s %10.2f %10.2f\n", "coulomb + OCV", estRms, estMax);
+  printf("%-22s %10.2f %10.2f\n", "linear voltage map", linRms, linMax);
+
+  bool pass = estRms < RMS_LIMIT_PERCENT && estRms < linRms;
+  printf("\nEstimator RMS limit %.1f%%\n%s\n", RMS_LIMIT_PERCENT, pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
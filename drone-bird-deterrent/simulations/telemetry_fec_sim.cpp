@@ -0,0 +1,181 @@
+/*
+ * Telemetry FEC Host Evaluation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Sends a synthetic mission's keyframe / delta telemetry through
+ * software/telemetry_fec.h over a lossy channel and reports, per loss
+ * rate and group shape, the share of frames the ground ends up with and
+ * the extra airtime the parity costs (SF10, CR 4/8 - the slowest setting
+ * the dwell limit allows). Channels: independent loss, and bursty
+ * Gilbert-Elliott loss with a mean burst of 3 packets. Every rebuilt frame
+ * is checked byte for byte against the one sent.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software telemetry_fec_sim.cpp -o telemetry_fec_sim
+ *   ./telemetry_fec_sim
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "lora_airtime.h"
+#include "telemetry_delta.h"
+#include "telemetry_fec.h"
+
+struct Packet {
+  std::vector<uint8_t> bytes;
+};
+
+static std::vector<Packet> missionFrames(int count) {
+  std::vector<Packet> frames;
+  TelemetryDeltaEncoder enc;
+  telemetryDeltaInit(enc);
+  for (int i = 0; i < count; i++) {
+    TelemetrySnapshot t = TelemetrySnapshot();
+    bool engaged = (i / 60) % 5 == 0;
+    t.sequence = (uint8_t)i;
+    t.sections = TELEMETRY_SECTION_ENDURANCE | (engaged ? TELEMETRY_SECTION_BIRD : 0);
+    t.timeSeconds = i;
+    t.state = engaged ? 2 : 0;
+    t.threat = engaged ? 3 : 0;
+    t.battery = 95.0f - i * 0.03f;
+    t.power = (engaged ? 22.0f : 9.0f) + 0.4f * sinf(i * 1.3f);
+    t.altitude = 120.0f + 3.0f * sinf(i * 0.02f);
+    t.verticalSpeed = 0.06f * cosf(i * 0.02f);
+    t.temperature = 20.0f;
+    t.enduranceSeconds = 5400.0f - i * 2.5f;
+    t.enduranceLowSeconds = 4600.0f - i * 2.5f;
+    t.enduranceHighSeconds = 6200.0f - i * 2.5f;
+    t.birdConfidence = 85;
+    t.birdDistance = 80.0f - (i % 60);
+    t.birdBearing = 20.0f;
+    t.birdSpecies = 1;
+
+    Packet p;
+    p.bytes.resize(TELEMETRY_MAX_FRAME);
+    size_t n = telemetryDeltaEncode(enc, t, &p.bytes[0], p.bytes.size());
+    p.bytes.resize(n);
+    frames.push_back(p);
+    telemetryDeltaOnAck(enc, t.sequence);  // Acks assumed; only the downlink is lossy here
+  }
+  return frames;
+}
+
+// Gilbert-Elliott: loss in the bad state only, mean burst length burstLength
+struct Channel {
+  std::mt19937 rng;
+  double loss;
+  bool bursty;
+  bool bad;
+  Channel(double lossRate, bool isBursty) : rng(7), loss(lossRate), bursty(isBursty), bad(false) {}
+  bool drop() {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    if (!bursty) return u(rng) < loss;
+    const double burstLength = 3.0;
+    double leave = 1.0 / burstLength;
+    double enter = loss > 0.0 ? loss * leave / (1.0 - loss) : 0.0;
+    bad = bad ? u(rng) >= leave : u(rng) < enter;
+    return bad;
+  }
+};
+
+struct Result {
+  double delivered;   // Fraction of data frames at the ground
+  double overhead;    // Parity airtime / data airtime
+  int mismatches;
+};
+
+static Result run(const std::vector<Packet> &frames, int k, int m, double loss, bool bursty) {
+  const LoRaModulation sf10 = {10, 125000, 8};
+  FecEncoder enc;
+  fecEncoderInit(enc, k, m);
+  FecDecoder dec;
+  fecDecoderInit(dec);
+  Channel channel(loss, bursty);
+
+  std::vector<bool> received(frames.size(), false);
+  double dataAirtime = 0, parityAirtime = 0;
+  int mismatches = 0;
+
+  for (size_t i = 0; i < frames.size(); i++) {
+    const Packet &p = frames[i];
+    uint8_t sequence = (uint8_t)i;
+    dataAirtime += loraTimeOnAirMicros(sf10, (uint16_t)p.bytes.size());
+    if (!channel.drop()) {
+      received[i] = true;
+      fecDecoderAddData(dec, sequence, &p.bytes[0], p.bytes.size());
+    }
+    if (!fecEncoderAdd(enc, sequence, &p.bytes[0], p.bytes.size())) continue;
+
+    for (int j = 0; j < m; j++) {
+      uint8_t parity[TELEMETRY_MAX_FRAME + FEC_PARITY_HEADER + 1];
+      size_t n = fecEncoderParity(enc, j, parity, sizeof(parity));
+      parityAirtime += loraTimeOnAirMicros(sf10, (uint16_t)n);
+      if (channel.drop()) continue;
+
+      uint8_t out[FEC_MAX_PARITY][TELEMETRY_MAX_FRAME];
+      uint8_t outSequence[FEC_MAX_PARITY], outLength[FEC_MAX_PARITY];
+      int rebuilt = fecDecoderAddParity(dec, parity, n, out, outSequence, outLength);
+      for (int r = 0; r < rebuilt; r++) {
+        // Map the 8-bit sequence back to the frame index within this group
+        size_t index = i - (uint8_t)(sequence - outSequence[r]);
+        const Packet &sent = frames[index];
+        if (outLength[r] != sent.bytes.size() || memcmp(out[r], &sent.bytes[0], outLength[r]) != 0) {
+          mismatches++;
+          continue;
+        }
+        received[index] = true;
+      }
+    }
+  }
+
+  int delivered = 0;
+  for (size_t i = 0; i < received.size(); i++) delivered += received[i] ? 1 : 0;
+  Result r;
+  r.delivered = (double)delivered / frames.size();
+  r.overhead = parityAirtime / dataAirtime;
+  r.mismatches = mismatches;
+  return r;
+}
+
+int main() {
+  std::vector<Packet> frames = missionFrames(3600);
+  double bytes = 0;
+  for (size_t i = 0; i < frames.size(); i++) bytes += frames[i].bytes.size();
+  printf("Mission: %zu telemetry frames, %.1f B average\n", frames.size(), bytes / frames.size());
+
+  const int shapes[][2] = {{4, 0}, {8, 1}, {4, 1}, {4, 2}, {8, 4}};
+  const double losses[] = {0.0, 0.05, 0.10, 0.20, 0.30};
+  int mismatches = 0;
+  double plain10 = 0, fec10 = 0;
+
+  for (int bursty = 0; bursty < 2; bursty++) {
+    printf("\n%s loss - delivered %% (airtime overhead %%)\n", bursty ? "Bursty" : "Independent");
+    printf("  %-8s", "K+M");
+    for (size_t l = 0; l < sizeof(losses) / sizeof(losses[0]); l++) printf(" %16.0f%%", 100 * losses[l]);
+    printf("\n");
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+      int k = shapes[s][0], m = shapes[s][1];
+      char name[16];
+      snprintf(name, sizeof(name), m ? "%d+%d" : "none", k, m);
+      printf("  %-8s", name);
+      for (size_t l = 0; l < sizeof(losses) / sizeof(losses[0]); l++) {
+        Result r = run(frames, k, m, losses[l], bursty != 0);
+        mismatches += r.mismatches;
+        printf(" %9.1f (%4.0f)", 100 * r.delivered, 100 * r.overhead);
+        if (!bursty && losses[l] == 0.10 && m == 0) plain10 = r.delivered;
+        if (!bursty && losses[l] == 0.10 && k == 4 && m == 1) fec10 = r.delivered;
+      }
+      printf("\n");
+    }
+  }
+
+  double gain10 = fec10 - plain10;
+  bool pass = mismatches == 0 && gain10 > 0.05;
+  printf("\nRebuilt frame mismatches: %d; 4+1 gain at 10%% loss: %.1f points\n", mismatches, 100 * gain10);
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
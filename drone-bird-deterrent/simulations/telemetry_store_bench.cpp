@@ -0,0 +1,293 @@
+/*
+ * Telemetry History Store Benchmark
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Generated fleet history for ground-station/telemetry_store.h: each drone
+ * flies a day of hourly sorties, the first ten minutes of every hour close
+ * in over ESP-NOW at 20Hz and the rest over LoRa at 1Hz with arrival
+ * jitter. Samples go through the telemetry frame codec first so values
+ * are quantised as the ground sees them. The same history is kept as
+ * JSON lines (the old way of replaying it) and sized as ground_ingestd's
+ * .tlm records for comparison.
+ *
+ * Reports ingest rate and bytes per sample, a full scan of one metric,
+ * and three queries against the JSON replay: one hour of altitude, every
+ * sample above a rarely reached altitude, and the power range over six
+ * hours. Checks: every value of every metric re-read bit for bit, and
+ * each query equal to a brute-force answer over the generated samples.
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software -I../ground-station telemetry_store_bench.cpp -o telemetry_store_bench
+ *   ./telemetry_store_bench [drones] [hours]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ftw.h>
+#include <memory>
+
+#include "telemetry_decoder.h"
+#include "telemetry_store.h"
+
+#define CLOSE_IN_S           600      // ESP-NOW phase at the start of each hour
+#define CLOSE_IN_MS          50
+#define LORA_MS              1000
+#define LORA_JITTER_MS       40
+#define ALTITUDE_THRESHOLD   93.0f
+#define JSON_KEY             "\"altitude\":"
+#define TLM_RECORD_HEADER    13       // ground_ingest.h .tlm record, before the frame
+
+struct Fleet {
+  std::vector<int64_t> ms;
+  std::vector<float> values[TS_METRICS];
+  std::vector<std::string> json;
+};
+
+static double nowSeconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static TelemetrySnapshot sampleAt(int drone, int64_t ms) {
+  TelemetrySnapshot t = TelemetrySnapshot();
+  double s = ms / 1000.0;
+  bool engaged = ((int64_t)(s / 45) + drone) % 7 == 0;
+  double sortie = fmod(s, 3600.0);
+  t.type = TELEMETRY_STATUS;
+  t.sections = (engaged ? TELEMETRY_SECTION_BIRD : 0) | TELEMETRY_SECTION_ENDURANCE;
+  t.timeSeconds = (uint32_t)sortie;
+  t.state = engaged ? 2 : 1;
+  t.threat = engaged ? 3 : 0;
+  t.battery = (float)(98.0 - sortie / 45.0);
+  t.power = (float)((engaged ? 22.0 : 9.0) + 0.6 * sin(s / 0.7 + drone));
+  t.altitude = (float)(60.0 + 25.0 * sin(s / 300.0 + drone) + 10.0 * sin(s / 17.0 + drone * 3));
+  t.verticalSpeed = (float)(0.5 * cos(s / 300.0 + drone));
+  t.temperature = (float)(18.0 + 4.0 * sin(s / 20000.0));
+  t.birdConfidence = 85;
+  t.birdDistance = (float)(80.0 - fmod(s, 45.0));
+  t.birdBearing = (float)(20.0 + drone);
+  t.birdSpecies = 1;
+  t.enduranceSeconds = (float)(2400.0 - sortie * 0.6);
+  t.enduranceLowSeconds = t.enduranceSeconds - 120;
+  t.enduranceHighSeconds = t.enduranceSeconds + 120;
+  return t;
+}
+
+static void generate(int drone, int hours, int64_t epochMs, Fleet &f, uint64_t &tlmBytes) {
+  srand(drone + 1);
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  char json[768];
+  for (int64_t hour = 0; hour < hours; hour++) {
+    int64_t start = epochMs + hour * 3600000LL + drone * 7;
+    std::vector<int64_t> times;
+    for (int64_t ms = 0; ms < CLOSE_IN_S * 1000LL; ms += CLOSE_IN_MS) times.push_back(start + ms);
+    for (int64_t ms = CLOSE_IN_S * 1000LL; ms < 3600000LL; ms += LORA_MS) {
+      times.push_back(start + ms + rand() % LORA_JITTER_MS);
+    }
+    for (size_t i = 0; i < times.size(); i++) {
+      TelemetrySnapshot t = sampleAt(drone, times[i]), decoded;
+      size_t length = telemetryEncode(t, frame, sizeof(frame));
+      if (length == 0 || !telemetryDecode(frame, length, decoded)) continue;
+      tlmBytes += TLM_RECORD_HEADER + length;
+      float values[TS_METRICS];
+      tsSnapshotValues(decoded, values);
+      f.ms.push_back(times[i]);
+      for (int m = 0; m < TS_METRICS; m++) f.values[m].push_back(values[m]);
+      int n = snprintf(json, sizeof(json), "{\"ground_ms\":%lld,", (long long)times[i]);
+      telemetryFormatJson(decoded, json + n - 1, sizeof(json) - n + 1);
+      json[n - 1] = ',';
+      f.json.push_back(json);
+    }
+  }
+}
+
+// Depth first, so files go before the directories holding them
+static int removeEntry(const char *path, const struct stat *, int, struct FTW *) {
+  return remove(path);
+}
+
+static void removeTree(const char *dir) {
+  nftw(dir, removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+static bool sameBits(float a, float b) {
+  return tsBits(a) == tsBits(b);
+}
+
+struct Count {
+  uint64_t *n;
+  void operator()(int64_t, float) const { (*n)++; }
+};
+
+struct Sum {
+  double *sum;
+  void operator()(int64_t, float v) const { *sum += v; }
+};
+
+int main(int argc, char **argv) {
+  int drones = argc > 1 ? atoi(argv[1]) : 8;
+  int hours = argc > 2 ? atoi(argv[2]) : 24;
+  int64_t epochMs = 1767225600000LL;  // 2026-01-01 00:00 UTC
+
+  std::vector<Fleet> fleet(drones);
+  uint64_t samples = 0, tlmBytes = 0, jsonBytes = 0;
+  for (int d = 0; d < drones; d++) {
+    generate(d, hours, epochMs, fleet[d], tlmBytes);
+    samples += fleet[d].ms.size();
+    for (size_t i = 0; i < fleet[d].json.size(); i++) jsonBytes += fleet[d].json[i].size() + 1;
+  }
+  printf("%d drones x %d h, %llu samples, %d metrics each\n\n", drones, hours, (unsigned long long)samples,
+         TS_METRICS);
+
+  char dir[] = "/tmp/history_XXXXXX";
+  if (!mkdtemp(dir)) return 1;
+  double start = nowSeconds();
+  uint64_t storeBytes = 0, blocks = 0;
+  bool ok = true;
+  for (int d = 0; d < drones; d++) {
+    std::unique_ptr<TsWriter> w(new TsWriter());
+    char name[16];
+    snprintf(name, sizeof(name), "drone%02d", d);
+    ok = tsWriterOpen(*w, dir, name) && ok;
+    float values[TS_METRICS];
+    for (size_t i = 0; i < fleet[d].ms.size(); i++) {
+      for (int m = 0; m < TS_METRICS; m++) values[m] = fleet[d].values[m][i];
+      ok = tsAppend(*w, fleet[d].ms[i], values) && ok;
+    }
+    ok = tsWriterClose(*w) && ok;
+    storeBytes += w->bytes;
+    blocks += w->blocks;
+  }
+  double ingestSeconds = nowSeconds() - start;
+
+  printf("%-22s %12s %10s\n", "format", "MB", "B/sample");
+  printf("%-22s %12.1f %10.1f\n", "JSON lines", jsonBytes / 1e6, (double)jsonBytes / samples);
+  printf("%-22s %12.1f %10.1f\n", ".tlm records", tlmBytes / 1e6, (double)tlmBytes / samples);
+  printf("%-22s %12.1f %10.1f\n", "history store", storeBytes / 1e6, (double)storeBytes / samples);
+  printf("\ningest %.0f samples/s (%llu blocks, %.2f s)\n", samples / ingestSeconds, (unsigned long long)blocks,
+         ingestSeconds);
+
+  std::vector<TsReader> readers(drones);
+  for (int d = 0; d < drones; d++) {
+    char name[16];
+    snprintf(name, sizeof(name), "drone%02d", d);
+    ok = tsReaderOpen(readers[d], dir, name) && ok;
+  }
+
+  // Every metric of every sample, bit for bit
+  uint64_t mismatches = 0, reread = 0;
+  int64_t ms[TS_BLOCK_SAMPLES];
+  float values[TS_BLOCK_SAMPLES];
+  for (int d = 0; d < drones; d++) {
+    for (int m = 0; m < TS_METRICS; m++) {
+      size_t at = 0;
+      for (size_t b = 0; b < readers[d].blocks.size(); b++) {
+        const TsBlock &block = readers[d].blocks[b];
+        if (!tsDecodeBlock(block, m, ms, values)) {
+          mismatches++;
+          continue;
+        }
+        for (int s = 0; s < block.count && at < fleet[d].ms.size(); s++, at++) {
+          if (ms[s] != fleet[d].ms[at] || !sameBits(values[s], fleet[d].values[m][at])) mismatches++;
+        }
+      }
+      if (m == 0) reread += at;
+      if (at != fleet[d].ms.size()) mismatches++;
+    }
+  }
+
+  // Full scan of one metric
+  TsQueryStats stats;
+  double sum = 0;
+  start = nowSeconds();
+  for (int d = 0; d < drones; d++) {
+    Sum visit = {&sum};
+    tsQuery(readers[d], TS_ALTITUDE, INT64_MIN, INT64_MAX, TsAnyBlock(), TsAnyValue(), visit, stats);
+  }
+  double scanSeconds = nowSeconds() - start;
+  printf("full altitude scan %.1fM samples/s (%.3f s, mean %.2f m)\n\n", samples / scanSeconds / 1e6, scanSeconds,
+         sum / samples);
+
+  printf("%-26s %12s %12s %10s %16s\n", "query (all drones)", "store ms", "JSON ms", "results", "blocks decoded");
+  int64_t hourFrom = epochMs + (hours / 2) * 3600000LL + 1800000LL, hourTo = hourFrom + 3600000LL;
+  int64_t sixFrom = epochMs + 3600000LL + 123456, sixTo = sixFrom + 6 * 3600000LL;
+  int mismatchedQueries = 0;
+  for (int q = 0; q < 3; q++) {
+    const char *label = q == 0 ? "altitude, 1 h" : q == 1 ? "altitude > threshold" : "power min/max, 6 h";
+    uint64_t results = 0, decoded = 0, total = 0, expected = 0;
+    float lo = INFINITY, hi = -INFINITY;
+    start = nowSeconds();
+    for (int d = 0; d < drones; d++) {
+      Count visit = {&results};
+      if (q == 0) {
+        tsQuery(readers[d], TS_ALTITUDE, hourFrom, hourTo, TsAnyBlock(), TsAnyValue(), visit, stats);
+      } else if (q == 1) {
+        TsBlockAbove keep = {ALTITUDE_THRESHOLD};
+        TsValueAbove accept = {ALTITUDE_THRESHOLD};
+        tsQuery(readers[d], TS_ALTITUDE, INT64_MIN, INT64_MAX, keep, accept, visit, stats);
+      } else {
+        float l, h;
+        if (tsRangeMinMax(readers[d], TS_POWER, sixFrom, sixTo, l, h, stats)) {
+          lo = std::min(lo, l);
+          hi = std::max(hi, h);
+        }
+      }
+      decoded += stats.blocksDecoded;
+      total += readers[d].blocks.size();
+    }
+    double storeSeconds = nowSeconds() - start;
+
+    // The same over JSON lines, as replaying the old logs did
+    uint64_t jsonResults = 0;
+    float jsonLo = INFINITY, jsonHi = -INFINITY;
+    const char *key = q == 2 ? "\"power\":" : JSON_KEY;
+    start = nowSeconds();
+    for (int d = 0; d < drones; d++) {
+      for (size_t i = 0; i < fleet[d].json.size(); i++) {
+        const char *line = fleet[d].json[i].c_str();
+        int64_t t = strtoll(line + 13, NULL, 10);
+        float v = (float)strtod(strstr(line, key) + strlen(key), NULL);
+        if (q == 0 && t >= hourFrom && t < hourTo) jsonResults++;
+        if (q == 1 && v > ALTITUDE_THRESHOLD) jsonResults++;
+        if (q == 2 && t >= sixFrom && t < sixTo) {
+          jsonLo = std::min(jsonLo, v);
+          jsonHi = std::max(jsonHi, v);
+        }
+      }
+    }
+    double jsonSeconds = nowSeconds() - start;
+
+    // Brute force over the generated samples
+    float bruteLo = INFINITY, bruteHi = -INFINITY;
+    for (int d = 0; d < drones; d++) {
+      for (size_t i = 0; i < fleet[d].ms.size(); i++) {
+        int64_t t = fleet[d].ms[i];
+        if (q == 0 && t >= hourFrom && t < hourTo) expected++;
+        if (q == 1 && fleet[d].values[TS_ALTITUDE][i] > ALTITUDE_THRESHOLD) expected++;
+        if (q == 2 && t >= sixFrom && t < sixTo) {
+          bruteLo = std::min(bruteLo, fleet[d].values[TS_POWER][i]);
+          bruteHi = std::max(bruteHi, fleet[d].values[TS_POWER][i]);
+        }
+      }
+    }
+    bool match = q < 2 ? results == expected && jsonResults == expected
+                       : sameBits(lo, bruteLo) && sameBits(hi, bruteHi) && fabsf(jsonHi - hi) < 0.06f;
+    if (q == 2) results = 2;
+    if (!match) mismatchedQueries++;
+    char blocksText[32];
+    snprintf(blocksText, sizeof(blocksText), "%llu/%llu", (unsigned long long)decoded, (unsigned long long)total);
+    printf("%-26s %12.2f %12.2f %10llu %16s%s\n", label, storeSeconds * 1000, jsonSeconds * 1000,
+           (unsigned long long)results, blocksText, match ? "" : "  MISMATCH");
+  }
+
+  for (int d = 0; d < drones; d++) tsReaderClose(readers[d]);
+  removeTree(dir);
+  bool pass = ok && mismatches == 0 && reread == samples && mismatchedQueries == 0;
+  if (!pass) {
+    printf("\n%llu/%llu samples re-read, %llu value mismatches, %d query mismatches%s\n", (unsigned long long)reread,
+           (unsigned long long)samples, (unsigned long long)mismatches, mismatchedQueries, ok ? "" : ", I/O errors");
+  }
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
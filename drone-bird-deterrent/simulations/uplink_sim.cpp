@@ -0,0 +1,317 @@
+/*
+ * Uplink Command Channel Simulation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Host stand-in for the two LoRa radios. The drone side sends 1Hz
+ * telemetry (software/telemetry_delta.h) and listens only in the receive
+ * window after each packet, sized as in esp32_main_controller.cpp; the
+ * ground side acks each frame it hears, appends the command it is trying
+ * to deliver (software/lora_uplink.h), and repeats it until a telemetry
+ * frame acknowledges it. A downlink only lands if it is not lost and ends
+ * inside the drone's window.
+ *
+ * Checks, per loss rate:
+ *   - every command is applied exactly once, in order
+ *   - with no loss, each command is acknowledged in the very next frame
+ *   - forged, tampered and replayed frames are never applied
+ *   - a ground station that restarts between commands, forgetting its
+ *     counter, resynchronises from the STALE ack (a command in flight at
+ *     the restart could be applied twice - the ground must log what it
+ *     sent)
+ *
+ * Build & run:
+ *   g++ -O2 -std=c++11 -I../software uplink_sim.cpp -o uplink_sim
+ *   ./uplink_sim
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "lora_airtime.h"
+#include "lora_link_adapter.h"
+#include "lora_uplink.h"
+#include "telemetry_delta.h"
+
+// As esp32_main_controller.cpp
+#define LORA_RX_TURNAROUND_MS     60
+#define LORA_RX_MARGIN_MS         40
+
+static const LoRaModulation SF10 = {10, 125000, 8};
+static const uint8_t KEY[UPLINK_KEY_LENGTH] = {0x3a, 0x91, 0x07, 0xc4, 0x5e, 0x12, 0xf8, 0x66,
+                                               0x2d, 0xb0, 0x49, 0x7f, 0x81, 0x35, 0xe2, 0x9c};
+
+// Half-duplex link: a packet arrives if it survives loss and the receiver
+// is listening for all of it
+struct StandInRadio {
+  std::mt19937 rng;
+  double loss;
+  uint32_t sent, lost, missedWindow;
+  explicit StandInRadio(double lossRate) : rng(11), loss(lossRate), sent(0), lost(0), missedWindow(0) {}
+
+  bool deliver(double startMs, double airtimeMs, double listenFromMs, double listenToMs) {
+    sent++;
+    if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < loss) {
+      lost++;
+      return false;
+    }
+    if (startMs < listenFromMs || startMs + airtimeMs > listenToMs) {
+      missedWindow++;
+      return false;
+    }
+    return true;
+  }
+};
+
+// Drone: the parts of the controller the uplink touches
+struct Drone {
+  TelemetryDeltaEncoder delta;
+  UplinkReceiver uplink;
+  uint8_t sequence;
+  bool ackPending;
+  uint16_t ackCounter;
+  uint8_t ackResult;
+  std::vector<uint16_t> applied;  // Counters in the order they took effect
+  int threatScoreHigh;
+
+  Drone() : sequence(0), ackPending(false), ackCounter(0), ackResult(UPLINK_OK), threatScoreHigh(50) {
+    telemetryDeltaInit(delta);
+    uplinkReceiverInit(uplink, KEY, 0);
+  }
+
+  size_t frame(uint32_t second, uint8_t *buffer) {
+    TelemetrySnapshot t = TelemetrySnapshot();
+    t.sequence = sequence++;
+    t.timeSeconds = second;
+    t.battery = 90.0f - second * 0.01f;
+    t.power = 9.0f;
+    t.altitude = 120.0f;
+    t.temperature = 20.0f;
+    if (ackPending) {
+      t.sections |= TELEMETRY_SECTION_COMMAND;
+      t.commandCounter = ackCounter;
+      t.commandResult = ackResult;
+      ackPending = false;
+    }
+    return telemetryDeltaEncode(delta, t, buffer, TELEMETRY_MAX_FRAME);
+  }
+
+  void downlink(const uint8_t *packet, size_t length) {
+    LinkAck ack;
+    if (length >= LINK_ACK_LENGTH && linkAckDecode(packet, LINK_ACK_LENGTH, ack)) {
+      telemetryDeltaOnAck(delta, ack.sequence);
+    }
+    if (length != LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH) return;
+
+    UplinkCommand cmd;
+    switch (uplinkReceive(uplink, packet + LINK_ACK_LENGTH, UPLINK_COMMAND_LENGTH, cmd)) {
+      case UPLINK_IGNORE:
+        return;
+      case UPLINK_APPLY: {
+        uint8_t result = uplinkValidate(cmd);
+        if (result == UPLINK_OK) {
+          applied.push_back(cmd.counter);
+          if (cmd.opcode == UPLINK_SET_PARAM && cmd.parameter == UPLINK_PARAM_THREAT_HIGH) {
+            threatScoreHigh = cmd.value;
+          }
+        }
+        uplinkReceiverDone(uplink, result);
+        ackResult = result;
+        break;
+      }
+      case UPLINK_ACK_REPEAT:
+        ackResult = uplink.lastResult;
+        break;
+      case UPLINK_ACK_STALE:
+        ackResult = UPLINK_STALE;
+        break;
+    }
+    ackCounter = uplink.lastCounter;
+    ackPending = true;
+  }
+};
+
+// Ground: acks telemetry and delivers one command at a time
+struct Ground {
+  TelemetryDeltaDecoder decoder;
+  uint16_t counter;                // Next counter to sign with
+  int next;                        // Index of the command being delivered
+  int total;
+  uint8_t frame[UPLINK_COMMAND_LENGTH];
+  bool signedFrame;
+  uint32_t firstSentCycle;
+  std::vector<uint32_t> latencyCycles;
+  uint32_t resyncs;
+  uint8_t attack[UPLINK_COMMAND_LENGTH];  // Injected instead of the real command
+  bool attackPending;
+  bool attackSent;                 // Last reply carried the attack
+  bool restartPending;             // Forget the counter once idle
+
+  explicit Ground(int commands) : counter(1), next(0), total(commands), signedFrame(false),
+                                  firstSentCycle(0), resyncs(0), attackPending(false),
+                                  attackSent(false), restartPending(false) {
+    telemetryDeltaDecoderInit(decoder);
+  }
+
+  UplinkCommand command(int index) const {
+    UplinkCommand cmd;
+    cmd.counter = counter;
+    cmd.opcode = UPLINK_SET_PARAM;
+    cmd.parameter = UPLINK_PARAM_THREAT_HIGH;
+    cmd.value = (int16_t)(40 + index % 50);
+    return cmd;
+  }
+
+  // Reply to a telemetry frame heard in cycle `cycle`
+  size_t reply(const uint8_t *packet, size_t length, uint32_t cycle, uint8_t *out) {
+    TelemetrySnapshot t = TelemetrySnapshot();
+    if (!telemetryDeltaDecode(decoder, packet, length, t)) return 0;
+
+    // The drone's last accepted counter being ours means it took effect,
+    // even if a replayed frame got it reported as STALE since
+    if ((t.sections & TELEMETRY_SECTION_COMMAND) && signedFrame) {
+      if (t.commandResult == UPLINK_STALE && t.commandCounter > counter) {
+        counter = (uint16_t)(t.commandCounter + 1);  // Restarted ground: jump past the drone
+        signedFrame = false;
+        resyncs++;
+      } else if (t.commandCounter == counter) {
+        latencyCycles.push_back(cycle - firstSentCycle);
+        counter++;
+        next++;
+        signedFrame = false;
+      }
+    }
+
+    if (restartPending && !signedFrame) {
+      counter = 1;
+      restartPending = false;
+    }
+
+    LinkAck ack;
+    ack.sequence = t.sequence;
+    ack.rssi = -110;
+    ack.snr = 2.0f;
+    size_t n = linkAckEncode(ack, out);
+    attackSent = attackPending;
+    if (attackPending) {
+      memcpy(out + n, attack, UPLINK_COMMAND_LENGTH);
+      attackPending = false;
+      return n + UPLINK_COMMAND_LENGTH;
+    }
+    if (next >= total) return n;
+    if (!signedFrame) {
+      uplinkEncode(command(next), KEY, frame);
+      signedFrame = true;
+      firstSentCycle = cycle;
+    }
+    memcpy(out + n, frame, UPLINK_COMMAND_LENGTH);
+    return n + UPLINK_COMMAND_LENGTH;
+  }
+};
+
+struct Outcome {
+  bool exactlyOnce;
+  double meanCycles;
+  uint32_t maxCycles;
+  double nextFrameShare;           // Acked in the frame right after delivery
+  uint32_t attacksApplied;
+  uint32_t resyncs;
+  uint32_t missedWindow;
+};
+
+static Outcome run(double loss, int commands) {
+  Drone drone;
+  Ground ground(commands);
+  StandInRadio radio(loss);
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<int> turnaround(10, LORA_RX_TURNAROUND_MS);
+  std::vector<std::vector<uint8_t> > delivered;  // Captured for replay
+  uint32_t attacksApplied = 0;
+
+  for (uint32_t cycle = 0; cycle < 20000 && ground.next < commands; cycle++) {
+    double t0 = cycle * 1000.0;
+    uint8_t up[TELEMETRY_MAX_FRAME];
+    size_t upLength = drone.frame(cycle, up);
+    double upAirtime = loraTimeOnAirMicros(SF10, (uint16_t)upLength) / 1000.0;
+
+    // Drone window opens when its TX completes
+    double windowOpen = t0 + upAirtime;
+    double windowMs = LORA_RX_TURNAROUND_MS + LORA_RX_MARGIN_MS +
+                      loraTimeOnAirMicros(SF10, LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH) / 1000.0;
+    if (!radio.deliver(t0, upAirtime, t0, t0 + upAirtime)) continue;
+
+    // Every 50 cycles try something hostile in place of the real command
+    if (cycle % 50 == 25) {
+      ground.attackPending = true;
+      int kind = (cycle / 50) % 3;
+      if (kind == 0 || delivered.empty()) {
+        uint8_t wrongKey[UPLINK_KEY_LENGTH] = {0};
+        UplinkCommand forged = ground.command(0);
+        forged.counter = 0xFFF0;
+        uplinkEncode(forged, wrongKey, ground.attack);
+      } else if (kind == 1) {
+        uplinkEncode(ground.command(ground.next), KEY, ground.attack);
+        ground.attack[6] ^= 0x01;  // Tampered value
+      } else {
+        memcpy(ground.attack, &delivered[delivered.size() / 2][0], UPLINK_COMMAND_LENGTH);
+      }
+    }
+
+    uint8_t down[LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH];
+    size_t downLength = ground.reply(up, upLength, cycle, down);
+    if (downLength == 0) continue;
+    double downStart = windowOpen + turnaround(rng);
+    double downAirtime = loraTimeOnAirMicros(SF10, (uint16_t)downLength) / 1000.0;
+    if (!radio.deliver(downStart, downAirtime, windowOpen, windowOpen + windowMs)) continue;
+
+    size_t before = drone.applied.size();
+    drone.downlink(down, downLength);
+    if (ground.attackSent && drone.applied.size() != before) attacksApplied++;
+    if (!ground.attackSent && downLength > LINK_ACK_LENGTH) {
+      delivered.push_back(std::vector<uint8_t>(down + LINK_ACK_LENGTH, down + downLength));
+    }
+
+    if (cycle == 400) ground.restartPending = true;
+  }
+
+  Outcome o;
+  o.exactlyOnce = (int)drone.applied.size() == commands;
+  for (size_t i = 1; i < drone.applied.size(); i++) o.exactlyOnce &= drone.applied[i] > drone.applied[i - 1];
+  double sum = 0;
+  uint32_t nextFrame = 0;
+  o.maxCycles = 0;
+  for (size_t i = 0; i < ground.latencyCycles.size(); i++) {
+    sum += ground.latencyCycles[i];
+    if (ground.latencyCycles[i] > o.maxCycles) o.maxCycles = ground.latencyCycles[i];
+    if (ground.latencyCycles[i] == 1) nextFrame++;
+  }
+  o.meanCycles = ground.latencyCycles.empty() ? 0 : sum / ground.latencyCycles.size();
+  o.nextFrameShare = ground.latencyCycles.empty() ? 0 : (double)nextFrame / ground.latencyCycles.size();
+  o.attacksApplied = attacksApplied;
+  o.resyncs = ground.resyncs;
+  o.missedWindow = radio.missedWindow;
+  return o;
+}
+
+int main() {
+  const int commands = 500;
+  const double losses[] = {0.0, 0.05, 0.10, 0.20, 0.30};
+  bool pass = true;
+
+  printf("%d commands at SF10, 1Hz telemetry, downlink window %.0f ms\n\n", commands,
+         LORA_RX_TURNAROUND_MS + LORA_RX_MARGIN_MS +
+             loraTimeOnAirMicros(SF10, LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH) / 1000.0);
+  printf("Loss   Once  Latency avg/max (cycles)  Next frame  Attacks applied  Resyncs  Missed window\n");
+  for (size_t i = 0; i < sizeof(losses) / sizeof(losses[0]); i++) {
+    Outcome o = run(losses[i], commands);
+    printf("%3.0f%%   %-4s  %10.2f / %-10u  %9.0f%%  %15u  %7u  %13u\n", 100 * losses[i],
+           o.exactlyOnce ? "yes" : "NO", o.meanCycles, o.maxCycles, 100 * o.nextFrameShare,
+           o.attacksApplied, o.resyncs, o.missedWindow);
+    pass &= o.exactlyOnce && o.attacksApplied == 0 && o.missedWindow == 0 && o.resyncs == 1;
+    if (losses[i] == 0.0) pass &= o.nextFrameShare == 1.0;
+  }
+
+  printf("\n%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
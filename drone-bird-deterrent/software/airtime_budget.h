@@ -0,0 +1,95 @@
+/*
+ * LoRa Airtime Budget
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Sliding-window airtime accounting against regulatory limits: a maximum
+ * time on air per transmission (dwell) and a maximum total time on air in
+ * any window. The window is kept as AIRTIME_BUCKETS slots of window /
+ * AIRTIME_BUCKETS each, so usage is exact to one slot and memory is fixed.
+ * Packet airtime comes from lora_airtime.h.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef AIRTIME_BUDGET_H
+#define AIRTIME_BUDGET_H
+
+#include <stdint.h>
+
+#include "lora_airtime.h"
+
+#define AIRTIME_BUCKETS   20
+
+struct AirtimeBudget {
+  unsigned long bucketMs;
+  uint32_t limitMicros;           // Per window
+  uint32_t maxDwellMicros;        // Per transmission
+  uint32_t buckets[AIRTIME_BUCKETS];
+  int current;
+  unsigned long bucketStart;
+  uint32_t usedMicros;            // Sum of buckets
+  uint32_t peakMicros;            // Highest window usage seen
+  uint32_t delayed;               // Sends held back for budget
+  uint32_t shrunk;                // Sends trimmed to fit
+  uint32_t clamped;               // Sends moved to a faster SF to fit dwell / share
+};
+
+inline void airtimeBudgetInit(AirtimeBudget &b, unsigned long windowMs, uint32_t limitMicros,
+                              uint32_t maxDwellMicros, unsigned long nowMs) {
+  b.bucketMs = windowMs / AIRTIME_BUCKETS;
+  b.limitMicros = limitMicros;
+  b.maxDwellMicros = maxDwellMicros;
+  for (int i = 0; i < AIRTIME_BUCKETS; i++) b.buckets[i] = 0;
+  b.current = 0;
+  b.bucketStart = nowMs;
+  b.usedMicros = 0;
+  b.peakMicros = 0;
+  b.delayed = b.shrunk = b.clamped = 0;
+}
+
+// Expire slots that have left the window
+inline void airtimeBudgetAdvance(AirtimeBudget &b, unsigned long nowMs) {
+  int steps = 0;
+  while (nowMs - b.bucketStart >= b.bucketMs && steps < AIRTIME_BUCKETS) {
+    b.current = (b.current + 1) % AIRTIME_BUCKETS;
+    b.usedMicros -= b.buckets[b.current];
+    b.buckets[b.current] = 0;
+    b.bucketStart += b.bucketMs;
+    steps++;
+  }
+  if (steps == AIRTIME_BUCKETS) b.bucketStart = nowMs;  // Idle for a whole window
+}
+
+// True if airtimeMicros fits, keeping reserveFraction of the limit free
+inline bool airtimeBudgetAllows(const AirtimeBudget &b, uint32_t airtimeMicros, float reserveFraction) {
+  if (airtimeMicros > b.maxDwellMicros) return false;
+  return b.usedMicros + airtimeMicros <= (uint32_t)(b.limitMicros * (1.0f - reserveFraction));
+}
+
+inline void airtimeBudgetRecord(AirtimeBudget &b, unsigned long nowMs, uint32_t airtimeMicros) {
+  airtimeBudgetAdvance(b, nowMs);
+  b.buckets[b.current] += airtimeMicros;
+  b.usedMicros += airtimeMicros;
+  if (b.usedMicros > b.peakMicros) b.peakMicros = b.usedMicros;
+}
+
+// Fraction of the window limit in use
+inline float airtimeBudgetUsage(const AirtimeBudget &b) {
+  return b.limitMicros ? (float)b.usedMicros / b.limitMicros : 0.0f;
+}
+
+// Slowest SF, no slower than spreadingFactor, at which the payload could
+// go at all with reserveFraction of the limit kept back: within the dwell
+// limit and within the rest of an empty window (SF7 if nothing fits). A
+// packet priced at a slower SF would wait for budget that never comes.
+inline uint8_t airtimeShareSpreadingFactor(const AirtimeBudget &b, LoRaModulation mod, uint16_t payloadBytes,
+                                           float reserveFraction) {
+  uint32_t capMicros = (uint32_t)(b.limitMicros * (1.0f - reserveFraction));
+  if (capMicros > b.maxDwellMicros) capMicros = b.maxDwellMicros;
+  while (mod.spreadingFactor > 7 && loraTimeOnAirMicros(mod, payloadBytes) > capMicros) {
+    mod.spreadingFactor--;
+  }
+  return mod.spreadingFactor;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Altitude / Vertical Speed Estimator
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Third-order complementary filter fusing earth-frame vertical acceleration
+ * (IMU rate) with barometric altitude (baro rate). The accelerometer drives
+ * the short-term response, the barometer anchors the long-term altitude and
+ * an accelerometer bias term absorbs residual tilt / offset errors.
+ *
+ * Plain C++ with no Arduino dependencies so the same code runs on the
+ * ESP32 and in the host simulations (simulations/altitude_filter_sim.cpp).
+ * Cost per call is a fixed handful of float operations.
+ */
+
+#ifndef ALTITUDE_ESTIMATOR_H
+#define ALTITUDE_ESTIMATOR_H
+
+// Default filter time constant (seconds). Shorter trusts the baro more.
+#define ALTITUDE_FILTER_TAU        1.5f
+// Reject baro innovations larger than this (m) - gusts / prop wash spikes
+#define ALTITUDE_INNOVATION_LIMIT  5.0f
+// Clamp on the learned accelerometer bias (m/s^2)
+#define ALTITUDE_BIAS_LIMIT        1.0f
+
+struct AltitudeEstimator {
+  float altitude;        // m, fused
+  float verticalSpeed;   // m/s, positive up
+  float accelBias;       // m/s^2, added to measured vertical accel
+  float baroAltitude;    // m, last barometer sample
+  float k1, k2, k3;      // complementary filter gains
+  bool initialized;
+};
+
+inline void altitudeEstimatorInit(AltitudeEstimator &est, float timeConstant = ALTITUDE_FILTER_TAU) {
+  est.altitude = 0.0f;
+  est.verticalSpeed = 0.0f;
+  est.accelBias = 0.0f;
+  est.baroAltitude = 0.0f;
+  est.k1 = 3.0f / timeConstant;
+  est.k2 = 3.0f / (timeConstant * timeConstant);
+  est.k3 = 1.0f / (timeConstant * timeConstant * timeConstant);
+  est.initialized = false;
+}
+
+// Latch a new barometer sample. The first sample seeds the filter state.
+inline void altitudeEstimatorCorrect(AltitudeEstimator &est, float baroAltitude) {
+  est.baroAltitude = baroAltitude;
+  if (!est.initialized) {
+    est.altitude = baroAltitude;
+    est.verticalSpeed = 0.0f;
+    est.accelBias = 0.0f;
+    est.initialized = true;
+  }
+}
+
+// Propagate one IMU step. verticalAccel is earth-frame, gravity removed,
+// positive up (m/s^2); dt in seconds.
+inline void altitudeEstimatorPredict(AltitudeEstimator &est, float verticalAccel, float dt) {
+  if (!est.initialized || dt <= 0.0f) return;
+
+  float error = est.baroAltitude - est.altitude;
+  if (error > ALTITUDE_INNOVATION_LIMIT) error = ALTITUDE_INNOVATION_LIMIT;
+  if (error < -ALTITUDE_INNOVATION_LIMIT) error = -ALTITUDE_INNOVATION_LIMIT;
+
+  est.accelBias += est.k3 * error * dt;
+  if (est.accelBias > ALTITUDE_BIAS_LIMIT) est.accelBias = ALTITUDE_BIAS_LIMIT;
+  if (est.accelBias < -ALTITUDE_BIAS_LIMIT) est.accelBias = -ALTITUDE_BIAS_LIMIT;
+
+  est.verticalSpeed += (verticalAccel + est.accelBias + est.k2 * error) * dt;
+  est.altitude += (est.verticalSpeed + est.k1 * error) * dt;
+}
+
+#endif
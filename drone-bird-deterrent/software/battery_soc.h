@@ -0,0 +1,137 @@
+/*
+ * Battery State-of-Charge Estimator
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Coulomb counting on the measured pack current, pulled towards the 3S LiPo
+ * open-circuit-voltage curve only during low-load periods, when the
+ * IR-compensated terminal voltage is a trustworthy OCV estimate. The pack
+ * internal resistance is learned from load steps (strobes / audio switching).
+ *
+ * Plain C++ with no Arduino dependencies so the host simulation
+ * (simulations/soc_estimator_sim.cpp) runs the same code.
+ */
+
+#ifndef BATTERY_SOC_H
+#define BATTERY_SOC_H
+
+#define BATTERY_CELLS               3
+#define BATTERY_CAPACITY_AH         3.0f
+#define BATTERY_INTERNAL_RESISTANCE 0.06f   // Ohm, pack, initial guess
+
+#define SOC_REST_CURRENT            1.0f    // A, below this counts as low load
+#define SOC_REST_SECONDS            30.0f   // Low load time before OCV correction
+#define SOC_OCV_TIME_CONSTANT       120.0f  // s, blend towards the OCV curve
+#define SOC_OCV_MIN_SLOPE           0.003f  // Cell V per % - ignore the flat region
+#define SOC_RESISTANCE_STEP         1.0f    // A, current step used to learn R
+#define SOC_RESISTANCE_GAIN         0.05f
+#define SOC_RESISTANCE_MIN          0.005f
+#define SOC_RESISTANCE_MAX          0.5f
+
+// LiPo cell open-circuit voltage at 0, 5, ... 100 % SoC
+static const float LIPO_OCV_TABLE[21] = {
+  3.27f, 3.61f, 3.69f, 3.71f, 3.73f, 3.75f, 3.77f, 3.79f, 3.80f, 3.82f, 3.84f,
+  3.85f, 3.87f, 3.91f, 3.95f, 3.98f, 4.02f, 4.08f, 4.11f, 4.15f, 4.20f
+};
+
+struct BatterySocEstimator {
+  float soc;                 // 0..1
+  float capacityAh;
+  float internalResistance;  // Ohm, learned
+  float restSeconds;         // Time spent below SOC_REST_CURRENT
+  float lastVoltage, lastCurrent;
+  float chargeUsedAh;        // Since boot
+  bool initialized;
+};
+
+// Cell OCV -> SoC (0..1), linear between table points
+inline float batteryOcvToSoc(float cellVoltage) {
+  if (cellVoltage <= LIPO_OCV_TABLE[0]) return 0.0f;
+  if (cellVoltage >= LIPO_OCV_TABLE[20]) return 1.0f;
+  int i = 0;
+  while (cellVoltage > LIPO_OCV_TABLE[i + 1]) i++;
+  float frac = (cellVoltage - LIPO_OCV_TABLE[i]) / (LIPO_OCV_TABLE[i + 1] - LIPO_OCV_TABLE[i]);
+  return (i + frac) * 0.05f;
+}
+
+// SoC (0..1) -> cell OCV
+inline float batterySocToOcv(float soc) {
+  if (soc <= 0.0f) return LIPO_OCV_TABLE[0];
+  if (soc >= 1.0f) return LIPO_OCV_TABLE[20];
+  int i = (int)(soc * 20.0f);
+  float frac = soc * 20.0f - i;
+  return LIPO_OCV_TABLE[i] + frac * (LIPO_OCV_TABLE[i + 1] - LIPO_OCV_TABLE[i]);
+}
+
+inline void batterySocInit(BatterySocEstimator &est, float capacityAh = BATTERY_CAPACITY_AH,
+                           float internalResistance = BATTERY_INTERNAL_RESISTANCE) {
+  est.soc = 0.0f;
+  est.capacityAh = capacityAh;
+  est.internalResistance = internalResistance;
+  est.restSeconds = 0.0f;
+  est.lastVoltage = 0.0f;
+  est.lastCurrent = 0.0f;
+  est.chargeUsedAh = 0.0f;
+  est.initialized = false;
+}
+
+// Start from a known SoC (e.g. restored after a reboot)
+inline void batterySocSeed(BatterySocEstimator &est, float soc) {
+  est.soc = soc < 0.0f ? 0.0f : (soc > 1.0f ? 1.0f : soc);
+  est.initialized = true;
+}
+
+// SoC implied by the terminal voltage with the IR drop added back
+inline float batterySocFromVoltage(const BatterySocEstimator &est, float packVoltage, float packCurrent) {
+  float ocv = packVoltage + packCurrent * est.internalResistance;
+  return batteryOcvToSoc(ocv / BATTERY_CELLS);
+}
+
+// packCurrent positive when discharging (A); dt in seconds
+inline void batterySocUpdate(BatterySocEstimator &est, float packVoltage, float packCurrent, float dt) {
+  if (!est.initialized) {
+    est.soc = batterySocFromVoltage(est, packVoltage, packCurrent);
+    est.initialized = true;
+    est.lastVoltage = packVoltage;
+    est.lastCurrent = packCurrent;
+    return;
+  }
+  if (dt <= 0.0f) return;
+
+  // Learn internal resistance from load steps
+  float deltaI = packCurrent - est.lastCurrent;
+  if (deltaI > SOC_RESISTANCE_STEP || deltaI < -SOC_RESISTANCE_STEP) {
+    float r = -(packVoltage - est.lastVoltage) / deltaI;
+    if (r > SOC_RESISTANCE_MIN && r < SOC_RESISTANCE_MAX) {
+      est.internalResistance += SOC_RESISTANCE_GAIN * (r - est.internalResistance);
+    }
+  }
+  est.lastVoltage = packVoltage;
+  est.lastCurrent = packCurrent;
+
+  // Coulomb counting
+  float chargeAh = packCurrent * dt / 3600.0f;
+  est.chargeUsedAh += chargeAh;
+  est.soc -= chargeAh / est.capacityAh;
+
+  // OCV correction once the pack has relaxed under low load, and only where
+  // the curve is steep enough for voltage to resolve SoC
+  if (packCurrent < SOC_REST_CURRENT && packCurrent > -SOC_REST_CURRENT) {
+    est.restSeconds += dt;
+  } else {
+    est.restSeconds = 0.0f;
+  }
+  if (est.restSeconds >= SOC_REST_SECONDS) {
+    float target = batterySocFromVoltage(est, packVoltage, packCurrent);
+    float slope = (batterySocToOcv(target + 0.025f) - batterySocToOcv(target - 0.025f)) / 5.0f;
+    if (slope >= SOC_OCV_MIN_SLOPE) {
+      float alpha = dt / SOC_OCV_TIME_CONSTANT;
+      if (alpha > 1.0f) alpha = 1.0f;
+      est.soc += alpha * (target - est.soc);
+    }
+  }
+
+  if (est.soc < 0.0f) est.soc = 0.0f;
+  if (est.soc > 1.0f) est.soc = 1.0f;
+}
+
+#endif
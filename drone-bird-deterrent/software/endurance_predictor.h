@@ -0,0 +1,130 @@
+/*
+ * Remaining Endurance Predictor
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Keeps a rolling (exponential) mean and variance of pack current for each
+ * SystemState plus the recent fraction of time spent in each state, and
+ * predicts the time and range left before the mission reserve is reached:
+ *
+ *   expected current  I = sum(duty[s] * mean[s])
+ *   time remaining    t = (usable Ah) / I
+ *
+ * Bounds are scenario based: the pessimistic case adds two standard errors
+ * to every state mean, shifts DUTY_MARGIN of standby time into ACTIVE and
+ * takes SOC_UNCERTAINTY off the charge; the optimistic case does the reverse.
+ * One update costs a few dozen float operations.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef ENDURANCE_PREDICTOR_H
+#define ENDURANCE_PREDICTOR_H
+
+#include <math.h>
+
+#define ENDURANCE_STATES           4       // SystemState count
+#define ENDURANCE_STANDBY_STATE    0
+#define ENDURANCE_ACTIVE_STATE     2
+#define ENDURANCE_CURRENT_TAU      60.0f   // s, per-state current averaging
+#define ENDURANCE_DUTY_TAU         600.0f  // s, state duty averaging
+#define ENDURANCE_DUTY_MARGIN      0.10f   // Standby time moved to ACTIVE in bounds
+#define ENDURANCE_SOC_UNCERTAINTY  0.03f   // Fraction of capacity
+#define ENDURANCE_MIN_CURRENT      0.05f   // A, avoid divide by zero
+#define ENDURANCE_DETERRENT_CURRENT 1.5f   // A, prior for ACTIVE before it is seen
+
+struct EndurancePredictor {
+  float meanCurrent[ENDURANCE_STATES];   // A
+  float varCurrent[ENDURANCE_STATES];    // A^2
+  float samples[ENDURANCE_STATES];       // Effective sample count, capped by tau
+  float duty[ENDURANCE_STATES];          // Recent fraction of time per state
+  float expectedCurrent;                 // A
+  float timeRemaining;                   // s to reserve, central estimate
+  float timeLow, timeHigh;               // s, confidence bounds
+  float rangeRemaining, rangeLow, rangeHigh;  // m
+};
+
+inline void endurancePredictorInit(EndurancePredictor &pred) {
+  for (int s = 0; s < ENDURANCE_STATES; s++) {
+    pred.meanCurrent[s] = 0.0f;
+    pred.varCurrent[s] = 0.0f;
+    pred.samples[s] = 0.0f;
+    pred.duty[s] = 0.0f;
+  }
+  pred.duty[ENDURANCE_STANDBY_STATE] = 1.0f;
+  pred.expectedCurrent = 0.0f;
+  pred.timeRemaining = pred.timeLow = pred.timeHigh = 0.0f;
+  pred.rangeRemaining = pred.rangeLow = pred.rangeHigh = 0.0f;
+}
+
+// Current drawn for the mixed duty, with each state mean shifted by
+// meanShift standard errors and dutyShift moved from STANDBY to ACTIVE
+inline float endurancePredictorCurrent(const EndurancePredictor &pred, float meanShift, float dutyShift) {
+  // States never seen yet borrow from the known ones: ACTIVE assumes the
+  // highest observed mean plus the nominal deterrent draw, others the lowest
+  float highest = 0.0f, lowest = 0.0f;
+  bool any = false;
+  for (int s = 0; s < ENDURANCE_STATES; s++) {
+    if (pred.samples[s] <= 0.0f) continue;
+    if (!any || pred.meanCurrent[s] > highest) highest = pred.meanCurrent[s];
+    if (!any || pred.meanCurrent[s] < lowest) lowest = pred.meanCurrent[s];
+    any = true;
+  }
+
+  float current = 0.0f;
+  for (int s = 0; s < ENDURANCE_STATES; s++) {
+    float mean = pred.meanCurrent[s];
+    if (pred.samples[s] <= 0.0f) {
+      mean = (s == ENDURANCE_ACTIVE_STATE) ? highest + ENDURANCE_DETERRENT_CURRENT : lowest;
+    }
+    if (pred.samples[s] > 1.0f) mean += meanShift * sqrtf(pred.varCurrent[s] / pred.samples[s]);
+    float d = pred.duty[s];
+    if (s == ENDURANCE_STANDBY_STATE) d -= dutyShift;
+    if (s == ENDURANCE_ACTIVE_STATE) d += dutyShift;
+    if (d < 0.0f) d = 0.0f;
+    current += d * mean;
+  }
+  return current < ENDURANCE_MIN_CURRENT ? ENDURANCE_MIN_CURRENT : current;
+}
+
+// One sample of pack current (A) taken in state; dt seconds since the last
+// call. usableAh = charge left above the mission reserve; speed in m/s.
+inline void endurancePredictorUpdate(EndurancePredictor &pred, int state, float current, float dt,
+                                     float usableAh, float capacityAh, float speed) {
+  if (state < 0 || state >= ENDURANCE_STATES || dt <= 0.0f) return;
+
+  // Exponentially weighted mean / variance for this state
+  float maxSamples = ENDURANCE_CURRENT_TAU / dt;
+  if (pred.samples[state] < maxSamples) pred.samples[state] += 1.0f;
+  float alpha = 1.0f / pred.samples[state];
+  float diff = current - pred.meanCurrent[state];
+  pred.meanCurrent[state] += alpha * diff;
+  pred.varCurrent[state] = (1.0f - alpha) * (pred.varCurrent[state] + alpha * diff * diff);
+
+  // Duty: decay all states, credit the current one
+  float beta = dt / ENDURANCE_DUTY_TAU;
+  if (beta > 1.0f) beta = 1.0f;
+  for (int s = 0; s < ENDURANCE_STATES; s++) {
+    pred.duty[s] += beta * ((s == state ? 1.0f : 0.0f) - pred.duty[s]);
+  }
+
+  float margin = ENDURANCE_DUTY_MARGIN;
+  if (margin > pred.duty[ENDURANCE_STANDBY_STATE]) margin = pred.duty[ENDURANCE_STANDBY_STATE];
+  float marginBack = ENDURANCE_DUTY_MARGIN;
+  if (marginBack > pred.duty[ENDURANCE_ACTIVE_STATE]) marginBack = pred.duty[ENDURANCE_ACTIVE_STATE];
+
+  float socError = ENDURANCE_SOC_UNCERTAINTY * capacityAh;
+  float usableLow = usableAh - socError;
+  if (usableLow < 0.0f) usableLow = 0.0f;
+  if (usableAh < 0.0f) usableAh = 0.0f;
+
+  pred.expectedCurrent = endurancePredictorCurrent(pred, 0.0f, 0.0f);
+  pred.timeRemaining = usableAh / pred.expectedCurrent * 3600.0f;
+  pred.timeLow = usableLow / endurancePredictorCurrent(pred, 2.0f, margin) * 3600.0f;
+  pred.timeHigh = (usableAh + socError) / endurancePredictorCurrent(pred, -2.0f, -marginBack) * 3600.0f;
+
+  pred.rangeRemaining = pred.timeRemaining * speed;
+  pred.rangeLow = pred.timeLow * speed;
+  pred.rangeHigh = pred.timeHigh * speed;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Mission Energy Budget Governor
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Works out how much battery energy the deterrents may spend without
+ * eating into what the rest of the mission needs:
+ *
+ *   budget = remaining pack energy - reserve - baseline power * time to go
+ *
+ * and scales strobe intensity, audio duty and ACTIVE duration so that the
+ * expected number of remaining full engagements fits in that budget.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef ENERGY_GOVERNOR_H
+#define ENERGY_GOVERNOR_H
+
+#include <stdint.h>
+
+#define PACK_NOMINAL_VOLTAGE      11.1f    // 3S LiPo
+#define MISSION_RESERVE_FRACTION  0.20f    // Capacity kept back at destination
+#define CRUISE_SPEED_MS           13.9f    // 50 km/h
+#define STROBE_FULL_POWER_W       12.0f    // 4 strobes at 100%
+#define AUDIO_FULL_POWER_W        5.0f
+#define ENGAGEMENT_DURATION_S     60.0f    // Nominal ACTIVE period
+#define ENGAGEMENTS_TO_FUND       3.0f     // Full engagements to keep funded
+
+#define GOVERNOR_STROBE_MIN       50       // Never below ALERT-level strobes
+#define GOVERNOR_STROBE_MAX       255
+#define GOVERNOR_MIN_ACTIVE_MS    10000UL
+#define GOVERNOR_MAX_ACTIVE_MS    60000UL
+#define GOVERNOR_AUDIO_CUTOFF     0.25f    // Below this scale audio is off
+#define GOVERNOR_HYSTERESIS       0.05f    // Scale change needed to re-plan
+
+enum GovernorReason {
+  GOVERNOR_UNRESTRICTED,
+  GOVERNOR_BUDGET_SHORT,
+  GOVERNOR_BUDGET_EXHAUSTED
+};
+
+struct EnergyGovernor {
+  float budgetWh;            // Energy available to deterrents
+  float requiredWh;          // Baseline + reserve still needed
+  float scale;               // 0..1 fraction of full deterrent effort
+  int strobeCap;             // 0..255
+  float audioDuty;           // 0..1
+  unsigned long activeDurationMs;
+  GovernorReason reason;
+  uint32_t throttleEvents;   // Number of cap changes made
+};
+
+inline void energyGovernorApplyScale(EnergyGovernor &gov, float scale) {
+  gov.scale = scale;
+  gov.strobeCap = GOVERNOR_STROBE_MIN + (int)((GOVERNOR_STROBE_MAX - GOVERNOR_STROBE_MIN) * scale);
+  gov.audioDuty = scale < GOVERNOR_AUDIO_CUTOFF ? 0.0f : scale;
+  gov.activeDurationMs = GOVERNOR_MIN_ACTIVE_MS +
+                         (unsigned long)((GOVERNOR_MAX_ACTIVE_MS - GOVERNOR_MIN_ACTIVE_MS) * scale);
+}
+
+inline void energyGovernorInit(EnergyGovernor &gov) {
+  gov.budgetWh = 0.0f;
+  gov.requiredWh = 0.0f;
+  gov.reason = GOVERNOR_UNRESTRICTED;
+  gov.throttleEvents = 0;
+  energyGovernorApplyScale(gov, 1.0f);
+}
+
+// soc 0..1, capacityAh of the pack, baselinePowerW = non-deterrent draw.
+// Returns true when the caps changed (caller logs the decision).
+inline bool energyGovernorUpdate(EnergyGovernor &gov, float soc, float capacityAh,
+                                 float remainingDistanceM, float baselinePowerW) {
+  float capacityWh = capacityAh * PACK_NOMINAL_VOLTAGE;
+  float remainingWh = soc * capacityWh;
+  float timeToGoH = remainingDistanceM / CRUISE_SPEED_MS / 3600.0f;
+
+  gov.requiredWh = MISSION_RESERVE_FRACTION * capacityWh + baselinePowerW * timeToGoH;
+  gov.budgetWh = remainingWh - gov.requiredWh;
+
+  float engagementWh = (STROBE_FULL_POWER_W + AUDIO_FULL_POWER_W) * ENGAGEMENT_DURATION_S / 3600.0f;
+  float scale = gov.budgetWh / (engagementWh * ENGAGEMENTS_TO_FUND);
+  if (scale > 1.0f) scale = 1.0f;
+  if (scale < 0.0f) scale = 0.0f;
+
+  GovernorReason reason = GOVERNOR_UNRESTRICTED;
+  if (scale <= 0.0f) reason = GOVERNOR_BUDGET_EXHAUSTED;
+  else if (scale < 1.0f) reason = GOVERNOR_BUDGET_SHORT;
+
+  // Re-plan only on a meaningful change, or when crossing a reason boundary
+  float delta = scale - gov.scale;
+  if (delta < 0.0f) delta = -delta;
+  if (reason == gov.reason && delta < GOVERNOR_HYSTERESIS) return false;
+
+  gov.reason = reason;
+  energyGovernorApplyScale(gov, scale);
+  gov.throttleEvents++;
+  return true;
+}
+
+#endif
@@ -19,6 +19,31 @@
 #include <Adafruit_BMP280.h>
 #include <SoftwareSerial.h>
 #include <ArduinoJson.h>
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+
+#include "altitude_estimator.h"
+#include "imu_calibration.h"
+#include "ina219_monitor.h"
+#include "battery_soc.h"
+#include "energy_governor.h"
+#include "endurance_predictor.h"
+#include "load_shedder.h"
+#include "telemetry_frame.h"
+#include "telemetry_queue.h"
+#include "telemetry_delta.h"
+#include "telemetry_window.h"
+#include "lora_airtime.h"
+#include "lora_link_adapter.h"
+#include "airtime_budget.h"
+#include "telemetry_fec.h"
+#include "lora_uplink.h"
+#include "flight_recorder.h"
+#include "log_offload.h"
+#include "telemetry_transport.h"
+#include "health_monitor.h"
 
 // Pin Definitions
 #define LED_STROBE_1    0
@@ -38,6 +63,104 @@
 #define RPI_UART_RX     43
 #define RPI_UART_TX     44
 
+// Task Intervals (ms) - sensor rates come from sensorRateProfiles[]
+#define CONTROL_INTERVAL_MS       50   // 20Hz threat assessment / deterrents
+#define PROFILE_REPORT_INTERVAL_MS 30000
+
+// Physical Constants
+#define GRAVITY_MSS               9.80665f
+#define SEA_LEVEL_PRESSURE_PA     101325.0f
+#define ATTITUDE_GYRO_WEIGHT      0.98f  // Complementary roll/pitch filter
+
+// Calibration
+#define CAL_COLD_SAMPLES          200    // Gyro bias samples on a cold boot (~1s)
+#define CAL_SAVE_INTERVAL_MS      300000 // Min time between NVS writes
+#define ATTITUDE_SETTLE_SAMPLES   10     // Calibrated samples before attitude is valid
+
+// Power
+#define DCDC_EFFICIENCY           0.90f  // 5V / 3V3 converters fed from the 12V bus
+#define SOC_RESTORE_TOLERANCE     0.15f  // Stored SoC vs OCV - larger means pack swapped
+#define SOC_SAVE_STEP             0.01f  // Persist SoC every 1%
+
+// Mission energy budget
+#define MISSION_DISTANCE_M        10000.0f
+#define BASELINE_POWER_W          8.0f   // Pi + ESP32 + sensors, until measured
+#define BASELINE_POWER_ALPHA      0.05f  // EMA weight per 1Hz STANDBY sample
+#define AIRBORNE_ALTITUDE_M       5.0f   // Above launch altitude
+#define GOVERNOR_INTERVAL_MS      1000
+#define AUDIO_DUTY_PERIOD_MS      1000
+
+// Brownout supervision
+#define BATTERY_DIVIDER_RATIO     4.0f
+#define BROWNOUT_FILTER_ALPHA     0.5f   // Light smoothing of the per-loop ADC sample
+#define PI_SHED_MAX_FPS           5      // Pi frame rate while shedding tier 3
+
+// LoRa
+#define LORA_TX_TIMEOUT_MARGIN_MS 250    // Beyond computed airtime before a TX is declared lost
+#define LORA_PREEMPT_MIN_MS       200    // Status airtime left worth aborting for an event
+
+// Receive window after each TX for the ground ack and any command: the
+// ground's turnaround plus the longest downlink, at the SF just used
+#define LORA_RX_TURNAROUND_MS     60
+#define LORA_RX_MARGIN_MS         40
+
+// 915MHz regulatory airtime: 400ms per transmission and, on one fixed
+// (non-hopping) channel, 400ms in any 20s
+#define LORA_MAX_DWELL_MS         400
+#define LORA_DUTY_WINDOW_MS       20000
+#define LORA_DUTY_LIMIT_MS        400
+#define LORA_EVENT_RESERVE        0.25f  // Budget share status may not use
+#define LORA_BUDGET_RETRY_MS      100    // Re-check interval while held back
+
+// Telemetry FEC: TELEMETRY_FEC_PARITY parity frames after every
+// TELEMETRY_FEC_GROUP data frames while acked delivery is poor (0 disables)
+#define TELEMETRY_FEC_GROUP       4
+#define TELEMETRY_FEC_PARITY      1
+#define TELEMETRY_FEC_DELIVERY    0.95f  // Delivery ratio below which parity is sent
+
+// Close-in telemetry over ESP-NOW, LoRa otherwise (telemetry_transport.h);
+// ground node MAC and channel in NVS namespace "espnow"
+#define LORA_STATUS_INTERVAL_MS   1000
+#define ESPNOW_DEFAULT_CHANNEL    1
+#define ESPNOW_MIN_INTERVAL_MS    10     // Samples follow the IMU rate, 100Hz at most
+#define ESPNOW_MAX_INTERVAL_MS    50     // and 20Hz at least
+#define ESPNOW_BATCH_MS           100    // Longest a sample waits for its batch to fill
+#define ESPNOW_SEND_TIMEOUT_MS    50     // No send callback by then counts as unacked
+
+// Threat score thresholds and ALERT strobe level (uplink adjustable,
+// back to these on reboot)
+#define THREAT_SCORE_LOW          15
+#define THREAT_SCORE_MEDIUM       30
+#define THREAT_SCORE_HIGH         50
+#define ALERT_STROBE_INTENSITY    50
+
+// Black-box recorder (partition "blackbox" in partitions.csv)
+#define RECORDER_PARTITION_SUBTYPE 0x40
+#define RECORDER_DRAIN_MS         10     // Drain task period
+#define RECORDER_TASK_CORE        0      // Away from loop() on core 1
+
+// Post-landing black-box offload over WiFi to ground-station/offload_receiver
+// (network and receiver in NVS namespace "offload")
+#define OFFLOAD_LANDED_ALTITUDE_M 1.5f   // Above launch altitude
+#define OFFLOAD_LANDED_SPEED_MS   0.2f
+#define OFFLOAD_SETTLE_MS         10000  // Landed and still this long first
+#define OFFLOAD_WIFI_TIMEOUT_MS   15000
+#define OFFLOAD_IO_TIMEOUT_MS     5000
+#define OFFLOAD_MAX_CONNECTIONS   20
+#define OFFLOAD_TASK_CORE         0      // With the WiFi stack
+
+// Health monitoring (thresholds in health_monitor.h): the health section
+// rides on a status packet when the flags change and at least this often
+#define HEALTH_REPORT_INTERVAL_MS 10000
+
+// Strike detection
+#define STRIKE_ACCEL_MSS          (4.0f * GRAVITY_MSS)
+#define STRIKE_HOLDOFF_MS         1000
+
+// Energy profiling
+#define ENERGY_LOG_INTERVAL_MS    10000
+#define STROBE_CHANNEL_POWER_W    3.0f   // One strobe at 100% PWM
+
 // System States
 enum SystemState {
   STATE_STANDBY,
@@ -58,9 +181,45 @@ SystemState currentState = STATE_STANDBY;
 ThreatLevel currentThreat = THREAT_NONE;
 unsigned long lastTelemetryTime = 0;
 unsigned long lastSensorUpdate = 0;
+unsigned long lastImuUpdate = 0;
+unsigned long lastBaroUpdate = 0;
+unsigned long lastControlUpdate = 0;
+unsigned long lastImuMicros = 0;
 unsigned long deterrentActivationTime = 0;
 bool emergencyStop = false;
 
+// Per-state sensor sample rates (intervals in ms)
+struct SensorRateProfile {
+  const char *name;
+  uint16_t imuIntervalMs;     // IMU + altitude filter prediction
+  uint16_t baroIntervalMs;    // Barometer + altitude filter correction
+  uint16_t sensorIntervalMs;  // GPS / battery ADC
+  uint16_t powerIntervalMs;   // Power monitoring
+};
+
+// Indexed by SystemState
+const SensorRateProfile sensorRateProfiles[] = {
+  {"STANDBY",   20, 200, 500, 500},  // 50Hz IMU, 5Hz baro, 2Hz ADC
+  {"ALERT",     10,  40, 100, 100},  // 100Hz IMU, 25Hz baro
+  {"ACTIVE",     5,  40, 100,  20},  // 200Hz IMU, 50Hz power
+  {"EMERGENCY", 50, 500, 1000, 1000}
+};
+#define NUM_RATE_PROFILES (sizeof(sensorRateProfiles) / sizeof(sensorRateProfiles[0]))
+
+// Time, CPU and I2C usage accumulated while each profile was active
+struct RateProfileStats {
+  unsigned long elapsedMicros;
+  unsigned long busyMicros;
+  uint32_t i2cTransactions;
+  float currentSumMa;
+  uint32_t currentSamples;
+};
+
+const SensorRateProfile *activeProfile = &sensorRateProfiles[STATE_STANDBY];
+RateProfileStats profileStats[NUM_RATE_PROFILES];
+SystemState profileState = STATE_STANDBY;
+unsigned long lastLoopMicros = 0;
+
 // Sensor Objects
 MPU6050 mpu;
 Adafruit_BMP280 bmp;
@@ -73,7 +232,10 @@ struct SensorData {
   float gyroX, gyroY, gyroZ;
   float temperature;
   float pressure;
-  float altitude;
+  float altitude;        // Fused baro/IMU altitude
+  float baroAltitude;    // Raw barometric altitude
+  float verticalSpeed;   // m/s, positive up
+  float roll, pitch;     // rad, from complementary attitude filter
   float gpsLat, gpsLon;
   bool gpsValid;
   float batteryVoltage;
@@ -82,6 +244,17 @@ struct SensorData {
 };
 
 SensorData sensors;
+AltitudeEstimator altitudeFilter;
+
+// Calibration (persisted in NVS namespace "imucal")
+Preferences calStore;
+ImuCalibration imuCal;
+GyroBiasRefiner gyroRefiner;
+AccelFaceCalibrator accelCalibrator;
+bool calibrationFromNvs = false;
+unsigned long lastCalibrationSave = 0;
+unsigned long attitudeValidMillis = 0;  // Boot to valid attitude, 0 until valid
+int attitudeSamples = 0;
 
 // Power Monitoring
 struct PowerData {
@@ -90,9 +263,167 @@ struct PowerData {
   float voltage3V3, current3V3, power3V3;
   float totalPower;
   float batteryLevel;
+  unsigned long timestamp;        // millis() of the INA219 sweep
+  unsigned long sweepI2cMicros;   // I2C time spent on that sweep
 };
 
 PowerData powerStatus;
+PowerMonitor powerMonitor;
+uint32_t powerMonitorI2cCounted = 0;
+
+// Battery state of charge (persisted in NVS namespace "battery")
+Preferences socStore;
+BatterySocEstimator batterySoc;
+float storedSoc = -1.0f;       // From the previous boot, < 0 if none
+float lastSavedSoc = -1.0f;
+unsigned long lastSocUpdate = 0;
+
+// Deterrent energy governor
+EnergyGovernor energyGovernor;
+float missionDistanceRemainingM = MISSION_DISTANCE_M;
+float baselinePowerW = BASELINE_POWER_W;
+float launchAltitude = 0.0f;
+bool launchAltitudeSet = false;
+bool activeTimedOut = false;   // ACTIVE period used up until the threat drops
+
+// Remaining endurance to the mission reserve
+EndurancePredictor endurance;
+
+// Telemetry
+uint8_t telemetrySequence = 0;
+TelemetryQueue telemetryQueue;
+TelemetryDeltaEncoder telemetryDelta;   // Keyframe + delta packets
+TelemetryWindow telemetryWindow;        // Aggregates since the last status packet
+FecEncoder telemetryFec;                // Parity across groups of sent frames
+uint8_t fecParity[FEC_MAX_PARITY][FEC_MAX_SYMBOL + FEC_PARITY_HEADER];
+uint8_t fecParityLength[FEC_MAX_PARITY];
+int fecParityPending = 0;               // Parity frames of the last group not yet sent
+int fecParityNext = 0;
+uint32_t fecParityDropped = 0;          // Not sent for lack of budget
+bool strikeDetected = false;
+float strikePeakMss = 0.0f;
+unsigned long lastStrikeTime = 0;
+LoRaModulation loraModulation = {12, 125000, 8};  // SF12, 125kHz, CR 4/8
+
+// Asynchronous LoRa transmit: set on queue, cleared from the DIO0 TX-done ISR
+volatile bool loraTxBusy = false;
+bool loraTxPending = false;          // Started and not yet reaped by serviceLoRaTx()
+int loraTxPriority = TELEMETRY_PRIORITY_STATUS;
+uint32_t loraTxPreemptions = 0;
+unsigned long loraTxStart = 0;
+uint32_t loraTxAirtimeMicros = 0;    // Computed airtime of the packet in flight
+unsigned long telemetryStallMicros = 0;
+unsigned long maxTelemetryStallMicros = 0;
+uint32_t loraTxCompleted = 0;
+uint32_t loraTxBusySkips = 0;
+uint32_t loraTxFailures = 0;
+
+// Link adaptation from ground acks, received between transmissions
+LinkAdapter linkAdapter;
+volatile int loraRxLength = 0;       // Set from the DIO0 RX-done ISR
+const LoRaModulation loraFixedModulation = {12, 125000, 8};  // Pre-adaptation setting
+float loraAirtimeSeconds = 0.0f;     // Actually used
+float loraFixedAirtimeSeconds = 0.0f; // Same packets at SF12 / 20 dBm
+
+// Sliding-window airtime against the dwell / duty-cycle limits
+AirtimeBudget airtimeBudget;
+
+// ESP-NOW telemetry and the choice between it and LoRa
+bool espNowConfigured = false;
+bool espNowRunning = false;
+uint8_t espNowPeer[6];
+uint8_t espNowChannel = ESPNOW_DEFAULT_CHANNEL;
+TransportSelector transportSelector;
+TelemetryBatch espNowBatch;
+uint8_t espNowBatchSequence = 0;
+uint8_t espNowSampleSequence = 0;
+unsigned long espNowSendStart = 0;
+bool espNowInFlight = false;            // One batch at a time, so results map to batches
+volatile bool espNowResultReady = false; // Set from the send callback
+volatile bool espNowAcked = false;
+volatile int espNowRxLength = 0;        // Set from the receive callback
+uint8_t espNowRx[UPLINK_COMMAND_LENGTH];
+uint32_t espNowSamples = 0;
+uint32_t espNowDropped = 0;             // Batch full with the previous one still in flight
+
+// Authenticated ground commands (key and last counter in NVS namespace "uplink")
+Preferences uplinkStore;
+UplinkReceiver uplink;
+unsigned long loraRxWindowStart = 0;
+unsigned long loraRxWindowMs = 0;    // 0 when the radio is not listening
+bool commandAckPending = false;      // Next frame carries the command section
+uint16_t commandAckCounter = 0;
+uint8_t commandAckResult = UPLINK_OK;
+int threatScoreLow = THREAT_SCORE_LOW;
+int threatScoreMedium = THREAT_SCORE_MEDIUM;
+int threatScoreHigh = THREAT_SCORE_HIGH;
+int alertStrobeIntensity = ALERT_STROBE_INTENSITY;
+unsigned long audioMuteStart = 0;
+unsigned long audioMuteMs = 0;
+bool logDumpRequested = false;       // Serial reports now rather than on schedule
+
+// Black-box flight recorder, drained to flash by its own task
+FlightRecorder flightRecorder;
+const esp_partition_t *recorderPartition = NULL;
+volatile unsigned long recorderMaxDrainMicros = 0;
+
+// Black-box offload after landing; the transfer runs in its own task
+enum OffloadPhase {
+  OFFLOAD_IDLE,
+  OFFLOAD_STOPPING,         // Waiting for the drain to empty the RAM ring
+  OFFLOAD_RUNNING
+};
+OffloadPhase offloadPhase = OFFLOAD_IDLE;
+bool offloadConfigured = false;
+char offloadSsid[33];
+char offloadPass[65];
+char offloadHost[64];
+uint16_t offloadPort = OFFLOAD_PORT;
+bool offloadAirborne = false;        // Since the last offload
+unsigned long offloadLandedSince = 0;
+volatile bool offloadAbort = false;
+volatile bool offloadFinished = false;
+uint32_t offloadImageBytes = 0;      // Last transfer, read once offloadFinished
+uint32_t offloadWireBytes = 0;
+unsigned long offloadMicros = 0;
+unsigned long offloadFlashMicros = 0;
+uint8_t offloadConnections = 0;
+bool offloadComplete = false;
+
+// Sensor liveness, I2C errors, Pi link, loop overruns and heap
+HealthMonitor health;
+uint16_t reportedHealthFlags = 0;    // As last sent with telemetry
+unsigned long lastHealthReport = 0;
+unsigned long healthBusyMicros = 0;  // Spent evaluating, for its CPU share
+
+// Brownout load shedding
+LoadShedder loadShedder;
+float brownoutVoltage = 0.0f;
+
+// Energy used per SystemState and per actuator channel since boot
+enum EnergyChannel {
+  ENERGY_STROBE_1,
+  ENERGY_STROBE_2,
+  ENERGY_STROBE_3,
+  ENERGY_STROBE_4,
+  ENERGY_AUDIO,
+  ENERGY_PI,          // 5V rail
+  ENERGY_CONTROLLER,  // 3V3 rail
+  ENERGY_OTHER_12V,   // 12V rail with no deterrent commanded
+  ENERGY_CHANNELS
+};
+
+struct EnergyProfile {
+  float stateWh[4];
+  float stateSeconds[4];
+  float channelWh[ENERGY_CHANNELS];
+  float totalWh;
+  unsigned long lastSample;
+};
+
+EnergyProfile energyProfile;
+int strobeOutput[4] = {0, 0, 0, 0};   // Last PWM written per strobe
+bool audioOutput = false;
 
 // Bird Detection Data from Raspberry Pi
 struct BirdDetection {
@@ -113,12 +444,26 @@ void setup() {
   // Initialize GPIO pins
   initializeGPIO();
   
+  // Liveness is measured from here, so a sensor that never comes up shows
+  healthMonitorInit(health, millis());
+  
   // Initialize I2C sensors
   initializeSensors();
   
   // Initialize LoRa communication
   initializeLoRa();
   
+  // ESP-NOW alongside it for close-in operations
+  initializeEspNow();
+  
+  // Start the black box before anything worth recording happens
+  initializeFlightRecorder();
+  initializeLogOffload();
+  
+  telemetryQueueInit(telemetryQueue);
+  telemetryDeltaInit(telemetryDelta);
+  telemetryWindowReset(telemetryWindow);
+  
   // Initialize audio system
   initializeAudio();
   
@@ -133,40 +478,204 @@ void setup() {
 }
 
 void loop() {
+  unsigned long loopStart = micros();
+  
   // Check emergency stop
   if (digitalRead(EMERGENCY_STOP) == LOW) {
     emergencyStop = true;
     currentState = STATE_EMERGENCY;
   }
   
-  // Update sensor data (10Hz)
-  if (millis() - lastSensorUpdate >= 100) {
-    updateSensorData();
-    lastSensorUpdate = millis();
+  // Shed loads within a loop pass of a voltage sag
+  superviseBrownout();
+  
+  // Follow the sample rate profile of the current state
+  applySensorRateProfile();
+  
+  // Inertial update and altitude filter prediction
+  if (millis() - lastImuUpdate >= activeProfile->imuIntervalMs) {
+    lastImuUpdate = millis();
+    updateInertialData();
   }
   
-  // Check for bird detection from Raspberry Pi
-  checkBirdDetection();
+  // Barometer update and altitude filter correction
+  if (millis() - lastBaroUpdate >= activeProfile->baroIntervalMs) {
+    lastBaroUpdate = millis();
+    updateBarometerData();
+  }
   
-  // Update system state based on threat assessment
-  updateSystemState();
+  // Update remaining sensor data
+  if (millis() - lastSensorUpdate >= activeProfile->sensorIntervalMs) {
+    updateSensorData();
+    lastSensorUpdate = millis();
+  }
   
-  // Control deterrent systems based on current state
-  controlDeterrents();
+  // Monitor power consumption: INA219 sweep at the profile rate,
+  // processed as soon as every rail reports conversion ready
+  if (powerMonitorService(powerMonitor, activeProfile->powerIntervalMs)) {
+    monitorPowerSystems();
+  }
   
-  // Monitor power consumption
-  monitorPowerSystems();
+  // Threat assessment and deterrent control (20Hz)
+  if (millis() - lastControlUpdate >= CONTROL_INTERVAL_MS) {
+    lastControlUpdate = millis();
+    
+    // Check for bird detection from Raspberry Pi
+    checkBirdDetection();
+    
+    // Update system state based on threat assessment
+    updateSystemState();
+    
+    // Re-plan the deterrent energy budget (1Hz)
+    updateEnergyGovernor();
+    
+    // Control deterrent systems based on current state
+    controlDeterrents();
+    
+    // Threat / state / strike events jump the telemetry queue
+    queueTelemetryEvents();
+    
+    recordControlOutputs();
+  }
   
-  // Send telemetry data (1Hz)
-  if (millis() - lastTelemetryTime >= 1000) {
+  // Periodic status: 1Hz over LoRa, at the IMU rate over ESP-NOW
+  if (millis() - lastTelemetryTime >= telemetryIntervalMs()) {
     sendTelemetryData();
     lastTelemetryTime = millis();
   }
   
+  // Put the most urgent queued message on air once the radio is free
+  serviceTelemetryQueue();
+  
+  // Reap completed / lost LoRa transmissions and incoming acks
+  serviceLoRaTx();
+  serviceLoRaRx();
+  
+  // ESP-NOW send results, batch flushes and ground commands
+  serviceEspNow();
+  
   // System health monitoring
   performHealthCheck();
   
-  delay(50); // 20Hz main loop
+  // Per-profile CPU / current report
+  reportRateProfiles();
+  
+  // Cumulative energy record for the flight log
+  logEnergyProfile();
+  
+  // Bound what a power cut can take with it to FR_FLUSH_MS of records
+  frSealIfOlder(flightRecorder, millis(), FR_FLUSH_MS);
+  
+  // Black box to the ground over WiFi once landed
+  updateLogOffload();
+  
+  // A pass longer than the IMU interval has cost a sample
+  unsigned long loopMicros = micros() - loopStart;
+  healthLoopPass(health, loopMicros, activeProfile->imuIntervalMs * 1000UL);
+  profileStats[profileState].busyMicros += loopMicros;
+  
+  delay(1); // Tasks above are individually rate limited
+}
+
+void applySensorRateProfile() {
+  unsigned long now = micros();
+  if (lastLoopMicros != 0) {
+    profileStats[profileState].elapsedMicros += now - lastLoopMicros;
+  }
+  lastLoopMicros = now;
+  
+  if (currentState == profileState) return;
+  
+  // Task timestamps are kept, so a faster profile samples on its next
+  // interval and a slower one simply waits longer - no burst or gap.
+  // The altitude filter measures its own dt, so it follows either way.
+  Serial.print("Sensor rate profile: ");
+  Serial.print(sensorRateProfiles[profileState].name);
+  Serial.print(" -> ");
+  Serial.println(sensorRateProfiles[currentState].name);
+  
+  profileState = currentState;
+  activeProfile = &sensorRateProfiles[profileState];
+}
+
+void reportRateProfiles() {
+  static unsigned long lastReport = 0;
+  
+  if (!logDumpRequested && millis() - lastReport < PROFILE_REPORT_INTERVAL_MS) return;
+  lastReport = millis();
+  
+  Serial.println("Profile    Time(s)  CPU(%)  I2C/s   Avg mA");
+  for (int i = 0; i < (int)NUM_RATE_PROFILES; i++) {
+    const RateProfileStats &st = profileStats[i];
+    if (st.elapsedMicros == 0) continue;
+    
+    float seconds = st.elapsedMicros / 1e6f;
+    float cpuPercent = 100.0f * st.busyMicros / st.elapsedMicros;
+    float i2cRate = st.i2cTransactions / seconds;
+    float avgCurrent = st.currentSamples ? st.currentSumMa / st.currentSamples : 0.0f;
+    
+    Serial.printf("%-10s %7.0f  %6.2f  %6.1f  %7.1f\n", sensorRateProfiles[i].name,
+                  seconds, cpuPercent, i2cRate, avgCurrent);
+  }
+  
+  Serial.printf("INA219 sweep I2C: last %lu us, max %lu us, %lu sweeps, %lu timeouts\n",
+                powerMonitor.lastSweepI2cMicros, powerMonitor.maxSweepI2cMicros,
+                (unsigned long)powerMonitor.sweeps, (unsigned long)powerMonitor.timeouts);
+  Serial.printf("LoRa TX: loop stall last %lu us, max %lu us (airtime %lu ms), "
+                "%lu sent, %lu busy skips, %lu failures, %lu preempted\n",
+                telemetryStallMicros, maxTelemetryStallMicros,
+                (unsigned long)(loraTxAirtimeMicros / 1000), (unsigned long)loraTxCompleted,
+                (unsigned long)loraTxBusySkips, (unsigned long)loraTxFailures,
+                (unsigned long)loraTxPreemptions);
+  Serial.printf("LoRa airtime budget: %.0f%% of %d ms / %d s used (peak %.0f%%), "
+                "%lu delayed, %lu shrunk, %lu SF clamped to fit\n",
+                100.0f * airtimeBudgetUsage(airtimeBudget), LORA_DUTY_LIMIT_MS, LORA_DUTY_WINDOW_MS / 1000,
+                100.0f * airtimeBudget.peakMicros / airtimeBudget.limitMicros,
+                (unsigned long)airtimeBudget.delayed, (unsigned long)airtimeBudget.shrunk,
+                (unsigned long)airtimeBudget.clamped);
+  uint32_t packets = telemetryDelta.keyframes + telemetryDelta.deltas;
+  if (packets > 0) {
+    Serial.printf("Telemetry encoding: %.1f B/packet vs %.1f B full frames (%lu keyframes, %lu deltas)\n",
+                  (float)telemetryDelta.bytesSent / packets, (float)telemetryDelta.fullBytes / packets,
+                  (unsigned long)telemetryDelta.keyframes, (unsigned long)telemetryDelta.deltas);
+  }
+  const char *classNames[TELEMETRY_PRIORITIES] = {"event", "status"};
+  for (int c = 0; c < TELEMETRY_PRIORITIES; c++) {
+    const TelemetryClassStats &q = telemetryQueue.stats[c];
+    Serial.printf("Telemetry %-6s: latency avg %lu ms, max %lu ms; %lu sent, %lu coalesced, "
+                  "%lu stale, %lu overflow\n", classNames[c],
+                  (unsigned long)(q.sent ? q.latencySumMs / q.sent : 0), (unsigned long)q.latencyMaxMs,
+                  (unsigned long)q.sent, (unsigned long)q.coalesced, (unsigned long)q.stale,
+                  (unsigned long)q.overflow);
+  }
+  float saved = loraFixedAirtimeSeconds > 0 ? 100.0f * (1.0f - loraAirtimeSeconds / loraFixedAirtimeSeconds) : 0.0f;
+  Serial.printf("LoRa link: SF%d %d dBm, margin %.1f dB (+%.1f), delivery %.0f%%, "
+                "%lu/%lu acked, %lu fallbacks, airtime %.1f s vs %.1f s fixed (%.0f%% saved)\n",
+                linkAdapter.spreadingFactor, linkAdapter.txPowerDbm, linkAdapter.marginAtMaxDb,
+                linkAdapter.penaltyDb, 100.0f * linkAdapterDeliveryRatio(linkAdapter),
+                (unsigned long)linkAdapter.acked, (unsigned long)linkAdapter.sent,
+                (unsigned long)linkAdapter.fallbacks, loraAirtimeSeconds, loraFixedAirtimeSeconds, saved);
+  if (telemetryFec.groups > 0) {
+    Serial.printf("Telemetry FEC: %d+%d, %lu groups, %lu parity frames (%lu B), %lu dropped\n",
+                  telemetryFec.k, TELEMETRY_FEC_PARITY, (unsigned long)telemetryFec.groups,
+                  (unsigned long)telemetryFec.parityFrames, (unsigned long)telemetryFec.parityBytes,
+                  (unsigned long)fecParityDropped);
+  }
+  Serial.printf("Flight recorder: %lu records, %lu dropped, %lu pages, %lu sectors erased "
+                "(max wear %lu), %lu flash errors, drain max %lu us\n",
+                (unsigned long)flightRecorder.records, (unsigned long)flightRecorder.dropped,
+                (unsigned long)flightRecorder.pagesWritten, (unsigned long)flightRecorder.sectorsErased,
+                (unsigned long)flightRecorder.maxEraseCount, (unsigned long)flightRecorder.flashErrors,
+                recorderMaxDrainMicros);
+  Serial.printf("Uplink: counter %u, %lu applied, %lu repeats, %lu stale, %lu rejected\n",
+                uplink.lastCounter, (unsigned long)uplink.accepted, (unsigned long)uplink.repeats,
+                (unsigned long)uplink.stale, (unsigned long)uplink.rejected);
+  Serial.printf("Health: flags 0x%03x (%lu raised), I2C %lu errors / %lu, Pi %.1f msg/s, "
+                "%lu loop overruns (max %lu us), heap %lu B free (min %lu), checks %.3f%% CPU\n",
+                health.flags, (unsigned long)health.flagRaises, (unsigned long)health.checkI2cErrors,
+                (unsigned long)health.checkI2cTransactions, health.piRate, (unsigned long)health.loopOverruns,
+                (unsigned long)health.maxLoopMicros, (unsigned long)health.freeHeap,
+                (unsigned long)health.minFreeHeap, 100.0f * healthBusyMicros / (millis() * 1000.0f));
 }
 
 void initializeGPIO() {
@@ -209,17 +718,41 @@ void initializeSensors() {
   }
   
   // Initialize BMP280 Barometer
+  // Light on-chip IIR only - smoothing is done by the altitude filter,
+  // which uses the accelerometer instead of adding lag
   if (bmp.begin()) {
     Serial.println("BMP280 initialized successfully");
     bmp.setSampling(Adafruit_BMP280::MODE_NORMAL,
                     Adafruit_BMP280::SAMPLING_X2,
-                    Adafruit_BMP280::SAMPLING_X16,
-                    Adafruit_BMP280::FILTER_X16,
-                    Adafruit_BMP280::STANDBY_MS_500);
+                    Adafruit_BMP280::SAMPLING_X8,
+                    Adafruit_BMP280::FILTER_X2,
+                    Adafruit_BMP280::STANDBY_MS_1);
   } else {
     Serial.println("Failed to initialize BMP280");
   }
   
+  // Initialize INA219 rail monitors
+  powerMonitorBegin(powerMonitor);
+  for (int i = 0; i < INA219_NUM_RAILS; i++) {
+    Serial.print("INA219 0x");
+    Serial.print(powerMonitor.rails[i].address, HEX);
+    Serial.println(powerMonitor.rails[i].present ? " initialized successfully" : " not responding");
+  }
+  
+  // Battery SoC: restore the previous estimate, validated on the first reading
+  batterySocInit(batterySoc);
+  socStore.begin("battery", false);
+  storedSoc = socStore.getFloat("soc", -1.0f);
+  
+  energyGovernorInit(energyGovernor);
+  endurancePredictorInit(endurance);
+  loadShedderInit(loadShedder);
+  
+  // Calibration: one NVS read on a warm boot, gyro bias capture on a cold one
+  loadCalibration();
+  
+  altitudeEstimatorInit(altitudeFilter);
+  
   // Initialize GPS communication
   gpsSerial.begin(9600);
   rpiSerial.begin(115200);
@@ -228,17 +761,253 @@ void initializeSensors() {
 void initializeLoRa() {
   LoRa.setPins(LORA_CS, LORA_RST, LORA_DIO0);
   
+  // Start at the most robust setting until acks report the link margin
+  linkAdapterInit(linkAdapter);
+  fecEncoderInit(telemetryFec, TELEMETRY_FEC_GROUP, TELEMETRY_FEC_PARITY);
+  airtimeBudgetInit(airtimeBudget, LORA_DUTY_WINDOW_MS, LORA_DUTY_LIMIT_MS * 1000UL,
+                    LORA_MAX_DWELL_MS * 1000UL, millis());
+  
+  // Uplink commands are refused until a key has been provisioned
+  uplinkStore.begin("uplink", false);
+  uint8_t key[UPLINK_KEY_LENGTH];
+  bool keyed = uplinkStore.getBytes("key", key, sizeof(key)) == sizeof(key);
+  uplinkReceiverInit(uplink, keyed ? key : 0, uplinkStore.getUShort("counter", 0));
+  if (!keyed) Serial.println("No uplink key in NVS - ground commands disabled");
+  
   if (LoRa.begin(915E6)) {
     Serial.println("LoRa initialized successfully");
-    LoRa.setSpreadingFactor(12);
-    LoRa.setSignalBandwidth(125E3);
-    LoRa.setCodingRate4(8);
-    LoRa.setTxPower(20);
+    LoRa.setSpreadingFactor(loraModulation.spreadingFactor);
+    LoRa.setSignalBandwidth(loraModulation.bandwidthHz);
+    LoRa.setCodingRate4(loraModulation.codingRate);
+    LoRa.setTxPower(linkAdapter.txPowerDbm);
+    
+    // TX completion and ack reception arrive on DIO0 instead of blocking
+    LoRa.onTxDone(onLoRaTxDone);
+    LoRa.onReceive(onLoRaReceive);
   } else {
     Serial.println("Failed to initialize LoRa");
   }
 }
 
+bool recorderFlashRead(void *context, uint32_t offset, void *data, size_t length) {
+  return esp_partition_read((const esp_partition_t *)context, offset, data, length) == ESP_OK;
+}
+
+bool recorderFlashWrite(void *context, uint32_t offset, const void *data, size_t length) {
+  return esp_partition_write((const esp_partition_t *)context, offset, data, length) == ESP_OK;
+}
+
+bool recorderFlashErase(void *context, uint32_t offset, size_t length) {
+  return esp_partition_erase_range((const esp_partition_t *)context, offset, length) == ESP_OK;
+}
+
+// Flash writes and sector erases stay off the control path
+void flightRecorderTask(void *parameter) {
+  for (;;) {
+    unsigned long start = micros();
+    if (frDrain(flightRecorder, FR_RAM_PAGES) > 0) {
+      unsigned long elapsed = micros() - start;
+      if (elapsed > recorderMaxDrainMicros) recorderMaxDrainMicros = elapsed;
+    }
+    vTaskDelay(pdMS_TO_TICKS(RECORDER_DRAIN_MS));
+  }
+}
+
+void initializeFlightRecorder() {
+  recorderPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                               (esp_partition_subtype_t)RECORDER_PARTITION_SUBTYPE, "blackbox");
+  if (recorderPartition == NULL) {
+    Serial.println("No blackbox partition - flight recorder disabled");
+    return;
+  }
+  
+  RecorderFlash flash;
+  flash.context = (void *)recorderPartition;
+  flash.size = recorderPartition->size;
+  flash.read = recorderFlashRead;
+  flash.write = recorderFlashWrite;
+  flash.erase = recorderFlashErase;
+  if (!frInit(flightRecorder, flash)) {
+    Serial.println("Flight recorder flash error - disabled");
+    return;
+  }
+  
+  xTaskCreatePinnedToCore(flightRecorderTask, "blackbox", 4096, NULL, 1, NULL, RECORDER_TASK_CORE);
+  Serial.printf("Flight recorder: boot %lu, sector %lu of %lu\n", (unsigned long)flightRecorder.boot,
+                (unsigned long)flightRecorder.sector, (unsigned long)flightRecorder.sectors);
+}
+
+void initializeLogOffload() {
+  Preferences store;
+  store.begin("offload", true);
+  offloadConfigured = store.getString("ssid", offloadSsid, sizeof(offloadSsid)) > 0 &&
+                      store.getString("host", offloadHost, sizeof(offloadHost)) > 0;
+  if (store.getString("pass", offloadPass, sizeof(offloadPass)) == 0) offloadPass[0] = '\0';
+  offloadPort = store.getUShort("port", OFFLOAD_PORT);
+  store.end();
+  
+  if (recorderPartition == NULL || !flightRecorder.ready) offloadConfigured = false;
+  if (!offloadConfigured) Serial.println("No offload network in NVS - black box stays on board");
+}
+
+// Stop the recorder once landed, hand the partition to logOffloadTask,
+// and resume recording when it is done or the drone takes off again
+void updateLogOffload() {
+  if (!offloadConfigured) return;
+  
+  float height = sensors.altitude - launchAltitude;
+  if (launchAltitudeSet && height > AIRBORNE_ALTITUDE_M) offloadAirborne = true;
+  bool landed = offloadAirborne && currentState == STATE_STANDBY &&
+                height < OFFLOAD_LANDED_ALTITUDE_M &&
+                fabs(sensors.verticalSpeed) < OFFLOAD_LANDED_SPEED_MS &&
+                gyroRefiner.stationaryCount >= CAL_STATIONARY_SAMPLES;
+  
+  switch (offloadPhase) {
+    case OFFLOAD_IDLE:
+      if (!landed) {
+        offloadLandedSince = 0;
+        return;
+      }
+      if (offloadLandedSince == 0) offloadLandedSince = millis();
+      if (millis() - offloadLandedSince < OFFLOAD_SETTLE_MS) return;
+      // Everything recorded so far goes to flash before the image is frozen
+      frSeal(flightRecorder);
+      offloadPhase = OFFLOAD_STOPPING;
+      break;
+      
+    case OFFLOAD_STOPPING:
+      if (flightRecorder.sealed.load() != flightRecorder.drained.load()) return;
+      flightRecorder.ready = false;  // Appends refused, drain idle
+      stopEspNow();                  // The offload needs the radio on the AP's channel
+      offloadAbort = false;
+      offloadFinished = false;
+      xTaskCreatePinnedToCore(logOffloadTask, "offload", 8192, NULL, 1, NULL, OFFLOAD_TASK_CORE);
+      offloadPhase = OFFLOAD_RUNNING;
+      break;
+      
+    case OFFLOAD_RUNNING:
+      if (!landed) offloadAbort = true;  // Taking off again
+      if (!offloadFinished) return;
+      flightRecorder.ready = true;
+      if (espNowConfigured) startEspNow();
+      offloadAirborne = false;
+      offloadLandedSince = 0;
+      offloadPhase = OFFLOAD_IDLE;
+      Serial.printf("Offload %s: %lu KB in %lu ms over %u connection(s), %.0f KB/s "
+                    "(%lu KB on the wire, flash read %.0f KB/s)\n",
+                    offloadComplete ? "complete" : "incomplete", (unsigned long)(offloadImageBytes / 1024),
+                    offloadMicros / 1000, offloadConnections,
+                    offloadMicros > 0 ? offloadImageBytes * 1000.0f / 1024.0f / (offloadMicros / 1000.0f) : 0.0f,
+                    (unsigned long)(offloadWireBytes / 1024),
+                    offloadFlashMicros > 0 ? offloadImageBytes * 1000.0f / 1024.0f / (offloadFlashMicros / 1000.0f) : 0.0f);
+      break;
+  }
+}
+
+// Acks that have arrived, without waiting for more
+void pollOffloadAcks(WiFiClient &client, uint8_t *ack, size_t &fill, uint32_t &acked) {
+  while (client.available() > 0) {
+    int c = client.read();
+    if (c < 0) return;
+    ack[fill++] = (uint8_t)c;
+    if (fill == OFFLOAD_ACK_LENGTH) {
+      uint32_t offset;
+      if (offloadParseAck(ack, offset) && offset > acked) acked = offset;
+      fill = 0;
+    }
+  }
+}
+
+// One connection: HELLO, RESUME, then chunks read from flash straight into
+// the send buffer until the image is sent or the link drops. Returns the
+// offset the receiver has confirmed.
+uint32_t sendOffloadConnection(const OffloadImage &image, uint8_t *frame, uint32_t acked) {
+  WiFiClient client;
+  if (!client.connect(offloadHost, offloadPort)) {
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    return acked;
+  }
+  client.setNoDelay(true);
+  
+  uint8_t message[OFFLOAD_HELLO_LENGTH];
+  offloadEncodeHello(image, message);
+  client.write(message, OFFLOAD_HELLO_LENGTH);
+  unsigned long waitStart = millis();
+  while (client.connected() && client.available() < OFFLOAD_RESUME_LENGTH &&
+         millis() - waitStart < OFFLOAD_IO_TIMEOUT_MS) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  uint32_t offset;
+  if (client.available() < OFFLOAD_RESUME_LENGTH || client.read(message, OFFLOAD_RESUME_LENGTH) != OFFLOAD_RESUME_LENGTH ||
+      !offloadParseResume(message, offset) || offset > image.size || offset % image.chunkSize != 0) {
+    client.stop();
+    return acked;
+  }
+  if (offset > acked) acked = offset;
+  
+  uint8_t ack[OFFLOAD_ACK_LENGTH];
+  size_t ackFill = 0;
+  while (offset < image.size && !offloadAbort) {
+    unsigned long readStart = micros();
+    if (esp_partition_read(recorderPartition, offset, frame + OFFLOAD_CHUNK_HEADER, image.chunkSize) != ESP_OK) break;
+    offloadFlashMicros += micros() - readStart;
+    size_t length = offloadFinishChunk(frame, offset, image.chunkSize);
+    if (client.write(frame, length) != length) break;
+    offloadImageBytes += image.chunkSize;
+    offloadWireBytes += length;
+    offset += image.chunkSize;
+    pollOffloadAcks(client, ack, ackFill, acked);
+  }
+  
+  // The last ack comes once the receiver has synced the whole image
+  waitStart = millis();
+  while (offset == image.size && acked < image.size && client.connected() &&
+         millis() - waitStart < OFFLOAD_IO_TIMEOUT_MS) {
+    pollOffloadAcks(client, ack, ackFill, acked);
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  client.stop();
+  return acked;
+}
+
+// Joins the offload network and streams the frozen partition, reconnecting
+// and resuming from the receiver's position when the link drops
+void logOffloadTask(void *parameter) {
+  static uint8_t frame[OFFLOAD_FRAME_MAX];
+  OffloadImage image;
+  image.boot = flightRecorder.boot;
+  image.sequence = flightRecorder.sequence;
+  image.size = recorderPartition->size / OFFLOAD_CHUNK_SIZE * OFFLOAD_CHUNK_SIZE;
+  image.chunkSize = OFFLOAD_CHUNK_SIZE;
+  
+  offloadImageBytes = offloadWireBytes = 0;
+  offloadFlashMicros = 0;
+  offloadConnections = 0;
+  unsigned long start = micros();
+  
+  WiFi.mode(WIFI_STA);
+  WiFi.setSleep(false);  // Modem sleep throttles TCP
+  WiFi.begin(offloadSsid, offloadPass);
+  unsigned long waitStart = millis();
+  while (WiFi.status() != WL_CONNECTED && !offloadAbort && millis() - waitStart < OFFLOAD_WIFI_TIMEOUT_MS) {
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+  
+  uint32_t acked = 0;
+  while (WiFi.status() == WL_CONNECTED && !offloadAbort && acked < image.size &&
+         offloadConnections < OFFLOAD_MAX_CONNECTIONS) {
+    offloadConnections++;
+    acked = sendOffloadConnection(image, frame, acked);
+  }
+  offloadComplete = acked == image.size;
+  offloadMicros = micros() - start;
+  
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+  offloadFinished = true;
+  vTaskDelete(NULL);
+}
+
 void initializeAudio() {
   digitalWrite(AUDIO_ENABLE, LOW); // Start with audio disabled
   
@@ -259,34 +1028,210 @@ void initializeLEDStrobes() {
   Serial.println("LED strobe system initialized");
 }
 
-void updateSensorData() {
-  sensors.timestamp = millis();
+void updateInertialData() {
+  unsigned long nowMicros = micros();
+  float dt = (lastImuMicros == 0) ? 0.0f : (nowMicros - lastImuMicros) * 1e-6f;
+  lastImuMicros = nowMicros;
   
   // Read IMU data
   sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
+  bool imuOk = mpu.getEvent(&a, &g, &temp);
+  profileStats[profileState].i2cTransactions++;
+  healthI2c(health, 1, imuOk);
+  if (imuOk) healthSensorGood(health, HEALTH_SENSOR_IMU, millis());
+  
+  float gyro[3] = {g.gyro.x, g.gyro.y, g.gyro.z};
+  float accel[3] = {a.acceleration.x, a.acceleration.y, a.acceleration.z};
   
-  sensors.accelX = a.acceleration.x;
-  sensors.accelY = a.acceleration.y;
-  sensors.accelZ = a.acceleration.z;
-  sensors.gyroX = g.gyro.x;
-  sensors.gyroY = g.gyro.y;
-  sensors.gyroZ = g.gyro.z;
+  // Refine gyro bias in the background while stationary, then correct
+  gyroBiasRefinerUpdate(gyroRefiner, imuCal, gyro, accel, temp.temperature, dt);
+  if (accelFaceCalibratorUpdate(accelCalibrator, imuCal, gyro, accel, temp.temperature)) {
+    // Only completes on the bench, turned over by hand: save at once
+    saveCalibration();
+    Serial.printf("Accelerometer calibrated: offset %.3f %.3f %.3f m/s^2, scale %.4f %.4f %.4f\n",
+                  imuCal.accelOffset[0], imuCal.accelOffset[1], imuCal.accelOffset[2],
+                  imuCal.accelScale[0], imuCal.accelScale[1], imuCal.accelScale[2]);
+  }
+  imuCalibrationApply(imuCal, gyro, accel, temp.temperature);
   
-  // Read barometer data
+  sensors.accelX = accel[0];
+  sensors.accelY = accel[1];
+  sensors.accelZ = accel[2];
+  sensors.gyroX = gyro[0];
+  sensors.gyroY = gyro[1];
+  sensors.gyroZ = gyro[2];
+  
+  float imuRecord[6] = {accel[0], accel[1], accel[2], gyro[0], gyro[1], gyro[2]};
+  frAppend(flightRecorder, FR_IMU, millis(), imuRecord);
+  
+  // Bird strike: specific force spike well beyond flight loads
+  float accelMagnitude = sqrt(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+  if (accelMagnitude > STRIKE_ACCEL_MSS && millis() - lastStrikeTime > STRIKE_HOLDOFF_MS) {
+    strikeDetected = true;
+    lastStrikeTime = millis();
+  }
+  if (strikeDetected && accelMagnitude > strikePeakMss) strikePeakMss = accelMagnitude;
+  
+  if (attitudeValidMillis == 0 && ++attitudeSamples >= ATTITUDE_SETTLE_SAMPLES) {
+    attitudeValidMillis = millis();
+    Serial.print("Boot to valid attitude: ");
+    Serial.print(attitudeValidMillis);
+    Serial.println(calibrationFromNvs ? " ms (NVS calibration)" : " ms (cold calibration)");
+  }
+  
+  // Roll/pitch: integrate gyro, pull towards the accelerometer tilt
+  float accelRoll = atan2(sensors.accelY, sensors.accelZ);
+  float accelPitch = atan2(-sensors.accelX, sqrt(sensors.accelY * sensors.accelY +
+                                                 sensors.accelZ * sensors.accelZ));
+  if (dt <= 0.0f || dt > 0.5f) {
+    sensors.roll = accelRoll;
+    sensors.pitch = accelPitch;
+    return;
+  }
+  sensors.roll = ATTITUDE_GYRO_WEIGHT * (sensors.roll + sensors.gyroX * dt) +
+                 (1.0f - ATTITUDE_GYRO_WEIGHT) * accelRoll;
+  sensors.pitch = ATTITUDE_GYRO_WEIGHT * (sensors.pitch + sensors.gyroY * dt) +
+                  (1.0f - ATTITUDE_GYRO_WEIGHT) * accelPitch;
+  
+  // Rotate specific force into the earth frame and remove gravity
+  float cosRoll = cos(sensors.roll);
+  float cosPitch = cos(sensors.pitch);
+  float verticalAccel = -sin(sensors.pitch) * sensors.accelX +
+                        sin(sensors.roll) * cosPitch * sensors.accelY +
+                        cosRoll * cosPitch * sensors.accelZ - GRAVITY_MSS;
+  
+  altitudeEstimatorPredict(altitudeFilter, verticalAccel, dt);
+  sensors.altitude = altitudeFilter.altitude;
+  sensors.verticalSpeed = altitudeFilter.verticalSpeed;
+  windowStatAdd(telemetryWindow.verticalSpeed, sensors.verticalSpeed);
+}
+
+void updateBarometerData() {
   sensors.temperature = bmp.readTemperature();
   sensors.pressure = bmp.readPressure();
-  sensors.altitude = bmp.readAltitude(1013.25); // Sea level pressure
+  profileStats[profileState].i2cTransactions += 2;
+  
+  // The driver returns NaN (or nothing sensible) when the bus read fails
+  bool baroOk = !isnan(sensors.temperature) && sensors.pressure > 0.0f;
+  healthI2c(health, 2, baroOk);
+  if (baroOk) healthSensorGood(health, HEALTH_SENSOR_BARO, millis());
+  
+  // Barometric formula on the pressure already read (readAltitude() would
+  // trigger a second pressure conversion)
+  sensors.baroAltitude = 44330.0f * (1.0f - pow(sensors.pressure / SEA_LEVEL_PRESSURE_PA, 0.1903f));
+  altitudeEstimatorCorrect(altitudeFilter, sensors.baroAltitude);
+  
+  float altitudeRecord[6] = {sensors.baroAltitude, altitudeFilter.altitude, altitudeFilter.verticalSpeed,
+                             sensors.roll, sensors.pitch, sensors.temperature};
+  frAppend(flightRecorder, FR_ALTITUDE, millis(), altitudeRecord);
+}
+
+void updateSensorData() {
+  sensors.timestamp = millis();
+  
+  // Store refined calibration in the background
+  persistCalibration();
   
   // Read GPS data (simplified - would need full NMEA parsing)
   if (gpsSerial.available()) {
     // Parse GPS data here
     sensors.gpsValid = true; // Placeholder
+    healthSensorGood(health, HEALTH_SENSOR_GPS, millis());
   }
   
   // Read battery voltage (through voltage divider)
+  sensors.batteryVoltage = readBatteryVoltage();
+}
+
+float readBatteryVoltage() {
   int adcValue = analogRead(A0);
-  sensors.batteryVoltage = (adcValue * 3.3 / 4095.0) * 4.0; // Voltage divider ratio
+  return (adcValue * 3.3 / 4095.0) * BATTERY_DIVIDER_RATIO;
+}
+
+void superviseBrownout() {
+  // Sampled every loop pass (~1ms) - INA219 sweeps are far too slow for this
+  float voltage = readBatteryVoltage();
+  if (brownoutVoltage == 0.0f) brownoutVoltage = voltage;
+  brownoutVoltage += BROWNOUT_FILTER_ALPHA * (voltage - brownoutVoltage);
+  windowStatAdd(telemetryWindow.packVoltage, brownoutVoltage);
+  
+  int previousTier = loadShedder.tier;
+  if (!loadShedderUpdate(loadShedder, brownoutVoltage, millis())) return;
+  
+  // Act now rather than on the next control tick
+  if (loadShedder.tier >= SHED_TIER_AUDIO) {
+    setAudioDeterrent(false);
+  }
+  if (loadShedder.tier >= SHED_TIER_SIDE_STROBES) {
+    ledcWrite(1, 0);
+    ledcWrite(3, 0);
+  }
+  if (loadShedder.tier >= SHED_TIER_PI_FRAMERATE && previousTier < SHED_TIER_PI_FRAMERATE) {
+    rpiSerial.print("{\"cmd\":\"max_fps\",\"value\":");
+    rpiSerial.print(PI_SHED_MAX_FPS);
+    rpiSerial.println("}");
+  } else if (loadShedder.tier < SHED_TIER_PI_FRAMERATE && previousTier >= SHED_TIER_PI_FRAMERATE) {
+    rpiSerial.println("{\"cmd\":\"max_fps\",\"value\":0}");
+  }
+  
+  Serial.print(loadShedder.tier > previousTier ? "BROWNOUT: shed to tier " : "Brownout: restored to tier ");
+  Serial.print(loadShedder.tier);
+  Serial.print(" at ");
+  Serial.print(brownoutVoltage);
+  Serial.println(" V");
+}
+
+void loadCalibration() {
+  calStore.begin("imucal", false);
+  accelFaceCalibratorInit(accelCalibrator);
+  
+  size_t bytesRead = calStore.getBytes("cal", &imuCal, sizeof(imuCal));
+  if (bytesRead == sizeof(imuCal) && imuCalibrationValid(imuCal)) {
+    calibrationFromNvs = true;
+    gyroBiasRefinerInit(gyroRefiner, imuCal);
+    Serial.println("IMU calibration loaded from NVS");
+    return;
+  }
+  
+  // Cold boot: capture gyro bias at rest; accel terms stay at defaults
+  // until the airframe has been rested on each of its six faces
+  Serial.println("No stored IMU calibration - capturing gyro bias, keep still");
+  imuCalibrationDefaults(imuCal);
+  
+  float gyroSum[3] = {0, 0, 0};
+  float tempSum = 0;
+  for (int i = 0; i < CAL_COLD_SAMPLES; i++) {
+    sensors_event_t a, g, temp;
+    mpu.getEvent(&a, &g, &temp);
+    gyroSum[0] += g.gyro.x;
+    gyroSum[1] += g.gyro.y;
+    gyroSum[2] += g.gyro.z;
+    tempSum += temp.temperature;
+    delay(5);
+  }
+  for (int i = 0; i < 3; i++) {
+    imuCal.gyroBias[i] = gyroSum[i] / CAL_COLD_SAMPLES;
+  }
+  imuCal.refTemperature = tempSum / CAL_COLD_SAMPLES;
+  imuCal.flags |= CAL_FLAG_GYRO_CALIBRATED;
+  
+  saveCalibration();
+}
+
+void saveCalibration() {
+  imuCalibrationSeal(imuCal);
+  calStore.putBytes("cal", &imuCal, sizeof(imuCal));
+  gyroBiasRefinerSaved(gyroRefiner, imuCal);
+  lastCalibrationSave = millis();
+}
+
+void persistCalibration() {
+  // NVS writes can stall for milliseconds - only in STANDBY, and rarely
+  if (!gyroRefiner.dirty || currentState != STATE_STANDBY) return;
+  if (millis() - lastCalibrationSave < CAL_SAVE_INTERVAL_MS) return;
+  
+  saveCalibration();
+  Serial.println("IMU calibration refined and saved to NVS");
 }
 
 void checkBirdDetection() {
@@ -297,15 +1242,21 @@ void checkBirdDetection() {
     DeserializationError error = deserializeJson(doc, jsonData);
     
     if (!error) {
+      healthPiMessage(health, millis());
       birdData.detected = doc["detected"];
       birdData.confidence = doc["confidence"];
       birdData.distance = doc["distance"];
       birdData.bearing = doc["bearing"];
       birdData.species = doc["species"];
       birdData.timestamp = millis();
+      if (birdData.detected) telemetryWindow.detections++;
       
       // Assess threat level based on detection data
       assessThreatLevel();
+      
+      float detectionRecord[6] = {(float)birdData.detected, (float)birdData.confidence, birdData.distance,
+                                  birdData.bearing, (float)birdData.species, (float)currentThreat};
+      frAppend(flightRecorder, FR_DETECTION, millis(), detectionRecord);
     }
   }
 }
@@ -333,9 +1284,9 @@ void assessThreatLevel() {
   else if (birdData.species == 3) threatScore += 10; // Crow
   
   // Determine threat level
-  if (threatScore >= 50) currentThreat = THREAT_HIGH;
-  else if (threatScore >= 30) currentThreat = THREAT_MEDIUM;
-  else if (threatScore >= 15) currentThreat = THREAT_LOW;
+  if (threatScore >= threatScoreHigh) currentThreat = THREAT_HIGH;
+  else if (threatScore >= threatScoreMedium) currentThreat = THREAT_MEDIUM;
+  else if (threatScore >= threatScoreLow) currentThreat = THREAT_LOW;
   else currentThreat = THREAT_NONE;
 }
 
@@ -348,14 +1299,22 @@ void updateSystemState() {
   switch (currentThreat) {
     case THREAT_NONE:
       currentState = STATE_STANDBY;
+      activeTimedOut = false;
       break;
     case THREAT_LOW:
       currentState = STATE_ALERT;
+      activeTimedOut = false;
       break;
     case THREAT_MEDIUM:
     case THREAT_HIGH:
-      currentState = STATE_ACTIVE;
-      deterrentActivationTime = millis();
+      // Stay in ALERT once the ACTIVE period has been used up, until the
+      // threat clears; otherwise the duration cap would never take effect
+      if (activeTimedOut) {
+        currentState = STATE_ALERT;
+      } else if (currentState != STATE_ACTIVE) {
+        currentState = STATE_ACTIVE;
+        deterrentActivationTime = millis();
+      }
       break;
   }
 }
@@ -370,18 +1329,20 @@ void controlDeterrents() {
       
     case STATE_ALERT:
       // Low-intensity LED strobes
-      setLEDStrobes(50); // 20% intensity
+      setLEDStrobes(alertStrobeIntensity); // 20% intensity by default
       setAudioDeterrent(false);
       break;
       
     case STATE_ACTIVE:
-      // Full deterrent activation
-      setLEDStrobes(255); // 100% intensity
-      setAudioDeterrent(true);
+      // Full deterrent activation, within the energy governor's caps
+      setLEDStrobes(energyGovernor.strobeCap); // 100% when unrestricted
+      setAudioDeterrent((millis() % AUDIO_DUTY_PERIOD_MS) <
+                        energyGovernor.audioDuty * AUDIO_DUTY_PERIOD_MS);
       
-      // Auto-deactivate after 60 seconds to conserve power
-      if (millis() - deterrentActivationTime > 60000) {
+      // Auto-deactivate after 60 seconds (less on a short budget) to conserve power
+      if (millis() - deterrentActivationTime > energyGovernor.activeDurationMs) {
         currentState = STATE_ALERT;
+        activeTimedOut = true;
       }
       break;
       
@@ -393,6 +1354,65 @@ void controlDeterrents() {
   }
 }
 
+void updateEnergyGovernor() {
+  static unsigned long lastUpdate = 0;
+  
+  if (millis() - lastUpdate < GOVERNOR_INTERVAL_MS) return;
+  float dt = (lastUpdate == 0) ? 0.0f : (millis() - lastUpdate) / 1000.0f;
+  lastUpdate = millis();
+  
+  // Remaining distance by dead reckoning at cruise speed while airborne
+  // (replace with GPS distance-to-destination once NMEA parsing exists)
+  if (!launchAltitudeSet && altitudeFilter.initialized) {
+    launchAltitude = sensors.altitude;
+    launchAltitudeSet = true;
+  }
+  if (launchAltitudeSet && sensors.altitude - launchAltitude > AIRBORNE_ALTITUDE_M) {
+    missionDistanceRemainingM -= CRUISE_SPEED_MS * dt;
+    if (missionDistanceRemainingM < 0.0f) missionDistanceRemainingM = 0.0f;
+  }
+  
+  // Learn the non-deterrent draw from STANDBY periods
+  float packPower = sensors.systemCurrent * powerStatus.voltage12V;
+  if (currentState == STATE_STANDBY && packPower > 0.0f) {
+    baselinePowerW += BASELINE_POWER_ALPHA * (packPower - baselinePowerW);
+  }
+  
+  if (!batterySoc.initialized) return;
+  
+  // Endurance to the mission reserve from per-state draw and recent duty
+  float usableAh = (batterySoc.soc - MISSION_RESERVE_FRACTION) * batterySoc.capacityAh;
+  endurancePredictorUpdate(endurance, currentState, sensors.systemCurrent, dt,
+                           usableAh, batterySoc.capacityAh, CRUISE_SPEED_MS);
+  
+  if (energyGovernorUpdate(energyGovernor, batterySoc.soc, batterySoc.capacityAh,
+                           missionDistanceRemainingM, baselinePowerW)) {
+    const char *reasons[] = {"unrestricted", "budget short", "budget exhausted"};
+    Serial.printf("Energy governor: %s (budget %.1f Wh, %.0f m to go) -> strobe cap %d, "
+                  "audio duty %.0f%%, ACTIVE %lus\n",
+                  reasons[energyGovernor.reason], energyGovernor.budgetWh,
+                  missionDistanceRemainingM, energyGovernor.strobeCap,
+                  energyGovernor.audioDuty * 100.0f, energyGovernor.activeDurationMs / 1000);
+  }
+}
+
+// State transitions and what the deterrents were actually driven with
+void recordControlOutputs() {
+  static SystemState recordedState = STATE_STANDBY;
+  static ThreatLevel recordedThreat = THREAT_NONE;
+  
+  if (currentState != recordedState || currentThreat != recordedThreat) {
+    float stateRecord[3] = {(float)recordedState, (float)currentState, (float)currentThreat};
+    frAppend(flightRecorder, FR_STATE, millis(), stateRecord);
+    recordedState = currentState;
+    recordedThreat = currentThreat;
+  }
+  
+  float actuatorRecord[6] = {(float)strobeOutput[0], (float)strobeOutput[1], (float)strobeOutput[2],
+                             (float)strobeOutput[3], (float)audioOutput, (float)loadShedder.tier};
+  frAppend(flightRecorder, FR_ACTUATORS, millis(), actuatorRecord);
+}
+
 void setLEDStrobes(int intensity) {
   // Create strobe pattern with phase offset for 360° coverage
   unsigned long time = millis();
@@ -402,15 +1422,32 @@ void setLEDStrobes(int intensity) {
   int phase2 = (sin(timeRad + PI/2) + 1.0) * intensity / 2;
   int phase3 = (sin(timeRad + PI) + 1.0) * intensity / 2;
   int phase4 = (sin(timeRad + 3*PI/2) + 1.0) * intensity / 2;
+  
+  // Side strobes (2 and 4) are the second brownout shed tier
+  if (loadShedder.tier >= SHED_TIER_SIDE_STROBES) {
+    phase2 = 0;
+    phase4 = 0;
+  }
 
   ledcWrite(0, phase1);
   ledcWrite(1, phase2);
   ledcWrite(2, phase3);
   ledcWrite(3, phase4);
+  
+  strobeOutput[0] = phase1;
+  strobeOutput[1] = phase2;
+  strobeOutput[2] = phase3;
+  strobeOutput[3] = phase4;
 }
 
 void setAudioDeterrent(bool enable) {
+  // Audio is the first load shed on a voltage sag
+  if (loadShedder.tier >= SHED_TIER_AUDIO) enable = false;
+  // Silenced from the ground, e.g. with people nearby
+  if (audioMuteMs > 0 && millis() - audioMuteStart < audioMuteMs) enable = false;
+  
   digitalWrite(AUDIO_ENABLE, enable);
+  audioOutput = enable;
   
   if (enable) {
     // Generate distress call pattern (simplified)
@@ -421,15 +1458,54 @@ void setAudioDeterrent(bool enable) {
   }
 }
 
+void publishPowerReadings() {
+  const Ina219Rail *rails = powerMonitor.rails;
+  
+  powerStatus.voltage12V = rails[0].voltage;
+  powerStatus.current12V = rails[0].current;
+  powerStatus.power12V = rails[0].power;
+  powerStatus.voltage5V = rails[1].voltage;
+  powerStatus.current5V = rails[1].current;
+  powerStatus.power5V = rails[1].power;
+  powerStatus.voltage3V3 = rails[2].voltage;
+  powerStatus.current3V3 = rails[2].current;
+  powerStatus.power3V3 = rails[2].power;
+  powerStatus.timestamp = powerMonitor.timestamp;
+  powerStatus.sweepI2cMicros = powerMonitor.lastSweepI2cMicros;
+  
+  // Pack current referred to the 12V bus, including converter losses
+  if (powerStatus.voltage12V > 1.0f) {
+    sensors.systemCurrent = (powerStatus.power12V +
+                             (powerStatus.power5V + powerStatus.power3V3) / DCDC_EFFICIENCY) /
+                            powerStatus.voltage12V;
+  }
+  
+  profileStats[profileState].i2cTransactions += powerMonitor.i2cTransactions - powerMonitorI2cCounted;
+  powerMonitorI2cCounted = powerMonitor.i2cTransactions;
+}
+
 void monitorPowerSystems() {
-  // Read power monitoring data from INA219 sensors
-  // This would interface with actual INA219 modules
+  // Latest INA219 sweep into powerStatus
+  publishPowerReadings();
+  
   powerStatus.totalPower = powerStatus.power12V + powerStatus.power5V + powerStatus.power3V3;
+  windowStatAdd(telemetryWindow.power, powerStatus.totalPower);
+  
+  // Average current per sample rate profile
+  profileStats[profileState].currentSumMa += sensors.systemCurrent * 1000.0f;
+  profileStats[profileState].currentSamples++;
+  
+  // Energy per state / actuator channel
+  accumulateEnergy();
+  
+  // Battery level from coulomb counting with OCV correction
+  updateBatterySoc();
+  powerStatus.batteryLevel = batterySoc.soc * 100.0f;
   
-  // Calculate battery level based on voltage
-  float minVoltage = 9.0; // 3S LiPo minimum safe voltage
-  float maxVoltage = 12.6; // 3S LiPo maximum voltage
-  powerStatus.batteryLevel = (sensors.batteryVoltage - minVoltage) / (maxVoltage - minVoltage) * 100;
+  float powerRecord[7] = {powerStatus.voltage12V, powerStatus.current12V, powerStatus.voltage5V,
+                          powerStatus.current5V, powerStatus.voltage3V3, powerStatus.current3V3,
+                          powerStatus.batteryLevel};
+  frAppend(flightRecorder, FR_POWER, millis(), powerRecord);
   
   // Low battery warning
   if (powerStatus.batteryLevel < 30) {
@@ -437,42 +1513,698 @@ void monitorPowerSystems() {
   }
 }
 
-void sendTelemetryData() {
-  DynamicJsonDocument doc(1024);
+void accumulateEnergy() {
+  unsigned long now = powerStatus.timestamp;
+  float dtHours = (energyProfile.lastSample == 0) ? 0.0f : (now - energyProfile.lastSample) / 3600000.0f;
+  energyProfile.lastSample = now;
+  if (dtHours <= 0.0f) return;
+  
+  float packWh = sensors.systemCurrent * powerStatus.voltage12V * dtHours;
+  energyProfile.stateWh[currentState] += packWh;
+  energyProfile.stateSeconds[currentState] += dtHours * 3600.0f;
+  energyProfile.totalWh += packWh;
+  
+  // Measured 12V rail energy split across the deterrents by commanded output
+  float weights[ENERGY_AUDIO + 1];
+  float weightSum = 0.0f;
+  for (int i = 0; i < 4; i++) {
+    weights[ENERGY_STROBE_1 + i] = strobeOutput[i] / 255.0f * STROBE_CHANNEL_POWER_W;
+    weightSum += weights[ENERGY_STROBE_1 + i];
+  }
+  weights[ENERGY_AUDIO] = audioOutput ? AUDIO_FULL_POWER_W : 0.0f;
+  weightSum += weights[ENERGY_AUDIO];
+  
+  float rail12Wh = powerStatus.power12V * dtHours;
+  if (weightSum > 0.0f) {
+    for (int i = ENERGY_STROBE_1; i <= ENERGY_AUDIO; i++) {
+      energyProfile.channelWh[i] += rail12Wh * weights[i] / weightSum;
+    }
+  } else {
+    energyProfile.channelWh[ENERGY_OTHER_12V] += rail12Wh;
+  }
+  energyProfile.channelWh[ENERGY_PI] += powerStatus.power5V / DCDC_EFFICIENCY * dtHours;
+  energyProfile.channelWh[ENERGY_CONTROLLER] += powerStatus.power3V3 / DCDC_EFFICIENCY * dtHours;
+}
+
+void logEnergyProfile() {
+  static unsigned long lastLog = 0;
+  
+  // Runs after reportRateProfiles(), so a requested dump ends here
+  if (!logDumpRequested && millis() - lastLog < ENERGY_LOG_INTERVAL_MS) return;
+  lastLog = millis();
+  logDumpRequested = false;
+  
+  // Cumulative record parsed by ground-station/energy_report.cpp:
+  // ENERGY,<ms>,<4 x state Wh>,<4 x state s>,<8 x channel Wh>
+  Serial.print("ENERGY,");
+  Serial.print(millis());
+  for (int i = 0; i < 4; i++) {
+    Serial.print(",");
+    Serial.print(energyProfile.stateWh[i], 4);
+  }
+  for (int i = 0; i < 4; i++) {
+    Serial.print(",");
+    Serial.print(energyProfile.stateSeconds[i], 1);
+  }
+  for (int i = 0; i < ENERGY_CHANNELS; i++) {
+    Serial.print(",");
+    Serial.print(energyProfile.channelWh[i], 4);
+  }
+  Serial.println();
+}
+
+void updateBatterySoc() {
+  // Prefer the INA219 bus voltage, fall back to the ADC divider
+  float packVoltage = powerMonitor.rails[0].present ? powerStatus.voltage12V : sensors.batteryVoltage;
+  float packCurrent = sensors.systemCurrent;
+  
+  if (!batterySoc.initialized && storedSoc >= 0.0f) {
+    // Keep the stored value unless the rested voltage says it is a different pack
+    float ocvSoc = batterySocFromVoltage(batterySoc, packVoltage, packCurrent);
+    if (fabs(ocvSoc - storedSoc) < SOC_RESTORE_TOLERANCE) {
+      batterySocSeed(batterySoc, storedSoc);
+      Serial.println("Battery SoC restored from NVS");
+    }
+    storedSoc = -1.0f;
+  }
   
-  doc["timestamp"] = millis();
-  doc["state"] = currentState;
-  doc["threat"] = currentThreat;
-  doc["battery"] = powerStatus.batteryLevel;
-  doc["power"] = powerStatus.totalPower;
-  doc["altitude"] = sensors.altitude;
-  doc["temperature"] = sensors.temperature;
+  float dt = (lastSocUpdate == 0) ? 0.0f : (millis() - lastSocUpdate) / 1000.0f;
+  lastSocUpdate = millis();
+  batterySocUpdate(batterySoc, packVoltage, packCurrent, dt);
+  
+  // Persist on 1% steps, outside engagements
+  if (currentState != STATE_ACTIVE && fabs(batterySoc.soc - lastSavedSoc) >= SOC_SAVE_STEP) {
+    socStore.putFloat("soc", batterySoc.soc);
+    lastSavedSoc = batterySoc.soc;
+  }
+}
+
+void buildTelemetrySnapshot(TelemetrySnapshot &t) {
+  t.type = TELEMETRY_STATUS;
+  t.sections = 0;
+  t.timeSeconds = millis() / 1000;
+  t.state = currentState;
+  t.threat = currentThreat;
+  t.battery = powerStatus.batteryLevel;
+  t.power = powerStatus.totalPower;
+  t.altitude = sensors.altitude;
+  t.verticalSpeed = sensors.verticalSpeed;
+  t.temperature = sensors.temperature;
   
   if (birdData.detected) {
-    doc["bird_detected"] = true;
-    doc["bird_confidence"] = birdData.confidence;
-    doc["bird_distance"] = birdData.distance;
+    t.sections |= TELEMETRY_SECTION_BIRD;
+    t.birdConfidence = birdData.confidence;
+    t.birdDistance = birdData.distance;
+    t.birdBearing = birdData.bearing;
+    t.birdSpecies = birdData.species;
+  }
+}
+
+void sendTelemetryData() {
+  // Bit-packed frame (telemetry_frame.h) - 11..20 bytes instead of ~180 of JSON
+  static unsigned long lastSlowSections = 0;
+  TelemetrySnapshot t;
+  buildTelemetrySnapshot(t);
+  
+  // Slow-moving sections once a second, whatever the sample rate
+  if (millis() - lastSlowSections >= LORA_STATUS_INTERVAL_MS) {
+    lastSlowSections = millis();
+    t.sections |= TELEMETRY_SECTION_ENDURANCE;
+    t.enduranceSeconds = endurance.timeRemaining;
+    t.enduranceLowSeconds = endurance.timeLow;
+    t.enduranceHighSeconds = endurance.timeHigh;
+    t.rangeMeters = endurance.rangeRemaining;
+    t.rangeLowMeters = endurance.rangeLow;
+    
+    if (loadShedder.shedEvents > 0) {
+      t.sections |= TELEMETRY_SECTION_POWER;
+      t.shedTier = loadShedder.tier;
+      t.shedEvents = loadShedder.shedEvents;
+    }
+    
+    if (health.flags != reportedHealthFlags || millis() - lastHealthReport >= HEALTH_REPORT_INTERVAL_MS) {
+      addHealthSection(t);
+    }
+  }
+  
+  telemetrySendStatus(t);
+}
+
+void addHealthSection(TelemetrySnapshot &t) {
+  t.sections |= TELEMETRY_SECTION_HEALTH;
+  t.healthFlags = health.flags;
+  t.freeHeapKb = health.freeHeap / 1024.0f;
+  t.i2cErrors = (uint8_t)(health.checkI2cErrors & 0xFF);
+  t.loraTxFailures = (uint8_t)(loraTxFailures & 0x3F);
+  t.loopOverruns = (uint8_t)(health.loopOverruns & 0xFF);
+  t.piRate = (uint8_t)constrain(health.piRate + 0.5f, 0.0f, 31.0f);
+  t.piAgeSeconds = (millis() - health.lastPiMs) / 1000.0f;
+  reportedHealthFlags = health.flags;
+  lastHealthReport = millis();
+}
+
+void queueTelemetryEvent(uint8_t code, uint8_t value) {
+  TelemetrySnapshot t;
+  buildTelemetrySnapshot(t);
+  t.type = TELEMETRY_EVENT;
+  t.sections |= TELEMETRY_SECTION_EVENT;
+  t.eventCode = code;
+  t.eventValue = value;
+  telemetrySendEvent(t);
+}
+
+// Transport-independent telemetry: status follows the selected link, and
+// while LoRa carries it ESP-NOW is probed with a copy so it can take over
+// once the ground node is in range
+uint16_t telemetryIntervalMs() {
+  if (transportSelector.link == TELEMETRY_LINK_LORA) return LORA_STATUS_INTERVAL_MS;
+  return constrain(activeProfile->imuIntervalMs, (uint16_t)ESPNOW_MIN_INTERVAL_MS, (uint16_t)ESPNOW_MAX_INTERVAL_MS);
+}
+
+void telemetrySendStatus(TelemetrySnapshot &t) {
+  if (transportSelector.link == TELEMETRY_LINK_ESPNOW) {
+    addEspNowSample(t);
+    return;
+  }
+  telemetryQueuePush(telemetryQueue, TELEMETRY_PRIORITY_STATUS, t, millis());
+  if (espNowRunning && addEspNowSample(t)) flushEspNowBatch();
+}
+
+// Events always take LoRa as well: rare, and acked end to end there
+void telemetrySendEvent(TelemetrySnapshot &t) {
+  if (transportSelector.link == TELEMETRY_LINK_ESPNOW && addEspNowSample(t)) flushEspNowBatch();
+  telemetryQueuePush(telemetryQueue, TELEMETRY_PRIORITY_EVENT, t, millis());
+  
+  // Don't leave an event waiting behind most of a routine status packet
+  if (loraTxBusy && loraTxPriority == TELEMETRY_PRIORITY_STATUS &&
+      millis() - loraTxStart + LORA_PREEMPT_MIN_MS < loraTxAirtimeMicros / 1000) {
+    LoRa.idle();
+    loraTxBusy = false;
+    loraTxPending = false;
+    linkAdapterCancel(linkAdapter);
+    loraTxPreemptions++;
+  }
+}
+
+void queueTelemetryEvents() {
+  static ThreatLevel reportedThreat = THREAT_NONE;
+  static SystemState reportedState = STATE_STANDBY;
+  
+  if (currentThreat > reportedThreat) queueTelemetryEvent(TELEMETRY_EVENT_THREAT, currentThreat);
+  reportedThreat = currentThreat;
+  if (currentThreat > telemetryWindow.maxThreat) telemetryWindow.maxThreat = currentThreat;
+  
+  if (currentState != reportedState) {
+    queueTelemetryEvent(TELEMETRY_EVENT_STATE, currentState);
+    telemetryWindow.stateChanges++;
+  }
+  reportedState = currentState;
+  
+  // Report once the peak has passed
+  if (strikeDetected && millis() - lastStrikeTime > CONTROL_INTERVAL_MS) {
+    queueTelemetryEvent(TELEMETRY_EVENT_STRIKE, (uint8_t)(strikePeakMss / GRAVITY_MSS + 0.5f));
+    strikeDetected = false;
+    strikePeakMss = 0.0f;
+  }
+}
+
+void packTelemetryWindow(TelemetrySnapshot &t) {
+  TelemetryWindow &win = telemetryWindow;
+  t.sections |= TELEMETRY_SECTION_WINDOW;
+  t.power = windowStatMean(win.power, t.power);
+  t.powerMin = win.power.count ? win.power.minimum : t.power;
+  t.powerMax = win.power.count ? win.power.maximum : t.power;
+  t.verticalSpeedMin = win.verticalSpeed.count ? win.verticalSpeed.minimum : t.verticalSpeed;
+  t.verticalSpeedMax = win.verticalSpeed.count ? win.verticalSpeed.maximum : t.verticalSpeed;
+  t.packVoltageMin = win.packVoltage.count ? win.packVoltage.minimum : brownoutVoltage;
+  t.maxThreat = win.maxThreat > t.threat ? win.maxThreat : t.threat;
+  t.detections = win.detections > 255 ? 255 : win.detections;
+  t.stateChanges = win.stateChanges > 255 ? 255 : win.stateChanges;
+  t.airtimeUsage = airtimeBudgetUsage(airtimeBudget) * 100.0f;
+}
+
+// Airtime the packet will take once clamped to the dwell limit and the
+// budget share it may use (transmitLoRaPacket applies the same clamp)
+uint32_t telemetryAirtime(const TelemetrySnapshot &t, float reserveFraction) {
+  TelemetryDeltaEncoder trial = telemetryDelta;
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  size_t length = telemetryDeltaEncode(trial, t, frame, sizeof(frame));
+  LoRaModulation mod = loraModulation;
+  mod.spreadingFactor = linkAdapter.spreadingFactor;
+  mod.spreadingFactor = airtimeShareSpreadingFactor(airtimeBudget, mod, length, reserveFraction);
+  return loraTimeOnAirMicros(mod, length);
+}
+
+void serviceTelemetryQueue() {
+  static unsigned long retryAt = 0;
+  if (loraTxBusy || loraTxPending) return;
+  if ((long)(millis() - retryAt) < 0) return;
+  
+  // Nothing goes out until the last frame's receive window is over, events
+  // included: transmitting would lose its ack
+  if (loraRxWindowMs > 0) return;
+  
+  int index = telemetryQueuePeek(telemetryQueue, millis());
+  
+  // Parity goes after events but ahead of the next status
+  if (fecParityPending > 0 &&
+      (index < 0 || telemetryQueue.entries[index].priority != TELEMETRY_PRIORITY_EVENT)) {
+    sendFecParity();
+    return;
+  }
+  if (index < 0) return;
+  
+  TelemetrySnapshot t = telemetryQueue.entries[index].snapshot;
+  int priority = telemetryQueue.entries[index].priority;
+  t.sequence = telemetrySequence;
+  
+  // Status carries everything seen since the previous status went out
+  if (priority == TELEMETRY_PRIORITY_STATUS) packTelemetryWindow(t);
+  
+  // Acknowledge the last uplink command in whatever goes out next
+  if (commandAckPending) {
+    t.sections |= TELEMETRY_SECTION_COMMAND;
+    t.commandCounter = commandAckCounter;
+    t.commandResult = commandAckResult;
+  }
+  
+  // Keep within the duty-cycle budget: status may not touch the event
+  // reserve and sheds its slow-moving sections first, then waits. It goes
+  // at an SF whose airtime fits its share, or a keyframe at SF12 (boot,
+  // link fallback) would wait forever and no ack could ever speed it up.
+  airtimeBudgetAdvance(airtimeBudget, millis());
+  float reserve = priority == TELEMETRY_PRIORITY_STATUS ? LORA_EVENT_RESERVE : 0.0f;
+  if (!airtimeBudgetAllows(airtimeBudget, telemetryAirtime(t, reserve), reserve)) {
+    const uint8_t sheddable[] = {TELEMETRY_SECTION_ENDURANCE | TELEMETRY_SECTION_POWER, TELEMETRY_SECTION_WINDOW};
+    bool fits = false;
+    for (int i = 0; i < 2 && !fits && priority == TELEMETRY_PRIORITY_STATUS; i++) {
+      t.sections &= ~sheddable[i];
+      fits = airtimeBudgetAllows(airtimeBudget, telemetryAirtime(t, reserve), reserve);
+    }
+    if (!fits) {
+      airtimeBudget.delayed++;
+      retryAt = millis() + LORA_BUDGET_RETRY_MS;
+      return;
+    }
+    airtimeBudget.shrunk++;
+  }
+  
+  // Encode before committing: a snapshot that fails leaves the sequence,
+  // the command ack and the window as they were. Every section together
+  // fits TELEMETRY_MAX_FRAME, so this only catches a frame layout bug.
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  size_t length = telemetryDeltaEncode(telemetryDelta, t, frame, sizeof(frame));
+  TelemetrySnapshot queued;
+  telemetryQueueTake(telemetryQueue, index, millis(), queued);
+  if (length == 0) {
+    Serial.println("Telemetry snapshot did not fit a frame - dropped");
+    return;
+  }
+  telemetrySequence++;
+  if (t.sections & TELEMETRY_SECTION_COMMAND) commandAckPending = false;
+  if (t.sections & TELEMETRY_SECTION_WINDOW) telemetryWindowReset(telemetryWindow);
+  
+  // Parity only earns its airtime while frames are actually being lost;
+  // the group shape can only change between groups
+  if (telemetryFec.count == 0) {
+    bool lossy = linkAdapterDeliveryRatio(linkAdapter) < TELEMETRY_FEC_DELIVERY;
+    telemetryFec.m = lossy ? TELEMETRY_FEC_PARITY : 0;
+  }
+  if (fecEncoderAdd(telemetryFec, t.sequence, frame, length)) {
+    // Built now: a following event would overwrite the group
+    for (int j = 0; j < telemetryFec.m; j++) {
+      fecParityLength[j] = (uint8_t)fecEncoderParity(telemetryFec, j, fecParity[j], sizeof(fecParity[j]));
+    }
+    fecParityPending = telemetryFec.m;
+    fecParityNext = 0;
+  }
+  
+  loraTxPriority = priority;
+  transmitLoRaPacket(frame, length, t.sequence, true, reserve);
+}
+
+// Next parity frame of the last group. Parity is not acked, and is dropped
+// rather than delayed when status may not spend the airtime.
+void sendFecParity() {
+  int j = fecParityNext++;
+  fecParityPending--;
+  
+  LoRaModulation mod = loraModulation;
+  mod.spreadingFactor = linkAdapter.spreadingFactor;
+  mod.spreadingFactor = airtimeShareSpreadingFactor(airtimeBudget, mod, fecParityLength[j], LORA_EVENT_RESERVE);
+  airtimeBudgetAdvance(airtimeBudget, millis());
+  if (fecParityLength[j] == 0 ||
+      !airtimeBudgetAllows(airtimeBudget, loraTimeOnAirMicros(mod, fecParityLength[j]), LORA_EVENT_RESERVE)) {
+    fecParityDropped++;
+    return;
   }
   
-  String telemetryString;
-  serializeJson(doc, telemetryString);
+  loraTxPriority = TELEMETRY_PRIORITY_STATUS;
+  transmitLoRaPacket(fecParity[j], fecParityLength[j], 0, false, LORA_EVENT_RESERVE);
+}
+
+void initializeEspNow() {
+  transportSelectorInit(transportSelector);
+  telemetryBatchClear(espNowBatch);
+  
+  Preferences store;
+  store.begin("espnow", true);
+  espNowConfigured = store.getBytes("peer", espNowPeer, sizeof(espNowPeer)) == sizeof(espNowPeer);
+  espNowChannel = store.getUChar("channel", ESPNOW_DEFAULT_CHANNEL);
+  store.end();
+  
+  if (!espNowConfigured) {
+    Serial.println("No ESP-NOW ground node in NVS - telemetry over LoRa only");
+    return;
+  }
+  if (startEspNow()) {
+    Serial.printf("ESP-NOW telemetry to %02X:%02X:%02X:%02X:%02X:%02X on channel %u\n", espNowPeer[0],
+                  espNowPeer[1], espNowPeer[2], espNowPeer[3], espNowPeer[4], espNowPeer[5], espNowChannel);
+  }
+}
+
+bool startEspNow() {
+  WiFi.mode(WIFI_STA);
+  esp_wifi_set_channel(espNowChannel, WIFI_SECOND_CHAN_NONE);
+  if (esp_now_init() != ESP_OK) {
+    Serial.println("ESP-NOW init failed - telemetry over LoRa only");
+    WiFi.mode(WIFI_OFF);
+    return false;
+  }
+  esp_now_register_send_cb(onEspNowSent);
+  esp_now_register_recv_cb(onEspNowReceive);
+  
+  esp_now_peer_info_t peer;
+  memset(&peer, 0, sizeof(peer));
+  memcpy(peer.peer_addr, espNowPeer, sizeof(espNowPeer));
+  peer.channel = espNowChannel;
+  peer.ifidx = WIFI_IF_STA;
+  peer.encrypt = false;  // Commands carry their own MAC (lora_uplink.h)
+  if (esp_now_add_peer(&peer) != ESP_OK) {
+    esp_now_deinit();
+    WiFi.mode(WIFI_OFF);
+    return false;
+  }
+  espNowInFlight = false;
+  espNowResultReady = false;
+  espNowRunning = true;
+  return true;
+}
+
+void stopEspNow() {
+  if (!espNowRunning) return;
+  esp_now_deinit();
+  WiFi.mode(WIFI_OFF);
+  espNowRunning = false;
+  espNowInFlight = false;
+  telemetryBatchClear(espNowBatch);
+  if (transportForceLoRa(transportSelector)) onTelemetryLinkChange();
+}
+
+// WiFi task context: just hand the result to serviceEspNow()
+void onEspNowSent(const uint8_t *mac, esp_now_send_status_t status) {
+  espNowAcked = status == ESP_NOW_SEND_SUCCESS;
+  espNowResultReady = true;
+}
+
+void onEspNowReceive(const uint8_t *mac, const uint8_t *data, int length) {
+  if (espNowRxLength != 0 || length != UPLINK_COMMAND_LENGTH || memcmp(mac, espNowPeer, sizeof(espNowPeer)) != 0) return;
+  memcpy(espNowRx, data, length);
+  espNowRxLength = length;
+}
+
+// Numbers the sample and adds it to the open batch, sending the batch
+// first if it is full. False if it had to be dropped.
+bool addEspNowSample(TelemetrySnapshot &t) {
+  if (!espNowRunning) return false;
+  t.sequence = espNowSampleSequence++;
+  
+  // The ground node relays commands too; acknowledge them on the same link
+  if (transportSelector.link == TELEMETRY_LINK_ESPNOW && commandAckPending) {
+    t.sections |= TELEMETRY_SECTION_COMMAND;
+    t.commandCounter = commandAckCounter;
+    t.commandResult = commandAckResult;
+  }
+  
+  if (!telemetryBatchAdd(espNowBatch, espNowBatchSequence, t, millis())) {
+    if (!flushEspNowBatch() || !telemetryBatchAdd(espNowBatch, espNowBatchSequence, t, millis())) {
+      espNowDropped++;
+      return false;
+    }
+  }
+  if (t.sections & TELEMETRY_SECTION_COMMAND) commandAckPending = false;
+  espNowSamples++;
+  return true;
+}
+
+bool flushEspNowBatch() {
+  if (!espNowRunning || espNowInFlight || espNowBatch.length == 0) return false;
+  
+  esp_err_t result = esp_now_send(espNowPeer, espNowBatch.data, espNowBatch.length);
+  telemetryBatchClear(espNowBatch);
+  espNowBatchSequence++;
+  if (result != ESP_OK) {
+    if (transportOnResult(transportSelector, false)) onTelemetryLinkChange();
+    return true;
+  }
+  espNowInFlight = true;
+  espNowSendStart = millis();
+  return true;
+}
+
+void serviceEspNow() {
+  if (!espNowRunning) return;
+  
+  if (espNowInFlight) {
+    bool timedOut = millis() - espNowSendStart > ESPNOW_SEND_TIMEOUT_MS;
+    if (espNowResultReady || timedOut) {
+      bool acked = espNowResultReady && espNowAcked;
+      espNowResultReady = false;
+      espNowInFlight = false;
+      if (transportOnResult(transportSelector, acked)) onTelemetryLinkChange();
+    }
+  }
+  
+  // Send once the oldest sample has waited long enough or no frame is sure to fit
+  if (espNowBatch.length > 0 &&
+      (millis() - espNowBatch.baseMs >= ESPNOW_BATCH_MS ||
+       espNowBatch.length + TELEMETRY_BATCH_ENTRY + TELEMETRY_MAX_FRAME > ESPNOW_MAX_PAYLOAD)) {
+    flushEspNowBatch();
+  }
+  
+  if (espNowRxLength > 0) {
+    handleUplinkCommand(espNowRx, espNowRxLength);
+    espNowRxLength = 0;
+  }
+}
+
+void onTelemetryLinkChange() {
+  bool espNow = transportSelector.link == TELEMETRY_LINK_ESPNOW;
+  Serial.printf("Telemetry link -> %s (%lu/%lu ESP-NOW sends acked, %lu samples, %lu dropped, %lu switches)\n",
+                espNow ? "ESP-NOW" : "LoRa", (unsigned long)transportSelector.acked,
+                (unsigned long)transportSelector.sent, (unsigned long)espNowSamples,
+                (unsigned long)espNowDropped, (unsigned long)transportSelector.switches);
+  if (!espNow) {
+    // ESP-NOW already delivered all of it at full rate
+    telemetryWindowReset(telemetryWindow);
+    lastTelemetryTime = 0;
+  }
+}
+
+void IRAM_ATTR onLoRaTxDone() {
+  loraTxBusy = false;
+}
+
+void IRAM_ATTR onLoRaReceive(int packetSize) {
+  loraRxLength = packetSize;
+}
+
+// Queue a packet and return at once; false if a packet is still in flight.
+// Packets sent without an ack expected leave the link adapter's delivery
+// tracking alone and go at the current settings. reserveFraction is the
+// share of the airtime budget the packet was priced to leave free.
+bool transmitLoRaPacket(const uint8_t *data, size_t length, uint8_t sequence, bool expectAck,
+                        float reserveFraction) {
+  if (loraTxBusy) {
+    loraTxBusySkips++;
+    return false;
+  }
+  
+  unsigned long start = micros();
+  
+  // Spreading factor and power for this packet from the last acks
+  if (expectAck) linkAdapterOnSend(linkAdapter, sequence);
+  if (linkAdapter.spreadingFactor != loraModulation.spreadingFactor) {
+    loraModulation.spreadingFactor = linkAdapter.spreadingFactor;
+    LoRa.setSpreadingFactor(loraModulation.spreadingFactor);
+  }
+  static int txPowerDbm = LINK_MAX_POWER_DBM;
+  if (linkAdapter.txPowerDbm != txPowerDbm) {
+    txPowerDbm = linkAdapter.txPowerDbm;
+    LoRa.setTxPower(txPowerDbm);
+  }
+  
+  // Never exceed the dwell limit or the budget share, whatever the link wants
+  uint8_t fitSf = airtimeShareSpreadingFactor(airtimeBudget, loraModulation, length, reserveFraction);
+  if (fitSf != loraModulation.spreadingFactor) {
+    loraModulation.spreadingFactor = fitSf;
+    LoRa.setSpreadingFactor(fitSf);
+    airtimeBudget.clamped++;
+  }
+  
+  loraTxAirtimeMicros = loraTimeOnAirMicros(loraModulation, length);
+  airtimeBudgetRecord(airtimeBudget, millis(), loraTxAirtimeMicros);
+  loraAirtimeSeconds += loraTxAirtimeMicros / 1e6f;
+  loraFixedAirtimeSeconds += loraTimeOnAirMicros(loraFixedModulation, length) / 1e6f;
+  loraTxStart = millis();
+  loraTxBusy = true;
+  loraTxPending = true;
   
-  // Send via LoRa
   LoRa.beginPacket();
-  LoRa.print(telemetryString);
-  LoRa.endPacket();
+  LoRa.write(data, length);
+  LoRa.endPacket(true); // Async - completion signalled on DIO0
+  
+  // Loop time lost to telemetry (previously the whole airtime)
+  telemetryStallMicros = micros() - start;
+  if (telemetryStallMicros > maxTelemetryStallMicros) maxTelemetryStallMicros = telemetryStallMicros;
+  return true;
+}
+
+void serviceLoRaTx() {
+  if (!loraTxPending) return;
+  
+  if (!loraTxBusy) {
+    loraTxCompleted++;
+    loraTxPending = false;
+    
+    // Listen just long enough for the ground's ack and a command
+    LoRaModulation downlink = loraModulation;
+    loraRxWindowMs = LORA_RX_TURNAROUND_MS + LORA_RX_MARGIN_MS +
+                     loraTimeOnAirMicros(downlink, LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH) / 1000;
+    loraRxWindowStart = millis();
+    LoRa.receive();
+    return;
+  }
+  
+  // A missed DIO0 interrupt would otherwise block telemetry for good
+  if (millis() - loraTxStart > loraTxAirtimeMicros / 1000 + LORA_TX_TIMEOUT_MARGIN_MS) {
+    LoRa.idle();
+    loraTxBusy = false;
+    loraTxPending = false;
+    loraTxFailures++;
+    Serial.println("LoRa TX timed out - radio reset to idle");
+  }
+}
+
+void serviceLoRaRx() {
+  int length = loraRxLength;
+  if (length == 0) {
+    // Window over with nothing heard: sleep the radio until the next TX
+    if (loraRxWindowMs > 0 && !loraTxBusy && millis() - loraRxWindowStart > loraRxWindowMs) {
+      LoRa.sleep();
+      loraRxWindowMs = 0;
+    }
+    return;
+  }
+  loraRxLength = 0;
+  loraRxWindowMs = 0;
+  
+  // Empty the FIFO first: sleep clears it
+  uint8_t packet[LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH];
+  int received = 0;
+  while (LoRa.available()) {
+    int b = LoRa.read();
+    if (received < (int)sizeof(packet)) packet[received] = (uint8_t)b;
+    received++;
+  }
+  LoRa.sleep();
+  
+  if (received != length || received < LINK_ACK_LENGTH) return;
+  
+  LinkAck ack;
+  if (linkAckDecode(packet, LINK_ACK_LENGTH, ack)) {
+    linkAdapterOnAck(linkAdapter, ack, linkAdapter.txPowerDbm);
+    telemetryDeltaOnAck(telemetryDelta, ack.sequence);
+  }
+  if (received == LINK_ACK_LENGTH + UPLINK_COMMAND_LENGTH) {
+    handleUplinkCommand(packet + LINK_ACK_LENGTH, UPLINK_COMMAND_LENGTH);
+  }
+}
+
+void handleUplinkCommand(const uint8_t *data, size_t length) {
+  UplinkCommand cmd;
+  switch (uplinkReceive(uplink, data, length, cmd)) {
+    case UPLINK_IGNORE:
+      return;
+    case UPLINK_APPLY:
+      // Counter first: a reset mid-command must not let it be replayed
+      uplinkStore.putUShort("counter", cmd.counter);
+      uplinkReceiverDone(uplink, applyUplinkCommand(cmd));
+      commandAckResult = uplink.lastResult;
+      break;
+    case UPLINK_ACK_REPEAT:
+      commandAckResult = uplink.lastResult;
+      break;
+    case UPLINK_ACK_STALE:
+      commandAckResult = UPLINK_STALE;
+      break;
+  }
+  commandAckCounter = uplink.lastCounter;
+  commandAckPending = true;
+}
+
+uint8_t applyUplinkCommand(const UplinkCommand &cmd) {
+  uint8_t result = uplinkValidate(cmd);
+  if (result != UPLINK_OK) return result;
+  
+  switch (cmd.opcode) {
+    case UPLINK_MUTE_AUDIO:
+      audioMuteStart = millis();
+      audioMuteMs = cmd.value * 1000UL;
+      if (audioMuteMs > 0) setAudioDeterrent(false);
+      break;
+    case UPLINK_SET_PARAM:
+      switch (cmd.parameter) {
+        case UPLINK_PARAM_THREAT_LOW:    threatScoreLow = cmd.value; break;
+        case UPLINK_PARAM_THREAT_MEDIUM: threatScoreMedium = cmd.value; break;
+        case UPLINK_PARAM_THREAT_HIGH:   threatScoreHigh = cmd.value; break;
+        case UPLINK_PARAM_ALERT_STROBE:  alertStrobeIntensity = cmd.value; break;
+      }
+      break;
+    case UPLINK_LOG_DUMP:
+      logDumpRequested = true;
+      break;
+  }
+  
+  Serial.printf("Uplink command %u: opcode %u, parameter %u, value %d\n",
+                cmd.counter, cmd.opcode, cmd.parameter, cmd.value);
+  return UPLINK_OK;
 }
 
 void performHealthCheck() {
-  // System health monitoring
+  // Counters are kept as things happen; folding them into flags is cheap
+  // enough for once a second (see the CPU share in reportRateProfiles)
   static unsigned long lastHealthCheck = 0;
   
-  if (millis() - lastHealthCheck >= 5000) { // Every 5 seconds
-    // Check sensor connectivity
-    // Check power levels
-    // Check communication status
-    // Log any issues
-    
-    lastHealthCheck = millis();
+  if (millis() - lastHealthCheck < HEALTH_CHECK_INTERVAL_MS) return;
+  lastHealthCheck = millis();
+  unsigned long start = micros();
+  
+  uint32_t powerI2cErrors = 0;
+  for (int i = 0; i < INA219_NUM_RAILS; i++) powerI2cErrors += powerMonitor.rails[i].i2cErrors;
+  uint16_t previous = health.flags;
+  uint16_t flags = healthEvaluate(health, millis(), powerMonitor.i2cTransactions, powerI2cErrors,
+                                  loraTxFailures, ESP.getFreeHeap());
+  
+  // Log what changed; the flags go out with the next status packet
+  if (flags != previous) {
+    Serial.print("Health:");
+    for (int f = 0; f < HEALTH_FLAG_COUNT; f++) {
+      if (!((flags ^ previous) & (1 << f))) continue;
+      Serial.printf(" %c%s", (flags & (1 << f)) ? '+' : '-', HEALTH_FLAG_NAMES[f]);
+    }
+    Serial.println();
   }
+  
+  healthBusyMicros += micros() - start;
 }
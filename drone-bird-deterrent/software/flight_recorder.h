@@ -0,0 +1,599 @@
+/*
+ * Black-Box Flight Recorder
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Append-only log in a raw flash partition. The control loop appends
+ * records into per-signal column blocks in RAM and never touches flash;
+ * a full block is packed into the open page of a RAM ring and a
+ * background task drains sealed pages to flash one 256-byte page per
+ * write. The partition is used as a circular log of 4 KB sectors, oldest
+ * overwritten first, so every sector is erased once per lap (even wear)
+ * and the newest ~25 minutes at full rate are always on board.
+ *
+ * Sector (4 KB, 16 pages):
+ *   page 0     header: magic, sector sequence, erase count, boot, CRC-32
+ *   page 1-15  block pages
+ * Block page (256 bytes):
+ *   0-1   payload length          0xFFFF = never written
+ *   2-3   0
+ *   4-7   time the page was opened, ms since boot
+ *   8-11  CRC-32 of bytes 0-7 and the payload
+ *   12-   blocks, back to back
+ * Block, samples of one record type stored column-wise:
+ *   0     record type
+ *   1     sample count
+ *   2-5   time of the first sample, ms since boot
+ *   6-    directory: byte length of each column, time first, then fields
+ *         columns, each an MSB-first bit stream starting on a byte
+ * Time column: delta-of-delta against the previous sample, Gorilla
+ * buckets 0 / 10+7 / 110+9 / 1110+12 / 1111+32 bits. Field columns: the
+ * float32 of each int16 code (value / scale per FR_LAYOUTS) XORed with the
+ * previous one - 0 when unchanged, 10 + meaningful bits inside the
+ * previous leading / trailing zero window, or 11 + 5-bit leading zeros +
+ * 5-bit length - 1 + meaningful bits. Encoding the integer code rather
+ * than the scaled value keeps the low mantissa bits zero, which is what
+ * the XOR scheme lives on. A reader pulls one channel by stepping over
+ * blocks of other types on their directories and decoding only the time
+ * column and that field's column.
+ *
+ * Power loss: flash only ever goes from erased to written, a page is
+ * written once, and a page or header whose CRC fails is skipped by the
+ * reader. Every boot starts a fresh sector after the newest one found, so
+ * recovery only reads sector headers and a torn page is never appended
+ * to. What is lost is RAM: blocks and pages are sealed after at most
+ * FR_FLUSH_MS, and the drain keeps up well within that.
+ *
+ * Flash access goes through RecorderFlash so the same code runs against
+ * the ESP32 partition API and a host file / RAM image.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+#define FR_SECTOR_SIZE          4096
+#define FR_PAGE_SIZE            256
+#define FR_PAGES_PER_SECTOR     (FR_SECTOR_SIZE / FR_PAGE_SIZE)
+#define FR_PAGE_HEADER          12
+#define FR_SECTOR_HEADER        20
+#define FR_SECTOR_MAGIC         0x32584242UL  // "BBX2"
+#define FR_RAM_PAGES            32            // 8 KB, ~2 s at full rate
+#define FR_FLUSH_MS             500           // Max age of unsealed samples
+#define FR_MAX_FIELDS           8
+#define FR_BLOCK_HEADER         6             // Before the column directory
+#define FR_BLOCK_SAMPLES        255           // Sample count is one byte
+#define FR_MIN_BLOCK_ROOM       48            // Page is sealed with less room left
+#define FR_COLUMN_BYTES         (FR_PAGE_SIZE - FR_PAGE_HEADER - FR_BLOCK_HEADER)
+
+enum FlightRecordType {
+  FR_IMU = 0,               // Calibrated accel / gyro, every IMU sample
+  FR_ALTITUDE = 1,          // Baro and fused altitude, attitude, every baro sample
+  FR_POWER = 2,             // INA219 rails and SoC, every sweep
+  FR_DETECTION = 3,         // Every message from the Pi
+  FR_STATE = 4,             // State / threat transitions
+  FR_ACTUATORS = 5,         // Deterrent outputs, every control tick
+  FR_RECORD_TYPES = 6
+};
+
+// Fields are stored as int16 codes of value / scale
+struct FlightRecordLayout {
+  const char *name;
+  uint8_t fields;
+  const char *fieldNames[FR_MAX_FIELDS];
+  float scale[FR_MAX_FIELDS];
+};
+
+static const FlightRecordLayout FR_LAYOUTS[FR_RECORD_TYPES] = {
+  {"imu", 6, {"ax", "ay", "az", "gx", "gy", "gz"},
+   {0.01f, 0.01f, 0.01f, 0.001f, 0.001f, 0.001f}},                       // m/s^2, rad/s
+  {"altitude", 6, {"baro_alt", "alt", "vspeed", "roll", "pitch", "temperature"},
+   {0.1f, 0.1f, 0.01f, 0.001f, 0.001f, 0.01f}},                          // m, m/s, rad, degC
+  {"power", 7, {"v12", "i12", "v5", "i5", "v3v3", "i3v3", "soc"},
+   {0.001f, 0.001f, 0.001f, 0.001f, 0.001f, 0.001f, 0.01f}},             // V, A, %
+  {"detection", 6, {"detected", "confidence", "distance", "bearing", "species", "threat"},
+   {1.0f, 1.0f, 0.1f, 0.1f, 1.0f, 1.0f}},                                // %, m, deg
+  {"state", 3, {"from", "to", "threat"}, {1.0f, 1.0f, 1.0f}},
+  {"actuators", 6, {"strobe1", "strobe2", "strobe3", "strobe4", "audio", "shed_tier"},
+   {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f}}
+};
+
+struct RecorderFlash {
+  void *context;
+  uint32_t size;            // Bytes
+  bool (*read)(void *context, uint32_t offset, void *data, size_t length);
+  bool (*write)(void *context, uint32_t offset, const void *data, size_t length);
+  bool (*erase)(void *context, uint32_t offset, size_t length);
+};
+
+struct RecorderSectorHeader {
+  uint32_t sequence;        // Increases by one per sector written, never wraps in practice
+  uint32_t eraseCount;
+  uint32_t boot;
+};
+
+// One column of an open block and its encoder state
+struct RecorderColumn {
+  uint8_t data[FR_COLUMN_BYTES];
+  uint16_t bits;
+  uint32_t previous;        // Float bits of the last code
+  uint8_t lead, trail;      // XOR window; lead 0xFF = none yet
+};
+
+// Open block of one record type: column 0 is time, then the fields
+struct RecorderBlock {
+  uint8_t count;
+  uint32_t baseMs;
+  uint32_t lastMs;
+  int32_t lastDelta;
+  RecorderColumn columns[FR_MAX_FIELDS + 1];
+};
+
+struct FlightRecorder {
+  RecorderFlash flash;
+  uint32_t sectors;
+  bool ready;
+
+  // Flash position, drain side only
+  uint32_t sector;
+  uint32_t page;            // Next page in sector, FR_PAGES_PER_SECTOR when full
+  uint32_t sequence;
+  uint32_t boot;
+
+  // Loop side: open blocks, packed into the ring the drain task writes out
+  RecorderBlock blocks[FR_RECORD_TYPES];
+  uint8_t ring[FR_RAM_PAGES][FR_PAGE_SIZE];
+  std::atomic<uint32_t> sealed;
+  std::atomic<uint32_t> drained;
+  bool pageOpen;            // ring[sealed % FR_RAM_PAGES] is being filled
+  uint16_t pageLength;
+  uint32_t pageBaseMs;
+
+  uint32_t records, dropped;
+  uint32_t pagesWritten, sectorsErased, flashErrors;
+  uint32_t maxEraseCount;
+  uint32_t lastEraseCount;  // Of the newest sector
+};
+
+inline uint32_t frCrc32(const uint8_t *data, size_t length, uint32_t crc = 0) {
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+  }
+  return ~crc;
+}
+
+inline void frPut16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+inline void frPut32(uint8_t *p, uint32_t v) {
+  for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+inline uint16_t frGet16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t frGet32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline bool frParseSectorHeader(const uint8_t *p, RecorderSectorHeader &h) {
+  if (frGet32(p) != FR_SECTOR_MAGIC || frGet32(p + 16) != frCrc32(p, 16)) return false;
+  h.sequence = frGet32(p + 4);
+  h.eraseCount = frGet32(p + 8);
+  h.boot = frGet32(p + 12);
+  return true;
+}
+
+// Payload length of a stored page, -1 if never written or torn
+inline int frPagePayload(const uint8_t *page, uint32_t &baseMs) {
+  uint16_t length = frGet16(page);
+  if (length == 0xFFFF || length > FR_PAGE_SIZE - FR_PAGE_HEADER) return -1;
+  uint32_t crc = frCrc32(page, 8);
+  crc = frCrc32(page + FR_PAGE_HEADER, length, crc);
+  if (crc != frGet32(page + 8)) return -1;
+  baseMs = frGet32(page + 4);
+  return length;
+}
+
+// Erase the next sector and stamp its header. Drain side.
+inline bool frStartSector(FlightRecorder &rec) {
+  rec.sector = (rec.sector + 1) % rec.sectors;
+  uint32_t offset = rec.sector * FR_SECTOR_SIZE;
+
+  // Carry the erase count across the erase; a sector whose header was
+  // lost to a power cut takes the count of the sector before it
+  uint8_t header[FR_SECTOR_HEADER];
+  RecorderSectorHeader old;
+  uint32_t eraseCount = 0;
+  if (rec.flash.read(rec.flash.context, offset, header, sizeof(header))) {
+    if (frParseSectorHeader(header, old)) {
+      eraseCount = old.eraseCount;
+    } else if (frGet32(header) != 0xFFFFFFFFUL) {
+      eraseCount = rec.lastEraseCount;
+    }
+  }
+  eraseCount++;
+
+  rec.page = FR_PAGES_PER_SECTOR;  // Unusable until stamped
+  if (!rec.flash.erase(rec.flash.context, offset, FR_SECTOR_SIZE)) {
+    rec.flashErrors++;
+    return false;
+  }
+  rec.sectorsErased++;
+  rec.lastEraseCount = eraseCount;
+  if (eraseCount > rec.maxEraseCount) rec.maxEraseCount = eraseCount;
+
+  rec.sequence++;
+  frPut32(header, FR_SECTOR_MAGIC);
+  frPut32(header + 4, rec.sequence);
+  frPut32(header + 8, eraseCount);
+  frPut32(header + 12, rec.boot);
+  frPut32(header + 16, frCrc32(header, 16));
+  if (!rec.flash.write(rec.flash.context, offset, header, sizeof(header))) {
+    rec.flashErrors++;
+    return false;
+  }
+  rec.page = 1;
+  return true;
+}
+
+// Find the newest sector and start this boot in the one after it
+inline bool frInit(FlightRecorder &rec, const RecorderFlash &flash) {
+  rec.flash = flash;
+  rec.sectors = flash.size / FR_SECTOR_SIZE;
+  rec.ready = false;
+  rec.sealed.store(0);
+  rec.drained.store(0);
+  for (int t = 0; t < FR_RECORD_TYPES; t++) rec.blocks[t].count = 0;
+  rec.pageOpen = false;
+  rec.pageLength = 0;
+  rec.pageBaseMs = 0;
+  rec.records = rec.dropped = 0;
+  rec.pagesWritten = rec.sectorsErased = rec.flashErrors = 0;
+  rec.maxEraseCount = rec.lastEraseCount = 0;
+  rec.sequence = 0;
+  rec.boot = 0;
+  rec.sector = rec.sectors - 1;    // So an empty partition starts at sector 0
+  if (rec.sectors < 2) return false;
+
+  bool found = false;
+  for (uint32_t s = 0; s < rec.sectors; s++) {
+    uint8_t header[FR_SECTOR_HEADER];
+    RecorderSectorHeader h;
+    if (!rec.flash.read(rec.flash.context, s * FR_SECTOR_SIZE, header, sizeof(header))) return false;
+    if (!frParseSectorHeader(header, h)) continue;
+    if (h.eraseCount > rec.maxEraseCount) rec.maxEraseCount = h.eraseCount;
+    if (h.boot >= rec.boot) rec.boot = h.boot;
+    if (!found || h.sequence > rec.sequence) {
+      rec.sequence = h.sequence;
+      rec.sector = s;
+      rec.lastEraseCount = h.eraseCount;
+      found = true;
+    }
+  }
+  rec.boot = found ? rec.boot + 1 : 1;
+  rec.ready = frStartSector(rec);
+  return rec.ready;
+}
+
+// Append n bits, MSB first. With column NULL only the size is wanted.
+inline int frPutBits(RecorderColumn *column, uint32_t value, int n) {
+  if (column) {
+    for (int i = n - 1; i >= 0; i--) {
+      uint16_t bit = column->bits++;
+      if ((bit & 7) == 0) column->data[bit >> 3] = 0;
+      if ((value >> i) & 1) column->data[bit >> 3] |= (uint8_t)(0x80 >> (bit & 7));
+    }
+  }
+  return n;
+}
+
+// Delta-of-delta of the sample time; bits used, written when write is set
+inline int frEncodeTime(RecorderBlock &block, uint32_t nowMs, bool write) {
+  RecorderColumn *out = write ? &block.columns[0] : NULL;
+  int32_t delta = (int32_t)(nowMs - block.lastMs);
+  int32_t dod = delta - block.lastDelta;
+  int bits;
+  if (dod == 0) {
+    bits = frPutBits(out, 0, 1);
+  } else if (dod >= -63 && dod <= 64) {
+    bits = frPutBits(out, 0x2, 2) + frPutBits(out, (uint32_t)(dod + 63), 7);
+  } else if (dod >= -255 && dod <= 256) {
+    bits = frPutBits(out, 0x6, 3) + frPutBits(out, (uint32_t)(dod + 255), 9);
+  } else if (dod >= -2047 && dod <= 2048) {
+    bits = frPutBits(out, 0xE, 4) + frPutBits(out, (uint32_t)(dod + 2047), 12);
+  } else {
+    bits = frPutBits(out, 0xF, 4) + frPutBits(out, (uint32_t)dod, 32);
+  }
+  if (write) {
+    block.lastMs = nowMs;
+    block.lastDelta = delta;
+  }
+  return bits;
+}
+
+// XOR of the float bits against the previous value in the column
+inline int frEncodeValue(RecorderColumn &column, uint32_t value, bool write) {
+  RecorderColumn *out = write ? &column : NULL;
+  uint32_t x = value ^ column.previous;
+  if (x == 0) return frPutBits(out, 0, 1);
+
+  int lead = __builtin_clz(x);
+  int trail = __builtin_ctz(x);
+  if (column.lead != 0xFF && lead >= column.lead && trail >= column.trail) {
+    int n = 32 - column.lead - column.trail;
+    int bits = frPutBits(out, 0x2, 2) + frPutBits(out, x >> column.trail, n);
+    if (write) column.previous = value;
+    return bits;
+  }
+  int n = 32 - lead - trail;
+  int bits = frPutBits(out, 0x3, 2) + frPutBits(out, (uint32_t)lead, 5) + frPutBits(out, (uint32_t)(n - 1), 5) +
+             frPutBits(out, x >> trail, n);
+  if (write) {
+    column.previous = value;
+    column.lead = (uint8_t)lead;
+    column.trail = (uint8_t)trail;
+  }
+  return bits;
+}
+
+// Bytes a block takes in a page
+inline size_t frBlockBytes(const RecorderBlock &block, uint8_t type) {
+  size_t bytes = FR_BLOCK_HEADER + FR_LAYOUTS[type].fields + 1;
+  for (int c = 0; c <= FR_LAYOUTS[type].fields; c++) bytes += (block.columns[c].bits + 7) / 8;
+  return bytes;
+}
+
+// Hand the open page to the drain. Loop side.
+inline void frSealPage(FlightRecorder &rec) {
+  if (!rec.pageOpen) return;
+  uint32_t index = rec.sealed.load(std::memory_order_relaxed);
+  uint8_t *page = rec.ring[index % FR_RAM_PAGES];
+  uint16_t payload = (uint16_t)(rec.pageLength - FR_PAGE_HEADER);
+  frPut16(page, payload);
+  frPut16(page + 2, 0);
+  frPut32(page + 4, rec.pageBaseMs);
+  uint32_t crc = frCrc32(page, 8);
+  frPut32(page + 8, frCrc32(page + FR_PAGE_HEADER, payload, crc));
+  memset(page + rec.pageLength, 0xFF, FR_PAGE_SIZE - rec.pageLength);  // Left erased
+  rec.pageOpen = false;
+  rec.sealed.store(index + 1, std::memory_order_release);
+}
+
+// Pack a block into the open page, starting a new one if it does not
+// fit. Loop side; with the ring full the block is dropped and its records
+// counted.
+inline void frSealBlock(FlightRecorder &rec, uint8_t type) {
+  RecorderBlock &block = rec.blocks[type];
+  if (block.count == 0) return;
+  size_t bytes = frBlockBytes(block, type);
+  if (rec.pageOpen && rec.pageLength + bytes > FR_PAGE_SIZE) frSealPage(rec);
+  if (!rec.pageOpen) {
+    uint32_t sealed = rec.sealed.load(std::memory_order_relaxed);
+    if (sealed - rec.drained.load(std::memory_order_acquire) >= FR_RAM_PAGES) {
+      rec.dropped += block.count;
+      block.count = 0;
+      return;
+    }
+    rec.pageOpen = true;
+    rec.pageLength = FR_PAGE_HEADER;
+    rec.pageBaseMs = block.baseMs;
+  }
+
+  uint8_t *p = rec.ring[rec.sealed.load(std::memory_order_relaxed) % FR_RAM_PAGES] + rec.pageLength;
+  int columns = FR_LAYOUTS[type].fields + 1;
+  p[0] = type;
+  p[1] = block.count;
+  frPut32(p + 2, block.baseMs);
+  uint8_t *column = p + FR_BLOCK_HEADER + columns;
+  for (int c = 0; c < columns; c++) {
+    uint8_t length = (uint8_t)((block.columns[c].bits + 7) / 8);
+    p[FR_BLOCK_HEADER + c] = length;
+    memcpy(column, block.columns[c].data, length);
+    column += length;
+  }
+  rec.pageLength = (uint16_t)(rec.pageLength + bytes);
+  block.count = 0;
+  if (FR_PAGE_SIZE - rec.pageLength < FR_MIN_BLOCK_ROOM) frSealPage(rec);
+}
+
+// Seal every open block and the page. Loop side.
+inline void frSeal(FlightRecorder &rec) {
+  for (uint8_t t = 0; t < FR_RECORD_TYPES; t++) frSealBlock(rec, t);
+  frSealPage(rec);
+}
+
+// Seal everything once the oldest unsealed sample has waited long enough
+inline void frSealIfOlder(FlightRecorder &rec, uint32_t nowMs, uint32_t maxAgeMs) {
+  bool old = rec.pageOpen && nowMs - rec.pageBaseMs >= maxAgeMs;
+  for (uint8_t t = 0; t < FR_RECORD_TYPES; t++) {
+    if (rec.blocks[t].count > 0 && nowMs - rec.blocks[t].baseMs >= maxAgeMs) old = true;
+  }
+  if (old) frSeal(rec);
+}
+
+// Append one record of FR_LAYOUTS[type].fields values to its block. Loop
+// side; never touches flash and never blocks.
+inline bool frAppend(FlightRecorder &rec, uint8_t type, uint32_t nowMs, const float *values) {
+  if (!rec.ready || type >= FR_RECORD_TYPES) return false;
+  const FlightRecordLayout &layout = FR_LAYOUTS[type];
+  RecorderBlock &block = rec.blocks[type];
+
+  uint32_t codes[FR_MAX_FIELDS];
+  for (int f = 0; f < layout.fields; f++) {
+    float code = values[f] / layout.scale[f];
+    code += code < 0.0f ? -0.5f : 0.5f;
+    if (code > 32767.0f) code = 32767.0f;
+    if (code < -32768.0f) code = -32768.0f;
+    float stored = (float)(int16_t)code;
+    memcpy(&codes[f], &stored, sizeof(stored));
+  }
+
+  // Seal first if the block would outgrow the room left in the open page
+  if (block.count > 0) {
+    size_t bytes = FR_BLOCK_HEADER + layout.fields + 1;
+    bytes += (block.columns[0].bits + frEncodeTime(block, nowMs, false) + 7) / 8;
+    for (int f = 0; f < layout.fields; f++) {
+      RecorderColumn &column = block.columns[f + 1];
+      bytes += (column.bits + frEncodeValue(column, codes[f], false) + 7) / 8;
+    }
+    size_t room = rec.pageOpen ? FR_PAGE_SIZE - rec.pageLength : FR_PAGE_SIZE - FR_PAGE_HEADER;
+    if (bytes > room || block.count >= FR_BLOCK_SAMPLES) frSealBlock(rec, type);
+  }
+  if (block.count == 0) {
+    block.baseMs = block.lastMs = nowMs;
+    block.lastDelta = 0;
+    for (int c = 0; c <= layout.fields; c++) {
+      block.columns[c].bits = 0;
+      block.columns[c].previous = 0;
+      block.columns[c].lead = 0xFF;
+    }
+  }
+
+  frEncodeTime(block, nowMs, true);
+  for (int f = 0; f < layout.fields; f++) frEncodeValue(block.columns[f + 1], codes[f], true);
+  block.count++;
+  rec.records++;
+  return true;
+}
+
+// Write up to maxPages sealed pages to flash. Drain side; returns pages written.
+inline int frDrain(FlightRecorder &rec, int maxPages) {
+  int written = 0;
+  while (rec.ready && written < maxPages) {
+    uint32_t index = rec.drained.load(std::memory_order_relaxed);
+    if (index == rec.sealed.load(std::memory_order_acquire)) break;
+    if (rec.page >= FR_PAGES_PER_SECTOR && !frStartSector(rec)) break;  // Retried next call
+
+    uint32_t offset = rec.sector * FR_SECTOR_SIZE + rec.page * FR_PAGE_SIZE;
+    if (!rec.flash.write(rec.flash.context, offset, rec.ring[index % FR_RAM_PAGES], FR_PAGE_SIZE)) {
+      rec.flashErrors++;
+    } else {
+      rec.pagesWritten++;
+    }
+    rec.page++;              // A failed page is skipped, not rewritten
+    rec.drained.store(index + 1, std::memory_order_release);
+    written++;
+  }
+  return written;
+}
+
+// Reading side, on pages that passed frPagePayload
+
+// One block of a stored page
+struct RecorderBlockView {
+  const uint8_t *data;
+  uint8_t type;
+  uint8_t count;
+  uint32_t baseMs;
+};
+
+// Step to the next block of a page, reading only its header and
+// directory. offset starts at 0; false at the end or on a malformed block.
+inline bool frNextBlock(const uint8_t *page, int payload, size_t &offset, RecorderBlockView &block) {
+  const uint8_t *p = page + FR_PAGE_HEADER + offset;
+  if (payload < 0 || offset + FR_BLOCK_HEADER > (size_t)payload || p[0] >= FR_RECORD_TYPES) return false;
+  int columns = FR_LAYOUTS[p[0]].fields + 1;
+  size_t length = FR_BLOCK_HEADER + columns;
+  if (offset + length > (size_t)payload) return false;
+  for (int c = 0; c < columns; c++) length += p[FR_BLOCK_HEADER + c];
+  if (offset + length > (size_t)payload) return false;
+  block.data = p;
+  block.type = p[0];
+  block.count = p[1];
+  block.baseMs = frGet32(p + 2);
+  offset += length;
+  return true;
+}
+
+struct RecorderBitReader {
+  const uint8_t *data;
+  size_t bits, limit;
+};
+
+inline uint32_t frGetBits(RecorderBitReader &r, int n) {
+  uint32_t value = 0;
+  for (int i = 0; i < n; i++) {
+    uint32_t bit = 0;
+    if (r.bits < r.limit) bit = (r.data[r.bits >> 3] >> (7 - (r.bits & 7))) & 1;
+    r.bits++;
+    value = (value << 1) | bit;
+  }
+  return value;
+}
+
+// Position a reader on one column (0 = time, f + 1 = field f) without
+// touching the others
+inline bool frOpenColumn(const RecorderBlockView &block, int column, RecorderBitReader &r) {
+  if (column < 0 || column > FR_LAYOUTS[block.type].fields) return false;
+  const uint8_t *directory = block.data + FR_BLOCK_HEADER;
+  size_t offset = FR_BLOCK_HEADER + FR_LAYOUTS[block.type].fields + 1;
+  for (int c = 0; c < column; c++) offset += directory[c];
+  r.data = block.data + offset;
+  r.bits = 0;
+  r.limit = directory[column] * 8;
+  return true;
+}
+
+// Sample times of a block, ms since boot; returns the sample count or -1
+inline int frDecodeTimes(const RecorderBlockView &block, uint32_t *ms) {
+  RecorderBitReader r;
+  if (!frOpenColumn(block, 0, r)) return -1;
+  uint32_t last = block.baseMs;
+  int32_t delta = 0;
+  for (int i = 0; i < block.count; i++) {
+    int32_t dod;
+    if (frGetBits(r, 1) == 0) {
+      dod = 0;
+    } else if (frGetBits(r, 1) == 0) {
+      dod = (int32_t)frGetBits(r, 7) - 63;
+    } else if (frGetBits(r, 1) == 0) {
+      dod = (int32_t)frGetBits(r, 9) - 255;
+    } else if (frGetBits(r, 1) == 0) {
+      dod = (int32_t)frGetBits(r, 12) - 2047;
+    } else {
+      dod = (int32_t)frGetBits(r, 32);
+    }
+    delta += dod;
+    last += (uint32_t)delta;
+    ms[i] = last;
+  }
+  return r.bits <= r.limit ? block.count : -1;
+}
+
+// One field of every sample in a block, scaled back to units; returns the
+// sample count or -1
+inline int frDecodeChannel(const RecorderBlockView &block, int field, float *values) {
+  RecorderBitReader r;
+  if (!frOpenColumn(block, field + 1, r)) return -1;
+  float scale = FR_LAYOUTS[block.type].scale[field];
+  uint32_t previous = 0;
+  int lead = 0, length = 0;
+  for (int i = 0; i < block.count; i++) {
+    if (frGetBits(r, 1) == 1) {
+      if (frGetBits(r, 1) == 1) {
+        lead = (int)frGetBits(r, 5);
+        length = (int)frGetBits(r, 5) + 1;
+      }
+      int trail = 32 - lead - length;
+      if (length == 0 || trail < 0) return -1;
+      previous ^= frGetBits(r, length) << trail;
+    }
+    float code;
+    memcpy(&code, &previous, sizeof(code));
+    values[i] = code * scale;
+  }
+  return r.bits <= r.limit ? block.count : -1;
+}
+
+#endif
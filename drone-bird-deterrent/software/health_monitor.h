@@ -0,0 +1,196 @@
+/*
+ * System Health Monitor
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Bookkeeping is a store or an increment on paths that already run: each
+ * good sensor sample, I2C transaction, Pi message and loop pass. Once per
+ * HEALTH_CHECK_INTERVAL_MS the counts are folded into a bitmask of
+ * HEALTH_* flags, each judged over the interval just ended:
+ *   IMU / baro / GPS stale   no good sample for the sensor's limit
+ *   I2C errors               error ratio above HEALTH_I2C_ERROR_RATIO
+ *   Pi silent                no detection message for HEALTH_PI_SILENT_MS
+ *   Pi slow                  fewer than HEALTH_PI_MIN_RATE messages per s
+ *   LoRa TX failing          a transmission lost (TX-done never came)
+ *   loop overrun             HEALTH_LOOP_OVERRUN_RUN passes in a row, or
+ *                            more than HEALTH_LOOP_OVERRUN_RATIO of them,
+ *                            longer than their deadline (a lone slow pass
+ *                            - a report burst, an NVS commit - is not one)
+ *   low heap                 free heap below HEALTH_MIN_FREE_HEAP
+ * The counters behind them are cumulative, so the ground can take rates
+ * across lost packets (telemetry_frame.h health section).
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef HEALTH_MONITOR_H
+#define HEALTH_MONITOR_H
+
+#include <stdint.h>
+
+#define HEALTH_CHECK_INTERVAL_MS  1000
+#define HEALTH_IMU_STALE_MS       250     // 5x the slowest profile's IMU interval
+#define HEALTH_BARO_STALE_MS      2000
+#define HEALTH_GPS_STALE_MS       3000
+#define HEALTH_I2C_ERROR_RATIO    0.01f
+#define HEALTH_PI_SILENT_MS       1000    // Pi sends every frame, detection or not
+#define HEALTH_PI_MIN_RATE        2.0f    // Messages/s; brownout shedding caps it at 5
+#define HEALTH_MIN_FREE_HEAP      32768   // Bytes
+#define HEALTH_LOOP_OVERRUN_RUN   3       // Consecutive passes past the deadline
+#define HEALTH_LOOP_OVERRUN_RATIO 0.05f   // Of the interval's passes
+
+#define HEALTH_IMU_STALE          0x001
+#define HEALTH_BARO_STALE         0x002
+#define HEALTH_GPS_STALE          0x004
+#define HEALTH_I2C_ERRORS         0x008
+#define HEALTH_PI_SILENT          0x010
+#define HEALTH_PI_SLOW            0x020
+#define HEALTH_LORA_TX_FAILING    0x040
+#define HEALTH_LOOP_OVERRUN       0x080
+#define HEALTH_LOW_HEAP           0x100
+#define HEALTH_FLAG_COUNT         9
+
+static const char *const HEALTH_FLAG_NAMES[HEALTH_FLAG_COUNT] = {
+  "imu_stale", "baro_stale", "gps_stale", "i2c_errors", "pi_silent", "pi_slow",
+  "lora_tx_failing", "loop_overrun", "low_heap"
+};
+
+enum HealthSensor {
+  HEALTH_SENSOR_IMU,
+  HEALTH_SENSOR_BARO,
+  HEALTH_SENSOR_GPS,
+  HEALTH_SENSORS
+};
+
+static const uint32_t HEALTH_STALE_MS[HEALTH_SENSORS] = {
+  HEALTH_IMU_STALE_MS, HEALTH_BARO_STALE_MS, HEALTH_GPS_STALE_MS
+};
+
+struct HealthMonitor {
+  uint16_t flags;
+  uint32_t lastGoodMs[HEALTH_SENSORS];
+
+  // Cumulative
+  uint32_t i2cTransactions;
+  uint32_t i2cErrors;
+  uint32_t piMessages;
+  uint32_t loopPasses;
+  uint32_t loopOverruns;
+  uint32_t maxLoopMicros;
+
+  uint32_t lastPiMs;
+  float piRate;                     // Messages/s over the last interval
+  float i2cErrorRatio;              // Over the last interval
+  uint32_t overrunRun;              // Passes past the deadline in a row
+  uint32_t longestOverrunRun;       // Over the current interval
+  uint32_t freeHeap, minFreeHeap;   // Bytes
+
+  // At the previous evaluation
+  uint32_t checkMs;
+  uint32_t checkI2cTransactions, checkI2cErrors;
+  uint32_t checkPiMessages;
+  uint32_t checkLoraTxFailures;
+  uint32_t checkLoopPasses, checkLoopOverruns;
+
+  uint32_t checks;
+  uint32_t flagRaises;              // Flags going from clear to set
+};
+
+inline void healthMonitorInit(HealthMonitor &h, uint32_t nowMs) {
+  h.flags = 0;
+  // A sensor that never reports turns stale one limit after boot
+  for (int s = 0; s < HEALTH_SENSORS; s++) h.lastGoodMs[s] = nowMs;
+  h.i2cTransactions = h.i2cErrors = 0;
+  h.piMessages = 0;
+  h.loopPasses = h.loopOverruns = 0;
+  h.maxLoopMicros = 0;
+  h.lastPiMs = nowMs;
+  h.piRate = 0.0f;
+  h.i2cErrorRatio = 0.0f;
+  h.overrunRun = h.longestOverrunRun = 0;
+  h.freeHeap = h.minFreeHeap = 0;
+  h.checkMs = nowMs;
+  h.checkI2cTransactions = h.checkI2cErrors = 0;
+  h.checkPiMessages = 0;
+  h.checkLoraTxFailures = 0;
+  h.checkLoopPasses = h.checkLoopOverruns = 0;
+  h.checks = 0;
+  h.flagRaises = 0;
+}
+
+inline void healthSensorGood(HealthMonitor &h, HealthSensor sensor, uint32_t nowMs) {
+  h.lastGoodMs[sensor] = nowMs;
+}
+
+inline void healthI2c(HealthMonitor &h, uint32_t transactions, bool ok) {
+  h.i2cTransactions += transactions;
+  if (!ok) h.i2cErrors++;
+}
+
+inline void healthPiMessage(HealthMonitor &h, uint32_t nowMs) {
+  h.piMessages++;
+  h.lastPiMs = nowMs;
+}
+
+inline void healthLoopPass(HealthMonitor &h, uint32_t micros, uint32_t deadlineMicros) {
+  if (micros > h.maxLoopMicros) h.maxLoopMicros = micros;
+  h.loopPasses++;
+  if (micros > deadlineMicros) {
+    h.loopOverruns++;
+    if (++h.overrunRun > h.longestOverrunRun) h.longestOverrunRun = h.overrunRun;
+  } else {
+    h.overrunRun = 0;
+  }
+}
+
+// Flags for the interval since the previous call. I2C counts of drivers
+// that keep their own (cumulative) are added to those reported through
+// healthI2c(); LoRa TX failures are cumulative too. Returns the flags.
+inline uint16_t healthEvaluate(HealthMonitor &h, uint32_t nowMs, uint32_t otherI2cTransactions,
+                               uint32_t otherI2cErrors, uint32_t loraTxFailures, uint32_t freeHeap) {
+  uint16_t flags = 0;
+  for (int s = 0; s < HEALTH_SENSORS; s++) {
+    if (nowMs - h.lastGoodMs[s] > HEALTH_STALE_MS[s]) flags |= (uint16_t)(1 << s);
+  }
+
+  uint32_t transactions = h.i2cTransactions + otherI2cTransactions;
+  uint32_t errors = h.i2cErrors + otherI2cErrors;
+  uint32_t intervalTransactions = transactions - h.checkI2cTransactions;
+  uint32_t intervalErrors = errors - h.checkI2cErrors;
+  h.i2cErrorRatio = intervalTransactions ? (float)intervalErrors / intervalTransactions : 0.0f;
+  if (intervalErrors > 0 && h.i2cErrorRatio > HEALTH_I2C_ERROR_RATIO) flags |= HEALTH_I2C_ERRORS;
+
+  uint32_t elapsedMs = nowMs - h.checkMs;
+  h.piRate = elapsedMs ? (h.piMessages - h.checkPiMessages) * 1000.0f / elapsedMs : 0.0f;
+  if (nowMs - h.lastPiMs > HEALTH_PI_SILENT_MS) {
+    flags |= HEALTH_PI_SILENT;
+  } else if (h.piRate < HEALTH_PI_MIN_RATE) {
+    flags |= HEALTH_PI_SLOW;
+  }
+
+  if (loraTxFailures != h.checkLoraTxFailures) flags |= HEALTH_LORA_TX_FAILING;
+  uint32_t intervalPasses = h.loopPasses - h.checkLoopPasses;
+  uint32_t intervalOverruns = h.loopOverruns - h.checkLoopOverruns;
+  if (h.longestOverrunRun >= HEALTH_LOOP_OVERRUN_RUN ||
+      (intervalOverruns > 0 && intervalOverruns > intervalPasses * HEALTH_LOOP_OVERRUN_RATIO)) {
+    flags |= HEALTH_LOOP_OVERRUN;
+  }
+
+  h.freeHeap = freeHeap;
+  if (h.minFreeHeap == 0 || freeHeap < h.minFreeHeap) h.minFreeHeap = freeHeap;
+  if (freeHeap < HEALTH_MIN_FREE_HEAP) flags |= HEALTH_LOW_HEAP;
+
+  for (uint16_t raised = flags & ~h.flags; raised; raised &= raised - 1) h.flagRaises++;
+  h.flags = flags;
+  h.checkMs = nowMs;
+  h.checkI2cTransactions = transactions;
+  h.checkI2cErrors = errors;
+  h.checkPiMessages = h.piMessages;
+  h.checkLoraTxFailures = loraTxFailures;
+  h.checkLoopPasses = h.loopPasses;
+  h.checkLoopOverruns = h.loopOverruns;
+  h.longestOverrunRun = h.overrunRun;
+  h.checks++;
+  return flags;
+}
+
+#endif
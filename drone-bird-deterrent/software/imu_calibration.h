@@ -0,0 +1,251 @@
+/*
+ * IMU / Barometer Calibration
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Calibration coefficients are kept in one POD record so the controller can
+ * load them from NVS with a single getBytes() at boot. Gyro bias is modelled
+ * as bias(T) = gyroBias + gyroTempCoeff * (T - refTemperature) and refined
+ * online (normalised LMS) whenever the airframe is stationary.
+ *
+ * Accelerometer offset and scale come from a six-position calibration:
+ * resting the airframe on each of its six faces puts +1g and -1g on every
+ * axis. Faces are captured whenever it sits still on one, so the procedure
+ * is turning it over on the bench. The barometer needs no terms here: the
+ * BMP280 applies its factory temperature compensation itself.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef IMU_CALIBRATION_H
+#define IMU_CALIBRATION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#define IMU_CAL_MAGIC            0x43414C31UL  // "CAL1"
+#define IMU_CAL_VERSION          2
+
+// Stationary detection
+#define CAL_STATIONARY_GYRO      0.03f   // rad/s, after bias removal
+#define CAL_STATIONARY_ACCEL     0.35f   // m/s^2 deviation from 1g
+#define CAL_STATIONARY_SAMPLES   50      // consecutive samples before refining
+
+// Online refinement
+#define CAL_BIAS_TIME_CONSTANT   20.0f   // s
+#define CAL_TEMPCO_MIN_DELTA     2.0f    // degC away from reference to learn tempco
+#define CAL_TEMPCO_LIMIT         0.005f  // rad/s per degC
+#define CAL_BIAS_SAVE_THRESHOLD  0.002f  // rad/s change worth persisting
+#define CAL_TEMPCO_SAVE_THRESHOLD 0.0001f // rad/s/degC change worth persisting
+
+// Six-position accelerometer calibration
+#define CAL_ACCEL_FACE_SAMPLES   200     // Still samples averaged per face
+#define CAL_ACCEL_FACE_TOLERANCE 1.5f    // m/s^2 off 1g on the vertical axis
+#define CAL_ACCEL_MAX_OFFSET     2.0f    // m/s^2, sanity limit on the result
+#define CAL_ACCEL_MAX_SCALE_ERROR 0.1f   // Sanity limit on |scale - 1|
+
+struct ImuCalibration {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t flags;
+  float gyroBias[3];        // rad/s at refTemperature
+  float gyroTempCoeff[3];   // rad/s per degC
+  float accelOffset[3];     // m/s^2
+  float accelScale[3];
+  float refTemperature;     // degC (IMU die temperature)
+  uint32_t checksum;        // FNV-1a over everything above
+};
+
+#define CAL_FLAG_GYRO_CALIBRATED   0x0001
+#define CAL_FLAG_ACCEL_CALIBRATED  0x0002
+
+inline uint32_t imuCalibrationChecksum(const ImuCalibration &cal) {
+  const uint8_t *bytes = (const uint8_t *)&cal;
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < offsetof(ImuCalibration, checksum); i++) {
+    hash ^= bytes[i];
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+inline void imuCalibrationDefaults(ImuCalibration &cal) {
+  cal.magic = IMU_CAL_MAGIC;
+  cal.version = IMU_CAL_VERSION;
+  cal.flags = 0;
+  for (int i = 0; i < 3; i++) {
+    cal.gyroBias[i] = 0.0f;
+    cal.gyroTempCoeff[i] = 0.0f;
+    cal.accelOffset[i] = 0.0f;
+    cal.accelScale[i] = 1.0f;
+  }
+  cal.refTemperature = 25.0f;
+  cal.checksum = imuCalibrationChecksum(cal);
+}
+
+inline bool imuCalibrationValid(const ImuCalibration &cal) {
+  return cal.magic == IMU_CAL_MAGIC &&
+         cal.version == IMU_CAL_VERSION &&
+         cal.checksum == imuCalibrationChecksum(cal);
+}
+
+inline void imuCalibrationSeal(ImuCalibration &cal) {
+  cal.checksum = imuCalibrationChecksum(cal);
+}
+
+inline float imuCalibrationGyroBias(const ImuCalibration &cal, int axis, float temperature) {
+  return cal.gyroBias[axis] + cal.gyroTempCoeff[axis] * (temperature - cal.refTemperature);
+}
+
+// In-place correction of raw gyro (rad/s) and accel (m/s^2) vectors
+inline void imuCalibrationApply(const ImuCalibration &cal, float gyro[3], float accel[3], float temperature) {
+  for (int i = 0; i < 3; i++) {
+    gyro[i] -= imuCalibrationGyroBias(cal, i, temperature);
+    accel[i] = (accel[i] - cal.accelOffset[i]) * cal.accelScale[i];
+  }
+}
+
+// Background gyro bias refinement
+struct GyroBiasRefiner {
+  int stationaryCount;
+  float savedBias[3];   // values at last persist, to decide when to save again
+  float savedTempCoeff[3];
+  bool dirty;
+};
+
+// Call after the record has been written to NVS
+inline void gyroBiasRefinerSaved(GyroBiasRefiner &ref, const ImuCalibration &cal) {
+  for (int i = 0; i < 3; i++) {
+    ref.savedBias[i] = cal.gyroBias[i];
+    ref.savedTempCoeff[i] = cal.gyroTempCoeff[i];
+  }
+  ref.dirty = false;
+}
+
+inline void gyroBiasRefinerInit(GyroBiasRefiner &ref, const ImuCalibration &cal) {
+  ref.stationaryCount = 0;
+  gyroBiasRefinerSaved(ref, cal);
+}
+
+// Feed one raw (uncorrected) IMU sample. Returns true while the airframe is
+// considered stationary and the bias is being refined.
+inline bool gyroBiasRefinerUpdate(GyroBiasRefiner &ref, ImuCalibration &cal,
+                                  const float rawGyro[3], const float rawAccel[3],
+                                  float temperature, float dt) {
+  float accelNorm = sqrtf(rawAccel[0] * rawAccel[0] + rawAccel[1] * rawAccel[1] +
+                          rawAccel[2] * rawAccel[2]);
+  bool still = fabsf(accelNorm - 9.80665f) < CAL_STATIONARY_ACCEL;
+  for (int i = 0; i < 3 && still; i++) {
+    still = fabsf(rawGyro[i] - imuCalibrationGyroBias(cal, i, temperature)) < CAL_STATIONARY_GYRO;
+  }
+
+  if (!still) {
+    ref.stationaryCount = 0;
+    return false;
+  }
+  if (ref.stationaryCount < CAL_STATIONARY_SAMPLES) {
+    ref.stationaryCount++;
+    return false;
+  }
+
+  float alpha = dt / CAL_BIAS_TIME_CONSTANT;
+  if (alpha > 1.0f) alpha = 1.0f;
+  float deltaT = temperature - cal.refTemperature;
+
+  for (int i = 0; i < 3; i++) {
+    float error = rawGyro[i] - imuCalibrationGyroBias(cal, i, temperature);
+    if (fabsf(deltaT) >= CAL_TEMPCO_MIN_DELTA) {
+      // Away from the reference temperature the error is mostly tempco;
+      // normalised LMS step moves the predicted bias by alpha * error
+      float k = cal.gyroTempCoeff[i] + alpha * error / deltaT;
+      if (k > CAL_TEMPCO_LIMIT) k = CAL_TEMPCO_LIMIT;
+      if (k < -CAL_TEMPCO_LIMIT) k = -CAL_TEMPCO_LIMIT;
+      cal.gyroTempCoeff[i] = k;
+    } else {
+      cal.gyroBias[i] += alpha * error;
+    }
+    if (fabsf(cal.gyroBias[i] - ref.savedBias[i]) > CAL_BIAS_SAVE_THRESHOLD ||
+        fabsf(cal.gyroTempCoeff[i] - ref.savedTempCoeff[i]) > CAL_TEMPCO_SAVE_THRESHOLD) {
+      ref.dirty = true;
+    }
+  }
+  cal.flags |= CAL_FLAG_GYRO_CALIBRATED;
+  return true;
+}
+
+// Six-position accelerometer calibration, faces indexed axis * 2 + (down ? 1 : 0)
+struct AccelFaceCalibrator {
+  int face;                 // Face the airframe is resting on, -1 if none
+  int settled;              // Still samples on it so far
+  float faceSum[6];         // Raw reading on the vertical axis
+  int faceCount[6];
+};
+
+inline void accelFaceCalibratorInit(AccelFaceCalibrator &acc) {
+  acc.face = -1;
+  acc.settled = 0;
+  for (int f = 0; f < 6; f++) {
+    acc.faceSum[f] = 0.0f;
+    acc.faceCount[f] = 0;
+  }
+}
+
+// Feed one raw (uncorrected) IMU sample. Returns true when the sixth face
+// completes and a sane offset and scale have been written to cal.
+inline bool accelFaceCalibratorUpdate(AccelFaceCalibrator &acc, ImuCalibration &cal,
+                                      const float rawGyro[3], const float rawAccel[3],
+                                      float temperature) {
+  // Gyro stillness only: the accel norm test of the bias refiner would
+  // reject the very scale errors being calibrated out
+  bool still = true;
+  for (int i = 0; i < 3 && still; i++) {
+    still = fabsf(rawGyro[i] - imuCalibrationGyroBias(cal, i, temperature)) < CAL_STATIONARY_GYRO;
+  }
+  int axis = 0;
+  for (int i = 1; i < 3; i++) {
+    if (fabsf(rawAccel[i]) > fabsf(rawAccel[axis])) axis = i;
+  }
+  int face = -1;
+  if (still && fabsf(fabsf(rawAccel[axis]) - 9.80665f) < CAL_ACCEL_FACE_TOLERANCE) {
+    face = axis * 2 + (rawAccel[axis] < 0.0f ? 1 : 0);
+  }
+
+  if (face < 0 || face != acc.face) {
+    acc.face = face;
+    acc.settled = 0;
+    return false;
+  }
+  if (acc.settled < CAL_STATIONARY_SAMPLES) {
+    acc.settled++;
+    return false;
+  }
+  if (acc.faceCount[face] < CAL_ACCEL_FACE_SAMPLES) {
+    acc.faceSum[face] += rawAccel[axis];
+    acc.faceCount[face]++;
+  }
+  for (int f = 0; f < 6; f++) {
+    if (acc.faceCount[f] < CAL_ACCEL_FACE_SAMPLES) return false;
+  }
+
+  // All six: offset is the midpoint of +1g and -1g, scale maps the span to 2g
+  float offset[3], scale[3];
+  bool sane = true;
+  for (int i = 0; i < 3; i++) {
+    float up = acc.faceSum[i * 2] / acc.faceCount[i * 2];
+    float down = acc.faceSum[i * 2 + 1] / acc.faceCount[i * 2 + 1];
+    offset[i] = 0.5f * (up + down);
+    scale[i] = 2.0f * 9.80665f / (up - down);
+    sane = sane && fabsf(offset[i]) < CAL_ACCEL_MAX_OFFSET && fabsf(scale[i] - 1.0f) < CAL_ACCEL_MAX_SCALE_ERROR;
+  }
+  accelFaceCalibratorInit(acc);  // A later pass over the faces starts over
+  if (!sane) return false;
+
+  for (int i = 0; i < 3; i++) {
+    cal.accelOffset[i] = offset[i];
+    cal.accelScale[i] = scale[i];
+  }
+  cal.flags |= CAL_FLAG_ACCEL_CALIBRATED;
+  return true;
+}
+
+#endif
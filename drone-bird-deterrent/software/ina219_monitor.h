@@ -0,0 +1,189 @@
+/*
+ * Multi-rail INA219 Power Monitor
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Register-level INA219 driver for the 12V / 5V / 3V3 rail monitors.
+ * Each sweep triggers a single-shot conversion on every rail, then the
+ * service call polls the conversion-ready (CNVR) bit on each loop pass and
+ * reads the result as soon as it is available - no fixed delays, so the
+ * main loop never blocks on the ADC.
+ */
+
+#ifndef INA219_MONITOR_H
+#define INA219_MONITOR_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Registers
+#define INA219_REG_CONFIG       0x00
+#define INA219_REG_SHUNT        0x01
+#define INA219_REG_BUS          0x02
+#define INA219_REG_POWER        0x03
+#define INA219_REG_CURRENT      0x04
+#define INA219_REG_CALIBRATION  0x05
+
+// Config fields
+#define INA219_BRNG_32V         (1 << 13)
+#define INA219_PGA_80MV         (1 << 11)
+#define INA219_PGA_320MV        (3 << 11)
+#define INA219_BADC_12BIT_8S    (0x0B << 7)  // 4.26ms
+#define INA219_SADC_12BIT_8S    (0x0B << 3)
+#define INA219_MODE_TRIGGERED   0x03         // Shunt + bus, single shot
+
+// Bus voltage register flags
+#define INA219_BUS_CNVR         0x0002
+#define INA219_BUS_OVF          0x0001
+
+#define INA219_NUM_RAILS        3
+#define INA219_SWEEP_TIMEOUT_MS 20           // Give up on a rail after this
+
+struct Ina219Rail {
+  uint8_t address;
+  float currentLsb;     // A per bit
+  uint16_t calibration;
+  uint16_t config;      // Written to trigger a conversion
+  bool present;
+  bool ready;           // Result read for the current sweep
+  float voltage, current, power;
+  uint32_t i2cErrors;
+  uint32_t overflows;
+};
+
+struct PowerMonitor {
+  Ina219Rail rails[INA219_NUM_RAILS];
+  bool sweepActive;
+  unsigned long sweepStart;      // millis() at trigger
+  unsigned long sweepI2cMicros;  // I2C time spent in the current sweep
+  unsigned long lastSweepI2cMicros;
+  unsigned long maxSweepI2cMicros;
+  unsigned long timestamp;       // millis() when the last sweep completed
+  uint32_t sweeps;
+  uint32_t timeouts;
+  uint32_t i2cTransactions;
+};
+
+// Rail order: 0 = 12V (battery bus), 1 = 5V, 2 = 3V3
+inline void ina219RailSetup(Ina219Rail &rail, uint8_t address, float shuntOhms,
+                            float currentLsb, uint16_t gain) {
+  rail.address = address;
+  rail.currentLsb = currentLsb;
+  rail.calibration = (uint16_t)(0.04096f / (currentLsb * shuntOhms));
+  rail.config = INA219_BRNG_32V | gain | INA219_BADC_12BIT_8S |
+                INA219_SADC_12BIT_8S | INA219_MODE_TRIGGERED;
+  rail.present = false;
+  rail.ready = false;
+  rail.voltage = rail.current = rail.power = 0.0f;
+  rail.i2cErrors = 0;
+  rail.overflows = 0;
+}
+
+inline bool ina219WriteRegister(PowerMonitor &mon, Ina219Rail &rail, uint8_t reg, uint16_t value) {
+  unsigned long start = micros();
+  Wire.beginTransmission(rail.address);
+  Wire.write(reg);
+  Wire.write((uint8_t)(value >> 8));
+  Wire.write((uint8_t)(value & 0xFF));
+  bool ok = Wire.endTransmission() == 0;
+  mon.sweepI2cMicros += micros() - start;
+  mon.i2cTransactions++;
+  if (!ok) rail.i2cErrors++;
+  return ok;
+}
+
+inline bool ina219ReadRegister(PowerMonitor &mon, Ina219Rail &rail, uint8_t reg, uint16_t &value) {
+  unsigned long start = micros();
+  Wire.beginTransmission(rail.address);
+  Wire.write(reg);
+  bool ok = Wire.endTransmission() == 0 && Wire.requestFrom(rail.address, (uint8_t)2) == 2;
+  if (ok) {
+    value = ((uint16_t)Wire.read() << 8);
+    value |= Wire.read();
+  }
+  mon.sweepI2cMicros += micros() - start;
+  mon.i2cTransactions++;
+  if (!ok) rail.i2cErrors++;
+  return ok;
+}
+
+inline void powerMonitorBegin(PowerMonitor &mon) {
+  mon.i2cTransactions = 0;
+
+  // 12V: 10 mOhm shunt, 8A range. 5V / 3V3: 100 mOhm shunt, 3.2A range.
+  ina219RailSetup(mon.rails[0], 0x40, 0.01f, 0.0005f, INA219_PGA_80MV);
+  ina219RailSetup(mon.rails[1], 0x41, 0.1f, 0.0001f, INA219_PGA_320MV);
+  ina219RailSetup(mon.rails[2], 0x44, 0.1f, 0.0001f, INA219_PGA_320MV);
+
+  for (int i = 0; i < INA219_NUM_RAILS; i++) {
+    Ina219Rail &rail = mon.rails[i];
+    rail.present = ina219WriteRegister(mon, rail, INA219_REG_CALIBRATION, rail.calibration);
+  }
+
+  mon.sweepActive = false;
+  mon.sweepStart = 0;
+  mon.sweepI2cMicros = 0;
+  mon.lastSweepI2cMicros = 0;
+  mon.maxSweepI2cMicros = 0;
+  mon.timestamp = 0;
+  mon.sweeps = 0;
+  mon.timeouts = 0;
+}
+
+// Read a rail if its conversion has finished. Reading the power register
+// clears CNVR for the next trigger.
+inline void ina219PollRail(PowerMonitor &mon, Ina219Rail &rail) {
+  uint16_t bus;
+  if (!ina219ReadRegister(mon, rail, INA219_REG_BUS, bus)) return;
+  if (!(bus & INA219_BUS_CNVR)) return;
+
+  uint16_t current, power;
+  if (!ina219ReadRegister(mon, rail, INA219_REG_CURRENT, current)) return;
+  if (!ina219ReadRegister(mon, rail, INA219_REG_POWER, power)) return;
+
+  if (bus & INA219_BUS_OVF) rail.overflows++;
+  rail.voltage = (bus >> 3) * 0.004f;
+  rail.current = (int16_t)current * rail.currentLsb;
+  rail.power = power * rail.currentLsb * 20.0f;
+  rail.ready = true;
+}
+
+// Call every loop pass. Starts a sweep every intervalMs and returns true
+// once all present rails have fresh readings (or the sweep timed out).
+inline bool powerMonitorService(PowerMonitor &mon, unsigned long intervalMs) {
+  if (!mon.sweepActive) {
+    if (mon.sweeps > 0 && millis() - mon.sweepStart < intervalMs) return false;
+
+    mon.sweepI2cMicros = 0;
+    for (int i = 0; i < INA219_NUM_RAILS; i++) {
+      Ina219Rail &rail = mon.rails[i];
+      rail.ready = !rail.present;
+      if (rail.present && !ina219WriteRegister(mon, rail, INA219_REG_CONFIG, rail.config)) {
+        rail.ready = true;  // Keep the previous reading, counted as an error
+      }
+    }
+    mon.sweepStart = millis();
+    mon.sweepActive = true;
+    return false;
+  }
+
+  bool allReady = true;
+  for (int i = 0; i < INA219_NUM_RAILS; i++) {
+    Ina219Rail &rail = mon.rails[i];
+    if (!rail.ready) ina219PollRail(mon, rail);
+    allReady = allReady && rail.ready;
+  }
+
+  if (!allReady) {
+    if (millis() - mon.sweepStart < INA219_SWEEP_TIMEOUT_MS) return false;
+    mon.timeouts++;
+  }
+
+  mon.sweepActive = false;
+  mon.sweeps++;
+  mon.timestamp = millis();
+  mon.lastSweepI2cMicros = mon.sweepI2cMicros;
+  if (mon.sweepI2cMicros > mon.maxSweepI2cMicros) mon.maxSweepI2cMicros = mon.sweepI2cMicros;
+  return true;
+}
+
+#endif
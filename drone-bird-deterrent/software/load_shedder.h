@@ -0,0 +1,103 @@
+/*
+ * Brownout Load Shedder
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Priority-tiered load shedding on pack voltage sag. A sag below a tier's
+ * threshold sheds that tier (and every tier before it) on the next sample;
+ * recovery steps back one tier at a time, and only after the voltage has
+ * held above threshold + hysteresis for SHED_RESTORE_HOLD_MS.
+ *
+ *   Tier 1: audio amplifier
+ *   Tier 2: side strobes
+ *   Tier 3: Raspberry Pi frame rate
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef LOAD_SHEDDER_H
+#define LOAD_SHEDDER_H
+
+#include <stdint.h>
+
+#define SHED_TIER_NONE          0
+#define SHED_TIER_AUDIO         1
+#define SHED_TIER_SIDE_STROBES  2
+#define SHED_TIER_PI_FRAMERATE  3
+#define SHED_TIERS              4
+
+#define SHED_HYSTERESIS_V       0.30f   // Pack volts above threshold to restore
+#define SHED_RESTORE_HOLD_MS    2000UL  // Time above restore level per tier
+#define SHED_CONFIRM_SAMPLES    2       // Consecutive low samples before shedding
+
+// Pack voltage at which each tier is shed (3S, under load)
+static const float SHED_THRESHOLD_V[SHED_TIERS] = {
+  0.0f,   // Unused
+  10.2f,  // 3.40 V/cell
+  9.9f,   // 3.30 V/cell
+  9.6f    // 3.20 V/cell
+};
+
+struct LoadShedder {
+  int tier;                          // Highest tier currently shed
+  int lowSamples;                    // Consecutive samples below the next threshold
+  unsigned long restoreSince;        // millis() voltage first held above restore level
+  bool restorePending;
+  uint32_t shedEvents;               // Escalations
+  uint32_t tierEvents[SHED_TIERS];   // Escalations into each tier
+  float minVoltage;                  // Lowest voltage seen
+};
+
+inline void loadShedderInit(LoadShedder &shed) {
+  shed.tier = SHED_TIER_NONE;
+  shed.lowSamples = 0;
+  shed.restoreSince = 0;
+  shed.restorePending = false;
+  shed.shedEvents = 0;
+  for (int i = 0; i < SHED_TIERS; i++) shed.tierEvents[i] = 0;
+  shed.minVoltage = 99.0f;
+}
+
+// Feed one pack voltage sample. Returns true when the shed tier changed.
+inline bool loadShedderUpdate(LoadShedder &shed, float packVoltage, unsigned long nowMs) {
+  if (packVoltage < shed.minVoltage) shed.minVoltage = packVoltage;
+
+  // Deepest tier this sample calls for
+  int wanted = SHED_TIER_NONE;
+  for (int t = SHED_TIERS - 1; t > SHED_TIER_NONE; t--) {
+    if (packVoltage < SHED_THRESHOLD_V[t]) {
+      wanted = t;
+      break;
+    }
+  }
+
+  if (wanted > shed.tier) {
+    shed.restorePending = false;
+    if (++shed.lowSamples < SHED_CONFIRM_SAMPLES) return false;
+    shed.lowSamples = 0;
+    shed.tier = wanted;
+    shed.shedEvents++;
+    shed.tierEvents[wanted]++;
+    return true;
+  }
+  shed.lowSamples = 0;
+
+  if (shed.tier == SHED_TIER_NONE) return false;
+
+  // Gradual restore, one tier per hold period
+  if (packVoltage < SHED_THRESHOLD_V[shed.tier] + SHED_HYSTERESIS_V) {
+    shed.restorePending = false;
+    return false;
+  }
+  if (!shed.restorePending) {
+    shed.restorePending = true;
+    shed.restoreSince = nowMs;
+    return false;
+  }
+  if (nowMs - shed.restoreSince < SHED_RESTORE_HOLD_MS) return false;
+
+  shed.tier--;
+  shed.restoreSince = nowMs;
+  return true;
+}
+
+#endif
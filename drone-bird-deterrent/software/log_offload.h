@@ -0,0 +1,136 @@
+/*
+ * Post-Landing Log Offload Protocol
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * After landing the drone joins the field WiFi network, connects to the
+ * ground receiver over TCP and streams the black-box partition
+ * (flight_recorder.h) in sector-sized chunks straight from flash. The
+ * transfer is resumable: the receiver keeps what it has verified and on
+ * every connection tells the drone where to carry on, so a dropped link
+ * costs at most the chunks since the last ack.
+ *
+ * Drone -> ground, once per connection:
+ *   HELLO   magic "BBXO" 4 | version 1 | boot 4 | sequence 4 | image size 4 | chunk size 2
+ * Ground -> drone:
+ *   RESUME  magic 4 | offset 4        bytes of this image already verified
+ * Drone -> ground, in order from the resume offset:
+ *   CHUNK   kind 1 | offset 4 | length 2 | data (DATA only) | CRC-32 4
+ *           kind ERASED: the chunk is all 0xFF and its data is not sent
+ * Ground -> drone, every OFFLOAD_ACK_CHUNKS chunks and at the end:
+ *   ACK     kind 1 | offset 4         verified and on disk up to here
+ * The CRC covers the chunk header and data. All integers little-endian.
+ *
+ * An image is named by its boot and newest sector sequence, so the
+ * recorder is stopped for the transfer and every flight is a new image.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef LOG_OFFLOAD_H
+#define LOG_OFFLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "flight_recorder.h"
+
+#define OFFLOAD_MAGIC           0x4F584242UL  // "BBXO"
+#define OFFLOAD_VERSION         1
+#define OFFLOAD_PORT            5099
+#define OFFLOAD_CHUNK_SIZE      FR_SECTOR_SIZE
+#define OFFLOAD_ACK_CHUNKS      16            // 64 KB between acks
+#define OFFLOAD_HELLO_LENGTH    19
+#define OFFLOAD_RESUME_LENGTH   8
+#define OFFLOAD_CHUNK_HEADER    7
+#define OFFLOAD_CHUNK_TRAILER   4
+#define OFFLOAD_ACK_LENGTH      5
+#define OFFLOAD_FRAME_MAX       (OFFLOAD_CHUNK_HEADER + OFFLOAD_CHUNK_SIZE + OFFLOAD_CHUNK_TRAILER)
+
+enum OffloadKind {
+  OFFLOAD_CHUNK_DATA = 1,
+  OFFLOAD_CHUNK_ERASED = 2,
+  OFFLOAD_ACK = 3
+};
+
+struct OffloadImage {
+  uint32_t boot;
+  uint32_t sequence;        // Newest recorder sector when the transfer started
+  uint32_t size;            // Bytes, a multiple of chunkSize
+  uint16_t chunkSize;
+};
+
+inline size_t offloadEncodeHello(const OffloadImage &image, uint8_t *out) {
+  frPut32(out, OFFLOAD_MAGIC);
+  out[4] = OFFLOAD_VERSION;
+  frPut32(out + 5, image.boot);
+  frPut32(out + 9, image.sequence);
+  frPut32(out + 13, image.size);
+  frPut16(out + 17, image.chunkSize);
+  return OFFLOAD_HELLO_LENGTH;
+}
+
+inline bool offloadParseHello(const uint8_t *in, OffloadImage &image) {
+  if (frGet32(in) != OFFLOAD_MAGIC || in[4] != OFFLOAD_VERSION) return false;
+  image.boot = frGet32(in + 5);
+  image.sequence = frGet32(in + 9);
+  image.size = frGet32(in + 13);
+  image.chunkSize = frGet16(in + 17);
+  return image.chunkSize > 0 && image.chunkSize <= OFFLOAD_CHUNK_SIZE && image.size % image.chunkSize == 0;
+}
+
+inline size_t offloadEncodeResume(uint32_t offset, uint8_t *out) {
+  frPut32(out, OFFLOAD_MAGIC);
+  frPut32(out + 4, offset);
+  return OFFLOAD_RESUME_LENGTH;
+}
+
+inline bool offloadParseResume(const uint8_t *in, uint32_t &offset) {
+  if (frGet32(in) != OFFLOAD_MAGIC) return false;
+  offset = frGet32(in + 4);
+  return true;
+}
+
+inline size_t offloadEncodeAck(uint32_t offset, uint8_t *out) {
+  out[0] = OFFLOAD_ACK;
+  frPut32(out + 1, offset);
+  return OFFLOAD_ACK_LENGTH;
+}
+
+inline bool offloadParseAck(const uint8_t *in, uint32_t &offset) {
+  if (in[0] != OFFLOAD_ACK) return false;
+  offset = frGet32(in + 1);
+  return true;
+}
+
+// Frame the chunk whose data was read into frame + OFFLOAD_CHUNK_HEADER,
+// so flash is read straight into the send buffer. Returns the bytes to
+// send; an erased chunk goes as its header and CRC only.
+inline size_t offloadFinishChunk(uint8_t *frame, uint32_t offset, uint16_t length) {
+  const uint8_t *data = frame + OFFLOAD_CHUNK_HEADER;
+  bool erased = true;
+  for (size_t i = 0; i < length && erased; i++) erased = data[i] == 0xFF;
+
+  frame[0] = erased ? OFFLOAD_CHUNK_ERASED : OFFLOAD_CHUNK_DATA;
+  frPut32(frame + 1, offset);
+  frPut16(frame + 5, length);
+  size_t body = OFFLOAD_CHUNK_HEADER + (erased ? 0 : length);
+  frPut32(frame + body, frCrc32(frame, body));
+  return body + OFFLOAD_CHUNK_TRAILER;
+}
+
+// Bytes still to read after a chunk header, 0 if the header is invalid
+inline size_t offloadChunkRemaining(const uint8_t *header, const OffloadImage &image) {
+  uint16_t length = frGet16(header + 5);
+  if (length != image.chunkSize || frGet32(header + 1) % image.chunkSize != 0) return 0;
+  if (header[0] == OFFLOAD_CHUNK_ERASED) return OFFLOAD_CHUNK_TRAILER;
+  if (header[0] == OFFLOAD_CHUNK_DATA) return length + OFFLOAD_CHUNK_TRAILER;
+  return 0;
+}
+
+inline bool offloadCheckChunk(const uint8_t *frame, size_t length) {
+  if (length < OFFLOAD_CHUNK_HEADER + OFFLOAD_CHUNK_TRAILER) return false;
+  size_t body = length - OFFLOAD_CHUNK_TRAILER;
+  return frGet32(frame + body) == frCrc32(frame, body);
+}
+
+#endif
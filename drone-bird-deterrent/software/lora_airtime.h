@@ -0,0 +1,67 @@
+/*
+ * LoRa Time-on-Air
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Exact SX127x packet time-on-air (Semtech AN1200.13):
+ *
+ *   Tsym     = 2^SF / BW
+ *   Tpre     = (preamble + 4.25) * Tsym
+ *   nPayload = 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * (CR + 4), 0)
+ *
+ * with explicit header (IH = 0), CRC on, and low data rate optimisation (DE)
+ * enabled by the LoRa library's rule: symbol duration in whole ms, from
+ * integer divisions, above 16. So SF11/125kHz (16.384 ms) runs without it.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef LORA_AIRTIME_H
+#define LORA_AIRTIME_H
+
+#include <stdint.h>
+
+#define LORA_PREAMBLE_SYMBOLS  8
+
+struct LoRaModulation {
+  uint8_t spreadingFactor;   // 6..12
+  uint32_t bandwidthHz;      // 7800..500000
+  uint8_t codingRate;        // Denominator 5..8 (4/5 .. 4/8)
+};
+
+// Symbol time in microseconds
+inline uint32_t loraSymbolMicros(const LoRaModulation &mod) {
+  return (uint32_t)(((uint64_t)1000000 << mod.spreadingFactor) / mod.bandwidthHz);
+}
+
+// As arduino-LoRa's setLdoFlag(): 1000 / (BW / 2^SF) in integer ms, > 16
+inline bool loraLowDataRateOptimize(const LoRaModulation &mod) {
+  uint32_t symbolsPerSecond = mod.bandwidthHz >> mod.spreadingFactor;
+  return symbolsPerSecond == 0 || 1000 / symbolsPerSecond > 16;
+}
+
+// Time on air in microseconds for a payload of payloadBytes
+inline uint32_t loraTimeOnAirMicros(const LoRaModulation &mod, uint16_t payloadBytes) {
+  uint32_t tSym = loraSymbolMicros(mod);
+  int sf = mod.spreadingFactor;
+  int de = loraLowDataRateOptimize(mod) ? 1 : 0;
+  int cr = mod.codingRate - 4;
+
+  int numerator = 8 * payloadBytes - 4 * sf + 28 + 16;
+  int denominator = 4 * (sf - 2 * de);
+  int blocks = numerator > 0 ? (numerator + denominator - 1) / denominator : 0;
+  uint32_t payloadSymbols = 8 + blocks * (cr + 4);
+
+  // Preamble is (n + 4.25) symbols
+  uint32_t preambleMicros = (LORA_PREAMBLE_SYMBOLS * 4 + 17) * tSym / 4;
+  return preambleMicros + payloadSymbols * tSym;
+}
+
+// Largest payload that fits in airtimeMicros (0 if even an empty packet does not)
+inline uint16_t loraMaxPayloadForAirtime(const LoRaModulation &mod, uint32_t airtimeMicros) {
+  if (loraTimeOnAirMicros(mod, 0) > airtimeMicros) return 0;
+  uint16_t bytes = 0;
+  while (bytes < 255 && loraTimeOnAirMicros(mod, bytes + 1) <= airtimeMicros) bytes++;
+  return bytes;
+}
+
+#endif
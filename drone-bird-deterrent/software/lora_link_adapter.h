@@ -0,0 +1,228 @@
+/*
+ * LoRa Link Adaptation
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Picks the spreading factor and TX power for each telemetry packet from
+ * the link margin the ground station reports in its acks. The ground acks
+ * every frame at the SF it was received on, carrying the RSSI and SNR it
+ * measured for our packet:
+ *
+ *   Ack (4 bytes): LINK_ACK_MAGIC, sequence, RSSI (int8 dBm), SNR (int8, 0.25 dB)
+ *
+ * Margin is normalised to full power and smoothed, then the fastest SF
+ * whose demodulation floor leaves LINK_TARGET_MARGIN_DB is chosen and the
+ * surplus is taken off the TX power. Moving to a faster SF needs an extra
+ * LINK_HYSTERESIS_DB and LINK_STEP_ACKS acks in a row; moving slower is
+ * immediate. If the delivery ratio over the last 16 packets drops below
+ * LINK_TARGET_DELIVERY the target margin is raised; LINK_LOST_PACKETS
+ * missed acks in a row fall back to SF12 at full power.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef LORA_LINK_ADAPTER_H
+#define LORA_LINK_ADAPTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LINK_ACK_MAGIC          0xA7
+#define LINK_ACK_LENGTH         4
+
+#define LINK_MIN_SF             7
+#define LINK_MAX_SF             12
+#define LINK_MIN_POWER_DBM      2       // PA_BOOST range
+#define LINK_MAX_POWER_DBM      20
+#define LINK_TARGET_MARGIN_DB   8.0f    // Fading allowance above the demod floor
+#define LINK_HYSTERESIS_DB      3.0f    // Extra margin before a faster SF
+#define LINK_STEP_ACKS          3       // Consecutive acks before a faster SF
+#define LINK_LOST_PACKETS       3       // Missed acks before falling back
+#define LINK_TARGET_DELIVERY    0.90f
+#define LINK_PENALTY_STEP_DB    1.0f    // Added to the target per poor window
+#define LINK_PENALTY_MAX_DB     10.0f
+#define LINK_MARGIN_ALPHA       0.3f    // Margin smoothing per ack
+#define LINK_SNR_SATURATION_DB  7.0f    // SX127x SNR stops tracking above this
+
+// Demodulation SNR floor and 125 kHz sensitivity per SF (SX1276 datasheet)
+static const float LINK_SNR_FLOOR_DB[LINK_MAX_SF + 1] = {
+  0, 0, 0, 0, 0, 0, -5.0f, -7.5f, -10.0f, -12.5f, -15.0f, -17.5f, -20.0f
+};
+static const float LINK_SENSITIVITY_DBM[LINK_MAX_SF + 1] = {
+  0, 0, 0, 0, 0, 0, -118.0f, -123.0f, -126.0f, -129.0f, -132.0f, -134.5f, -137.0f
+};
+
+struct LinkAck {
+  uint8_t sequence;
+  int8_t rssi;              // dBm at the ground station
+  float snr;                // dB at the ground station
+};
+
+struct LinkAdapter {
+  uint8_t spreadingFactor;
+  int8_t txPowerDbm;
+  float marginAtMaxDb;      // Smoothed margin at SF12 / full power
+  bool haveMargin;
+  float penaltyDb;          // Extra margin demanded after poor delivery
+  int stepAcks;             // Acks in a row supporting a faster SF
+  int missedInRow;
+  uint16_t history;         // Delivery of the last 16 packets, bit 0 newest
+  int historyCount;
+  bool pending;             // Last packet still waiting for its ack
+  uint8_t pendingSequence;
+  uint32_t sent, acked, fallbacks;
+};
+
+inline bool linkAckDecode(const uint8_t *buffer, size_t length, LinkAck &ack) {
+  if (length != LINK_ACK_LENGTH || buffer[0] != LINK_ACK_MAGIC) return false;
+  ack.sequence = buffer[1];
+  ack.rssi = (int8_t)buffer[2];
+  ack.snr = (int8_t)buffer[3] * 0.25f;
+  return true;
+}
+
+inline size_t linkAckEncode(const LinkAck &ack, uint8_t *buffer) {
+  float snr = ack.snr * 4.0f;
+  if (snr > 127.0f) snr = 127.0f;
+  if (snr < -128.0f) snr = -128.0f;
+  buffer[0] = LINK_ACK_MAGIC;
+  buffer[1] = ack.sequence;
+  buffer[2] = (uint8_t)ack.rssi;
+  buffer[3] = (uint8_t)(int8_t)(snr < 0 ? snr - 0.5f : snr + 0.5f);
+  return LINK_ACK_LENGTH;
+}
+
+inline void linkAdapterFallback(LinkAdapter &link) {
+  link.spreadingFactor = LINK_MAX_SF;
+  link.txPowerDbm = LINK_MAX_POWER_DBM;
+  link.haveMargin = false;
+  link.stepAcks = 0;
+}
+
+inline void linkAdapterInit(LinkAdapter &link) {
+  linkAdapterFallback(link);
+  link.marginAtMaxDb = 0.0f;
+  link.penaltyDb = 0.0f;
+  link.missedInRow = 0;
+  link.history = 0;
+  link.historyCount = 0;
+  link.pending = false;
+  link.pendingSequence = 0;
+  link.sent = link.acked = link.fallbacks = 0;
+}
+
+inline float linkAdapterDeliveryRatio(const LinkAdapter &link) {
+  if (link.historyCount == 0) return 1.0f;
+  int delivered = 0;
+  for (int i = 0; i < link.historyCount; i++) delivered += (link.history >> i) & 1;
+  return (float)delivered / link.historyCount;
+}
+
+inline void linkAdapterRecord(LinkAdapter &link, bool delivered) {
+  link.history = (uint16_t)((link.history << 1) | (delivered ? 1 : 0));
+  if (link.historyCount < 16) link.historyCount++;
+
+  // Ask for more margin while delivery is short of target, relax when met
+  if (link.historyCount >= 8) {
+    if (linkAdapterDeliveryRatio(link) < LINK_TARGET_DELIVERY) {
+      link.penaltyDb += LINK_PENALTY_STEP_DB;
+      if (link.penaltyDb > LINK_PENALTY_MAX_DB) link.penaltyDb = LINK_PENALTY_MAX_DB;
+    } else if (link.penaltyDb > 0.0f) {
+      link.penaltyDb -= 0.1f * LINK_PENALTY_STEP_DB;
+      if (link.penaltyDb < 0.0f) link.penaltyDb = 0.0f;
+    }
+  }
+}
+
+// Margin above the SF12 floor at full power, from what the ground saw of a
+// packet sent at txPowerDbm
+inline float linkAdapterMeasuredMargin(const LinkAck &ack, int txPowerDbm) {
+  float powerGain = (float)(LINK_MAX_POWER_DBM - txPowerDbm);
+  // SNR saturates on strong links; fall back to RSSI against sensitivity there
+  if (ack.snr < LINK_SNR_SATURATION_DB) {
+    return ack.snr - LINK_SNR_FLOOR_DB[LINK_MAX_SF] + powerGain;
+  }
+  return ack.rssi - LINK_SENSITIVITY_DBM[LINK_MAX_SF] + powerGain;
+}
+
+// Call once per transmitted packet, before it is sent. Settles the previous
+// packet's delivery and picks the settings to send this one with.
+inline void linkAdapterOnSend(LinkAdapter &link, uint8_t sequence) {
+  if (link.pending) {
+    link.missedInRow++;
+    link.stepAcks = 0;
+    linkAdapterRecord(link, false);
+    if (link.missedInRow >= LINK_LOST_PACKETS && link.spreadingFactor != LINK_MAX_SF) {
+      linkAdapterFallback(link);
+      link.fallbacks++;
+    }
+  }
+  link.pending = true;
+  link.pendingSequence = sequence;
+  link.sent++;
+  if (!link.haveMargin) return;
+
+  float target = LINK_TARGET_MARGIN_DB + link.penaltyDb;
+
+  // Fastest SF that still meets the target at full power
+  int wanted = LINK_MAX_SF;
+  for (int sf = LINK_MIN_SF; sf <= LINK_MAX_SF; sf++) {
+    float margin = link.marginAtMaxDb - (LINK_SNR_FLOOR_DB[sf] - LINK_SNR_FLOOR_DB[LINK_MAX_SF]);
+    if (margin >= target) {
+      wanted = sf;
+      break;
+    }
+  }
+
+  if (wanted > link.spreadingFactor) {
+    link.spreadingFactor = (uint8_t)wanted;
+    link.stepAcks = 0;
+  } else if (wanted < link.spreadingFactor && link.stepAcks >= LINK_STEP_ACKS) {
+    // One SF per step, and only with hysteresis on top of the target
+    int next = link.spreadingFactor - 1;
+    float margin = link.marginAtMaxDb - (LINK_SNR_FLOOR_DB[next] - LINK_SNR_FLOOR_DB[LINK_MAX_SF]);
+    if (margin >= target + LINK_HYSTERESIS_DB) {
+      link.spreadingFactor = (uint8_t)next;
+      link.stepAcks = 0;
+    }
+  }
+
+  // Trade the remaining surplus for TX power
+  float surplus = link.marginAtMaxDb -
+                  (LINK_SNR_FLOOR_DB[link.spreadingFactor] - LINK_SNR_FLOOR_DB[LINK_MAX_SF]) - target;
+  int power = LINK_MAX_POWER_DBM;
+  if (surplus > 0.0f) power -= (int)surplus;
+  if (power < LINK_MIN_POWER_DBM) power = LINK_MIN_POWER_DBM;
+  link.txPowerDbm = (int8_t)power;
+}
+
+// Packet aborted before it finished; it expects no ack
+inline void linkAdapterCancel(LinkAdapter &link) {
+  if (!link.pending) return;
+  link.pending = false;
+  link.sent--;
+}
+
+// Ack for a packet sent at txPowerDbm. Returns false if it does not match
+// the packet in flight. Packet SNR and RSSI do not depend on the SF used,
+// so one normalised margin serves every SF.
+inline bool linkAdapterOnAck(LinkAdapter &link, const LinkAck &ack, int txPowerDbm) {
+  if (!link.pending || ack.sequence != link.pendingSequence) return false;
+  link.pending = false;
+  link.missedInRow = 0;
+  link.acked++;
+  linkAdapterRecord(link, true);
+
+  float margin = linkAdapterMeasuredMargin(ack, txPowerDbm);
+  if (!link.haveMargin) {
+    link.marginAtMaxDb = margin;
+    link.haveMargin = true;
+  } else if (margin < link.marginAtMaxDb) {
+    link.marginAtMaxDb = margin;  // Fades count at once
+  } else {
+    link.marginAtMaxDb += LINK_MARGIN_ALPHA * (margin - link.marginAtMaxDb);
+  }
+  link.stepAcks++;
+  return true;
+}
+
+#endif
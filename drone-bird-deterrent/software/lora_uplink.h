@@ -0,0 +1,221 @@
+/*
+ * LoRa Uplink Commands
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Compact authenticated commands from the ground station. The drone only
+ * listens in a short receive window after each telemetry packet, which is
+ * when the ground sends its link ack (lora_link_adapter.h); a command rides
+ * in the same downlink, straight after the ack:
+ *
+ *   Downlink: link ack (4 bytes) [+ command (11 bytes)]
+ *
+ *   Command:
+ *     byte 0     UPLINK_MAGIC
+ *     byte 1-2   counter, big-endian, from 1 and strictly increasing per key
+ *     byte 3     UplinkOpcode
+ *     byte 4     parameter (UPLINK_SET_PARAM)
+ *     byte 5-6   value, int16 big-endian
+ *     byte 7-10  tag: SipHash-2-4 of bytes 0-6 under the 128-bit airframe
+ *                key, low 32 bits
+ *
+ * A command is applied as soon as it is received and acknowledged in the
+ * command section of the next telemetry frame (telemetry_frame.h) with its
+ * counter and result. The ground repeats a command until it sees the ack;
+ * a repeat of the last counter is acknowledged again without being
+ * reapplied, and a lower counter is answered STALE with the last counter
+ * accepted so the ground can resynchronise. Frames with a bad tag are
+ * dropped silently. The counter must survive reboots or old commands
+ * could be replayed; the key and counter live in NVS on the drone.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef LORA_UPLINK_H
+#define LORA_UPLINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UPLINK_MAGIC            0xC3
+#define UPLINK_COMMAND_LENGTH   11
+#define UPLINK_SIGNED_LENGTH    7       // Bytes covered by the tag
+#define UPLINK_KEY_LENGTH       16
+
+enum UplinkOpcode {
+  UPLINK_PING = 0,          // No effect; confirms the uplink and counter
+  UPLINK_MUTE_AUDIO = 1,    // value = seconds of silence, 0 lifts the mute
+  UPLINK_SET_PARAM = 2,     // parameter = UplinkParam
+  UPLINK_LOG_DUMP = 3,      // Report logs at the next opportunity
+  UPLINK_OPCODES = 4
+};
+
+enum UplinkParam {
+  UPLINK_PARAM_THREAT_LOW = 0,      // Threat score thresholds
+  UPLINK_PARAM_THREAT_MEDIUM = 1,
+  UPLINK_PARAM_THREAT_HIGH = 2,
+  UPLINK_PARAM_ALERT_STROBE = 3,    // ALERT strobe intensity, PWM counts
+  UPLINK_PARAMS = 4
+};
+
+// Accepted range per UplinkParam
+static const int16_t UPLINK_PARAM_MIN[UPLINK_PARAMS] = {1, 1, 1, 0};
+static const int16_t UPLINK_PARAM_MAX[UPLINK_PARAMS] = {100, 100, 100, 255};
+
+#define UPLINK_MAX_MUTE_S       3600
+
+// Carried in the telemetry command section (3 bits)
+enum UplinkResult {
+  UPLINK_OK = 0,
+  UPLINK_STALE = 1,         // Counter already used; ack carries the last one
+  UPLINK_BAD_PARAM = 2,
+  UPLINK_UNSUPPORTED = 3
+};
+
+struct UplinkCommand {
+  uint16_t counter;
+  uint8_t opcode;
+  uint8_t parameter;
+  int16_t value;
+};
+
+// Drone side
+struct UplinkReceiver {
+  uint8_t key[UPLINK_KEY_LENGTH];
+  bool keyed;               // No key provisioned: every command is refused
+  uint16_t lastCounter;     // Highest counter accepted
+  uint8_t lastResult;
+  uint32_t accepted, repeats, stale, rejected;
+};
+
+inline uint64_t sipRotate(uint64_t x, int b) {
+  return (x << b) | (x >> (64 - b));
+}
+
+inline void sipRound(uint64_t &v0, uint64_t &v1, uint64_t &v2, uint64_t &v3) {
+  v0 += v1; v1 = sipRotate(v1, 13); v1 ^= v0; v0 = sipRotate(v0, 32);
+  v2 += v3; v3 = sipRotate(v3, 16); v3 ^= v2;
+  v0 += v3; v3 = sipRotate(v3, 21); v3 ^= v0;
+  v2 += v1; v1 = sipRotate(v1, 17); v1 ^= v2; v2 = sipRotate(v2, 32);
+}
+
+inline uint64_t sipLoad64(const uint8_t *p) {
+  uint64_t x = 0;
+  for (int i = 7; i >= 0; i--) x = (x << 8) | p[i];
+  return x;
+}
+
+// SipHash-2-4 (Aumasson & Bernstein), little-endian as in the reference
+inline uint64_t sipHash24(const uint8_t *key, const uint8_t *data, size_t length) {
+  uint64_t k0 = sipLoad64(key), k1 = sipLoad64(key + 8);
+  uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+  uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+  uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+  uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+  size_t whole = length & ~(size_t)7;
+  for (size_t i = 0; i < whole; i += 8) {
+    uint64_t m = sipLoad64(data + i);
+    v3 ^= m;
+    sipRound(v0, v1, v2, v3);
+    sipRound(v0, v1, v2, v3);
+    v0 ^= m;
+  }
+  uint64_t last = (uint64_t)(length & 0xFF) << 56;
+  for (size_t i = whole; i < length; i++) last |= (uint64_t)data[i] << (8 * (i - whole));
+  v3 ^= last;
+  sipRound(v0, v1, v2, v3);
+  sipRound(v0, v1, v2, v3);
+  v0 ^= last;
+
+  v2 ^= 0xFF;
+  for (int i = 0; i < 4; i++) sipRound(v0, v1, v2, v3);
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+inline uint32_t uplinkTag(const uint8_t *key, const uint8_t *frame) {
+  return (uint32_t)sipHash24(key, frame, UPLINK_SIGNED_LENGTH);
+}
+
+// Ground side: build a signed command frame
+inline size_t uplinkEncode(const UplinkCommand &cmd, const uint8_t *key, uint8_t *buffer) {
+  buffer[0] = UPLINK_MAGIC;
+  buffer[1] = (uint8_t)(cmd.counter >> 8);
+  buffer[2] = (uint8_t)cmd.counter;
+  buffer[3] = cmd.opcode;
+  buffer[4] = cmd.parameter;
+  buffer[5] = (uint8_t)((uint16_t)cmd.value >> 8);
+  buffer[6] = (uint8_t)cmd.value;
+  uint32_t tag = uplinkTag(key, buffer);
+  for (int i = 0; i < 4; i++) buffer[UPLINK_SIGNED_LENGTH + i] = (uint8_t)(tag >> (24 - 8 * i));
+  return UPLINK_COMMAND_LENGTH;
+}
+
+// Format and tag check only; false for anything not from the key holder
+inline bool uplinkDecode(const uint8_t *key, const uint8_t *buffer, size_t length, UplinkCommand &cmd) {
+  if (length != UPLINK_COMMAND_LENGTH || buffer[0] != UPLINK_MAGIC) return false;
+  uint32_t tag = 0;
+  for (int i = 0; i < 4; i++) tag = (tag << 8) | buffer[UPLINK_SIGNED_LENGTH + i];
+  if (tag != uplinkTag(key, buffer)) return false;
+  cmd.counter = (uint16_t)((buffer[1] << 8) | buffer[2]);
+  cmd.opcode = buffer[3];
+  cmd.parameter = buffer[4];
+  cmd.value = (int16_t)(uint16_t)((buffer[5] << 8) | buffer[6]);
+  return true;
+}
+
+// Argument check before a command is applied
+inline uint8_t uplinkValidate(const UplinkCommand &cmd) {
+  switch (cmd.opcode) {
+    case UPLINK_PING:
+    case UPLINK_LOG_DUMP:
+      return UPLINK_OK;
+    case UPLINK_MUTE_AUDIO:
+      return cmd.value >= 0 && cmd.value <= UPLINK_MAX_MUTE_S ? UPLINK_OK : UPLINK_BAD_PARAM;
+    case UPLINK_SET_PARAM:
+      if (cmd.parameter >= UPLINK_PARAMS) return UPLINK_BAD_PARAM;
+      return cmd.value >= UPLINK_PARAM_MIN[cmd.parameter] && cmd.value <= UPLINK_PARAM_MAX[cmd.parameter]
+                 ? UPLINK_OK : UPLINK_BAD_PARAM;
+    default:
+      return UPLINK_UNSUPPORTED;
+  }
+}
+
+enum UplinkDisposition {
+  UPLINK_IGNORE,            // Not a valid command; send nothing back
+  UPLINK_APPLY,             // New command: apply, then uplinkReceiverDone()
+  UPLINK_ACK_REPEAT,        // Acknowledge lastCounter / lastResult again
+  UPLINK_ACK_STALE          // Acknowledge lastCounter with UPLINK_STALE
+};
+
+inline void uplinkReceiverInit(UplinkReceiver &rx, const uint8_t *key, uint16_t lastCounter) {
+  rx.keyed = key != 0;
+  for (int i = 0; i < UPLINK_KEY_LENGTH; i++) rx.key[i] = key ? key[i] : 0;
+  rx.lastCounter = lastCounter;
+  rx.lastResult = UPLINK_OK;
+  rx.accepted = rx.repeats = rx.stale = rx.rejected = 0;
+}
+
+inline UplinkDisposition uplinkReceive(UplinkReceiver &rx, const uint8_t *buffer, size_t length,
+                                       UplinkCommand &cmd) {
+  if (!rx.keyed || !uplinkDecode(rx.key, buffer, length, cmd)) {
+    rx.rejected++;
+    return UPLINK_IGNORE;
+  }
+  if (cmd.counter == rx.lastCounter) {
+    rx.repeats++;
+    return UPLINK_ACK_REPEAT;
+  }
+  if (cmd.counter < rx.lastCounter) {
+    rx.stale++;
+    return UPLINK_ACK_STALE;
+  }
+  rx.lastCounter = cmd.counter;
+  rx.accepted++;
+  return UPLINK_APPLY;
+}
+
+inline void uplinkReceiverDone(UplinkReceiver &rx, uint8_t result) {
+  rx.lastResult = result;
+}
+
+#endif
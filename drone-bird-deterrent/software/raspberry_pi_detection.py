@@ -52,6 +52,8 @@ class BirdDetectionSystem:
         
         # Communication
         self.esp32_serial = None
+        self.max_fps = 0  # Frame rate cap requested by the ESP32 (0 = none)
+        self.last_frame_time = 0
         self.serial_port = "/dev/ttyAMA0"
         self.baud_rate = 115200
         
@@ -292,6 +294,23 @@ class BirdDetectionSystem:
         except Exception as e:
             logger.error(f"Failed to send detection data: {e}")
     
+    def check_controller_commands(self):
+        """Apply commands sent by the ESP32 (e.g. brownout frame rate cap)"""
+        if not self.esp32_serial:
+            return
+        
+        try:
+            while self.esp32_serial.in_waiting:
+                line = self.esp32_serial.readline().decode(errors='ignore').strip()
+                if not line:
+                    continue
+                command = json.loads(line)
+                if command.get('cmd') == 'max_fps':
+                    self.max_fps = int(command.get('value', 0))
+                    logger.info(f"Frame rate cap set to {self.max_fps or 'unlimited'}")
+        except Exception as e:
+            logger.error(f"Failed to read controller command: {e}")
+    
     def draw_detections(self, frame, detections):
         """Draw detection results on frame for debugging"""
         for detection in detections:
@@ -317,6 +336,14 @@ class BirdDetectionSystem:
         
         while self.running:
             try:
+                # Honour the controller's frame rate cap (load shedding)
+                self.check_controller_commands()
+                if self.max_fps > 0:
+                    wait = self.last_frame_time + 1.0 / self.max_fps - time.time()
+                    if wait > 0:
+                        time.sleep(wait)
+                self.last_frame_time = time.time()
+                
                 # Capture frame
                 ret, frame = self.camera.read()
                 if not ret:
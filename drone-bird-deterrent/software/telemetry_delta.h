@@ -0,0 +1,333 @@
+/*
+ * Delta Telemetry Encoding
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Most fields barely move between packets, so after a keyframe (an
+ * ordinary full frame, telemetry_frame.h) packets only carry the fields
+ * that differ from the last keyframe the ground station acknowledged,
+ * as zigzag varints of the change in quantized code. Packed MSB first:
+ *
+ *   version 3 | TELEMETRY_DELTA 3 | base message type 2 | sequence 8
+ *   keyframe offset 6       sequence - keyframe sequence
+ *   sections 1 (+7)         0 = same sections as the keyframe (+6 in version 1)
+ *   per field 1 (+varint)   changed flag, core fields and present sections only
+ *                           (and only fields the frame's version has)
+ *
+ * Varints use 4-bit groups (continuation + 3 bits, low bits first) since
+ * field deltas are usually a few codes, not bytes. Time is predicted as
+ * one second per sequence step (1Hz status), so it is normally unchanged.
+ *
+ * Deltas are taken against the keyframe, not the previous packet, so a
+ * lost delta costs nothing. A keyframe goes out every TELEMETRY_KEYFRAME_
+ * INTERVAL packets and becomes the reference once acked; the ground keeps
+ * the last TELEMETRY_KEYFRAME_HISTORY keyframes so an unacked one does not
+ * strand the deltas still referring to the previous reference.
+ *
+ * Field codes are the raw bit fields of a full frame, so quantization is
+ * exactly that of telemetryEncode() and deltas wrap within each field.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_DELTA_H
+#define TELEMETRY_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "telemetry_frame.h"
+
+#define TELEMETRY_DELTA              2        // Message type of a delta frame
+#define TELEMETRY_KEYFRAME_INTERVAL  10       // Packets between keyframes
+#define TELEMETRY_KEYFRAME_HISTORY   4        // Keyframes held by the ground
+#define TELEMETRY_MAX_KEYFRAME_OFFSET 63      // 6-bit offset field
+#define TELEMETRY_ALL_SECTIONS       (TELEMETRY_SECTION_BIRD | TELEMETRY_SECTION_ENDURANCE | \
+                                      TELEMETRY_SECTION_POWER | TELEMETRY_SECTION_EVENT | \
+                                      TELEMETRY_SECTION_WINDOW | TELEMETRY_SECTION_COMMAND | \
+                                      TELEMETRY_SECTION_HEALTH)
+
+// Full-frame field widths after the header, in telemetryWriteCore() /
+// telemetryWriteSections() order with every section present
+#define TELEMETRY_FIELDS             39
+static const uint8_t TELEMETRY_FIELD_BITS[TELEMETRY_FIELDS] = {
+  16, 2, 2, 7, 10, 14, 8, 8,   // Core
+  7, 10, 8, 3,                 // Bird
+  10, 10, 10, 10, 10,          // Endurance
+  2, 6,                        // Power
+  3, 5,                        // Event
+  10, 10, 8, 8, 8, 2, 4, 3, 7, // Window
+  16, 3,                       // Command
+  9, 8, 8, 6, 8, 5, 6          // Health
+};
+static const uint8_t TELEMETRY_FIELD_SECTION[TELEMETRY_FIELDS] = {
+  0, 0, 0, 0, 0, 0, 0, 0,
+  TELEMETRY_SECTION_BIRD, TELEMETRY_SECTION_BIRD, TELEMETRY_SECTION_BIRD, TELEMETRY_SECTION_BIRD,
+  TELEMETRY_SECTION_ENDURANCE, TELEMETRY_SECTION_ENDURANCE, TELEMETRY_SECTION_ENDURANCE,
+  TELEMETRY_SECTION_ENDURANCE, TELEMETRY_SECTION_ENDURANCE,
+  TELEMETRY_SECTION_POWER, TELEMETRY_SECTION_POWER,
+  TELEMETRY_SECTION_EVENT, TELEMETRY_SECTION_EVENT,
+  TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW,
+  TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW, TELEMETRY_SECTION_WINDOW,
+  TELEMETRY_SECTION_WINDOW,
+  TELEMETRY_SECTION_COMMAND, TELEMETRY_SECTION_COMMAND,
+  TELEMETRY_SECTION_HEALTH, TELEMETRY_SECTION_HEALTH, TELEMETRY_SECTION_HEALTH, TELEMETRY_SECTION_HEALTH,
+  TELEMETRY_SECTION_HEALTH, TELEMETRY_SECTION_HEALTH, TELEMETRY_SECTION_HEALTH
+};
+// Frame version that introduced each field; older deltas do not carry it
+static const uint8_t TELEMETRY_FIELD_VERSION[TELEMETRY_FIELDS] = {
+  1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1,
+  1, 1, 1, 3, 3,
+  1, 1,
+  1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1,
+  2, 2, 2, 2, 2, 2, 2
+};
+
+struct TelemetryKeyframe {
+  bool valid;
+  uint8_t sequence;
+  uint8_t sections;
+  uint32_t codes[TELEMETRY_FIELDS];
+};
+
+struct TelemetryDeltaEncoder {
+  TelemetryKeyframe reference;     // Acked by the ground
+  TelemetryKeyframe candidate;     // Sent, waiting for its ack
+  int sinceKeyframe;               // Packets since the last keyframe
+  int unackedKeyframes;            // Keyframes sent since the reference was set
+  uint32_t keyframes, deltas;
+  uint32_t bytesSent, fullBytes;   // Actual vs all full frames
+};
+
+// Quantized field codes of a snapshot; absent sections read as zero
+inline void telemetryToCodes(const TelemetrySnapshot &t, uint32_t *codes) {
+  TelemetrySnapshot all = t;
+  all.sections = TELEMETRY_ALL_SECTIONS;
+  uint8_t buffer[TELEMETRY_MAX_FRAME];
+  BitWriter w;
+  bitWriterInit(w, buffer, sizeof(buffer));
+  telemetryWriteCore(w, all);
+  telemetryWriteSections(w, all);
+
+  BitReader r;
+  bitReaderInit(r, buffer, bitWriterBytes(w));
+  for (int f = 0; f < TELEMETRY_FIELDS; f++) {
+    codes[f] = bitRead(r, TELEMETRY_FIELD_BITS[f]);
+    if (TELEMETRY_FIELD_SECTION[f] && !(t.sections & TELEMETRY_FIELD_SECTION[f])) codes[f] = 0;
+  }
+}
+
+inline void telemetryFromCodes(const uint32_t *codes, TelemetrySnapshot &t) {
+  uint8_t sections = t.sections;
+  uint8_t buffer[TELEMETRY_MAX_FRAME];
+  BitWriter w;
+  bitWriterInit(w, buffer, sizeof(buffer));
+  for (int f = 0; f < TELEMETRY_FIELDS; f++) bitWrite(w, codes[f], TELEMETRY_FIELD_BITS[f]);
+
+  BitReader r;
+  bitReaderInit(r, buffer, bitWriterBytes(w));
+  t.sections = TELEMETRY_ALL_SECTIONS;
+  telemetryReadCore(r, t);
+  telemetryReadSections(r, t);
+  t.sections = sections;
+}
+
+// Varint in 4-bit groups: continuation bit then 3 value bits, low first
+inline void bitWriteVarint(BitWriter &w, uint32_t value) {
+  do {
+    uint32_t group = value & 0x07;
+    value >>= 3;
+    bitWrite(w, value ? 1 : 0, 1);
+    bitWrite(w, group, 3);
+  } while (value);
+}
+
+inline uint32_t bitReadVarint(BitReader &r) {
+  uint32_t value = 0;
+  for (int shift = 0; shift < 32 && !r.underflow; shift += 3) {
+    bool more = bitRead(r, 1);
+    value |= bitRead(r, 3) << shift;
+    if (!more) break;
+  }
+  return value;
+}
+
+inline uint32_t zigzagEncode(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t zigzagDecode(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Field difference taken modulo the field width, as the shortest signed step
+inline int32_t telemetryFieldDelta(uint32_t code, uint32_t reference, int bits) {
+  uint32_t mask = (1UL << bits) - 1;
+  uint32_t diff = (code - reference) & mask;
+  if (diff & (1UL << (bits - 1))) return (int32_t)diff - (int32_t)(1UL << bits);
+  return (int32_t)diff;
+}
+
+inline void telemetryDeltaInit(TelemetryDeltaEncoder &enc) {
+  enc.reference.valid = false;
+  enc.candidate.valid = false;
+  enc.sinceKeyframe = 0;
+  enc.unackedKeyframes = 0;
+  enc.keyframes = enc.deltas = 0;
+  enc.bytesSent = enc.fullBytes = 0;
+}
+
+// Keyframe codes with time advanced one second per sequence step
+inline void telemetryDeltaBase(const TelemetryKeyframe &key, uint8_t offset, uint32_t *base) {
+  for (int f = 0; f < TELEMETRY_FIELDS; f++) base[f] = key.codes[f];
+  base[0] = (base[0] + offset) & ((1UL << TELEMETRY_FIELD_BITS[0]) - 1);
+}
+
+// Delta frame against a keyframe; returns its length, 0 if it does not fit
+inline size_t telemetryDeltaWrite(const TelemetrySnapshot &t, const TelemetryKeyframe &key,
+                                  uint8_t *buffer, size_t capacity) {
+  uint8_t offset = (uint8_t)(t.sequence - key.sequence);
+  if (offset == 0 || offset > TELEMETRY_MAX_KEYFRAME_OFFSET) return 0;
+
+  uint32_t codes[TELEMETRY_FIELDS], base[TELEMETRY_FIELDS];
+  telemetryToCodes(t, codes);
+  telemetryDeltaBase(key, offset, base);
+
+  BitWriter w;
+  bitWriterInit(w, buffer, capacity);
+  bitWrite(w, TELEMETRY_VERSION, 3);
+  bitWrite(w, TELEMETRY_DELTA, 3);
+  bitWrite(w, t.type, 2);
+  bitWrite(w, t.sequence, 8);
+  bitWrite(w, offset, 6);
+  bool sameSections = t.sections == key.sections;
+  bitWrite(w, sameSections ? 0 : 1, 1);
+  if (!sameSections) bitWrite(w, t.sections, 7);
+
+  for (int f = 0; f < TELEMETRY_FIELDS; f++) {
+    if (TELEMETRY_FIELD_SECTION[f] && !(t.sections & TELEMETRY_FIELD_SECTION[f])) continue;
+    bool changed = codes[f] != base[f];
+    bitWrite(w, changed ? 1 : 0, 1);
+    if (changed) bitWriteVarint(w, zigzagEncode(telemetryFieldDelta(codes[f], base[f], TELEMETRY_FIELD_BITS[f])));
+  }
+  return w.overflow ? 0 : bitWriterBytes(w);
+}
+
+// Encode the next packet as a keyframe or a delta; t.sequence must be set
+inline size_t telemetryDeltaEncode(TelemetryDeltaEncoder &enc, const TelemetrySnapshot &t,
+                                   uint8_t *buffer, size_t capacity) {
+  size_t full = telemetryEncode(t, buffer, capacity);
+  if (full == 0) return 0;
+  enc.fullBytes += full;
+
+  if (enc.reference.valid && enc.sinceKeyframe < TELEMETRY_KEYFRAME_INTERVAL) {
+    uint8_t delta[TELEMETRY_MAX_FRAME];
+    size_t n = telemetryDeltaWrite(t, enc.reference, delta, sizeof(delta));
+    if (n > 0 && n < full) {
+      for (size_t i = 0; i < n; i++) buffer[i] = delta[i];
+      enc.sinceKeyframe++;
+      enc.deltas++;
+      enc.bytesSent += n;
+      return n;
+    }
+  }
+
+  // Keyframe: the full frame already in buffer
+  enc.candidate.valid = true;
+  enc.candidate.sequence = t.sequence;
+  enc.candidate.sections = t.sections;
+  telemetryToCodes(t, enc.candidate.codes);
+  enc.sinceKeyframe = 0;
+  enc.keyframes++;
+  enc.bytesSent += full;
+
+  // The ground only remembers so many keyframes back
+  if (enc.reference.valid && ++enc.unackedKeyframes >= TELEMETRY_KEYFRAME_HISTORY) {
+    enc.reference.valid = false;
+  }
+  return full;
+}
+
+// Ground acknowledged a sequence number
+inline void telemetryDeltaOnAck(TelemetryDeltaEncoder &enc, uint8_t sequence) {
+  if (!enc.candidate.valid || enc.candidate.sequence != sequence) return;
+  enc.reference = enc.candidate;
+  enc.candidate.valid = false;
+  enc.unackedKeyframes = 0;
+}
+
+// Ground side: rebuilds full snapshots from keyframes and deltas
+struct TelemetryDeltaDecoder {
+  TelemetryKeyframe keyframes[TELEMETRY_KEYFRAME_HISTORY];
+  int next;                        // Ring position for the next keyframe
+  uint32_t unresolved;             // Deltas whose keyframe was never received
+};
+
+inline void telemetryDeltaDecoderInit(TelemetryDeltaDecoder &dec) {
+  for (int i = 0; i < TELEMETRY_KEYFRAME_HISTORY; i++) dec.keyframes[i].valid = false;
+  dec.next = 0;
+  dec.unresolved = 0;
+}
+
+inline bool telemetryIsDelta(const uint8_t *buffer, size_t length) {
+  return length > 0 && ((buffer[0] >> 2) & 0x07) == TELEMETRY_DELTA;
+}
+
+// Decode a full or delta frame. Returns false if it is malformed or refers
+// to a keyframe that is not held.
+inline bool telemetryDeltaDecode(TelemetryDeltaDecoder &dec, const uint8_t *buffer, size_t length,
+                                 TelemetrySnapshot &t) {
+  if (!telemetryIsDelta(buffer, length)) {
+    if (!telemetryDecode(buffer, length, t)) return false;
+    TelemetryKeyframe &key = dec.keyframes[dec.next];
+    key.valid = true;
+    key.sequence = t.sequence;
+    key.sections = t.sections;
+    telemetryToCodes(t, key.codes);
+    dec.next = (dec.next + 1) % TELEMETRY_KEYFRAME_HISTORY;
+    return true;
+  }
+
+  BitReader r;
+  bitReaderInit(r, buffer, length);
+  uint32_t version = bitRead(r, 3);
+  int sectionBits = telemetrySectionBits(version);
+  if (sectionBits == 0) return false;
+  bitRead(r, 3);
+  uint8_t type = (uint8_t)bitRead(r, 2);
+  uint8_t sequence = (uint8_t)bitRead(r, 8);
+  uint8_t offset = (uint8_t)bitRead(r, 6);
+
+  const TelemetryKeyframe *key = 0;
+  for (int i = 0; i < TELEMETRY_KEYFRAME_HISTORY; i++) {
+    const TelemetryKeyframe &k = dec.keyframes[i];
+    if (k.valid && k.sequence == (uint8_t)(sequence - offset)) key = &k;
+  }
+  if (!key) {
+    dec.unresolved++;
+    return false;
+  }
+
+  uint8_t sections = key->sections;
+  if (bitRead(r, 1)) sections = (uint8_t)bitRead(r, sectionBits);
+
+  uint32_t codes[TELEMETRY_FIELDS];
+  telemetryDeltaBase(*key, offset, codes);
+  for (int f = 0; f < TELEMETRY_FIELDS; f++) {
+    if (TELEMETRY_FIELD_SECTION[f] && !(sections & TELEMETRY_FIELD_SECTION[f])) continue;
+    if (version < TELEMETRY_FIELD_VERSION[f] || !bitRead(r, 1)) continue;
+    uint32_t mask = (1UL << TELEMETRY_FIELD_BITS[f]) - 1;
+    codes[f] = (codes[f] + (uint32_t)zigzagDecode(bitReadVarint(r))) & mask;
+  }
+  if (r.underflow) return false;
+
+  t.type = type;
+  t.sequence = sequence;
+  t.sections = sections;
+  telemetryFromCodes(codes, t);
+  return true;
+}
+
+#endif
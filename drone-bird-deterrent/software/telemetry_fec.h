@@ -0,0 +1,302 @@
+/*
+ * Telemetry Forward Error Correction
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Systematic Reed-Solomon erasure code across groups of telemetry frames.
+ * After every K data frames, M parity frames are sent; the ground rebuilds
+ * any lost frames of the group as long as any K of the K + M arrive, with
+ * no round trip. Each frame becomes one symbol (a length byte, the frame,
+ * zero padding to the longest in the group) and parity j is
+ *
+ *   P[j] = sum_i C[j][i] * D[i]    over GF(256), bytewise
+ *
+ * with the Cauchy matrix C[j][i] = 1 / (j ^ (M + i)), any square
+ * submatrix of which is invertible.
+ *
+ * Parity frame:
+ *   byte 0   version 3 | TELEMETRY_PARITY 3 | 0 2
+ *   byte 1   sequence of the first data frame in the group
+ *   byte 2   K 4 | parity index 4
+ *   byte 3   M
+ *   rest     parity symbol
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_FEC_H
+#define TELEMETRY_FEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "telemetry_frame.h"
+
+#define TELEMETRY_PARITY        3        // Message type of a parity frame
+#define FEC_MAX_GROUP           8        // K
+#define FEC_MAX_PARITY          4        // M
+#define FEC_MAX_SYMBOL          (TELEMETRY_MAX_FRAME + 1)
+#define FEC_PARITY_HEADER       4
+#define FEC_HISTORY             32       // Data frames the ground keeps for recovery
+
+struct Gf256 {
+  uint8_t exp[512];
+  uint8_t log[256];
+};
+
+// Tables for GF(2^8) with the 0x11D polynomial, built on first use
+inline const Gf256 &gf256() {
+  static Gf256 gf;
+  static bool ready = false;
+  if (!ready) {
+    int x = 1;
+    for (int i = 0; i < 255; i++) {
+      gf.exp[i] = (uint8_t)x;
+      gf.log[x] = (uint8_t)i;
+      x <<= 1;
+      if (x & 0x100) x ^= 0x11D;
+    }
+    for (int i = 255; i < 512; i++) gf.exp[i] = gf.exp[i - 255];
+    gf.log[0] = 0;
+    ready = true;
+  }
+  return gf;
+}
+
+inline uint8_t gfMul(uint8_t a, uint8_t b) {
+  if (a == 0 || b == 0) return 0;
+  const Gf256 &gf = gf256();
+  return gf.exp[gf.log[a] + gf.log[b]];
+}
+
+inline uint8_t gfInv(uint8_t a) {
+  const Gf256 &gf = gf256();
+  return gf.exp[255 - gf.log[a]];
+}
+
+inline uint8_t fecCoefficient(int parity, int data, int m) {
+  return gfInv((uint8_t)(parity ^ (m + data)));
+}
+
+struct FecEncoder {
+  int k, m;
+  uint8_t base;                    // Sequence of the group's first frame
+  int count;                       // Frames in the group so far
+  uint8_t symbols[FEC_MAX_GROUP][FEC_MAX_SYMBOL];
+  int symbolLength;
+  uint32_t groups;
+  uint32_t parityFrames, parityBytes;
+};
+
+inline void fecEncoderInit(FecEncoder &enc, int k, int m) {
+  enc.k = k > FEC_MAX_GROUP ? FEC_MAX_GROUP : k;
+  enc.m = m > FEC_MAX_PARITY ? FEC_MAX_PARITY : m;
+  enc.count = 0;
+  enc.symbolLength = 0;
+  enc.groups = enc.parityFrames = enc.parityBytes = 0;
+}
+
+// Add a data frame as sent. Returns true when it completes a group, after
+// which fecEncoderParity() gives parity frames 0..m-1.
+inline bool fecEncoderAdd(FecEncoder &enc, uint8_t sequence, const uint8_t *frame, size_t length) {
+  if (enc.m == 0 || length + 1 > FEC_MAX_SYMBOL) return false;
+
+  // A gap in sequence numbers restarts the group
+  if (enc.count > 0 && (uint8_t)(enc.base + enc.count) != sequence) enc.count = 0;
+  if (enc.count == 0) {
+    enc.base = sequence;
+    enc.symbolLength = 0;
+  }
+
+  uint8_t *symbol = enc.symbols[enc.count++];
+  symbol[0] = (uint8_t)length;
+  for (size_t i = 0; i < length; i++) symbol[i + 1] = frame[i];
+  for (size_t i = length + 1; i < FEC_MAX_SYMBOL; i++) symbol[i] = 0;
+  if ((int)length + 1 > enc.symbolLength) enc.symbolLength = (int)length + 1;
+
+  if (enc.count < enc.k) return false;
+  enc.count = 0;
+  enc.groups++;
+  return true;
+}
+
+// Parity frame j of the group just completed; returns its length
+inline size_t fecEncoderParity(FecEncoder &enc, int j, uint8_t *buffer, size_t capacity) {
+  size_t length = FEC_PARITY_HEADER + enc.symbolLength;
+  if (j >= enc.m || length > capacity) return 0;
+
+  buffer[0] = (uint8_t)((TELEMETRY_VERSION << 5) | (TELEMETRY_PARITY << 2));
+  buffer[1] = enc.base;
+  buffer[2] = (uint8_t)((enc.k << 4) | j);
+  buffer[3] = (uint8_t)enc.m;
+  uint8_t *parity = buffer + FEC_PARITY_HEADER;
+  for (int b = 0; b < enc.symbolLength; b++) parity[b] = 0;
+  for (int i = 0; i < enc.k; i++) {
+    uint8_t c = fecCoefficient(j, i, enc.m);
+    for (int b = 0; b < enc.symbolLength; b++) parity[b] ^= gfMul(c, enc.symbols[i][b]);
+  }
+  enc.parityFrames++;
+  enc.parityBytes += length;
+  return length;
+}
+
+inline bool telemetryIsParity(const uint8_t *buffer, size_t length) {
+  return length > FEC_PARITY_HEADER && ((buffer[0] >> 2) & 0x07) == TELEMETRY_PARITY;
+}
+
+// Sequence number of a data frame: bits 6..13 of a full frame, byte 1 of
+// a delta frame (telemetry_delta.h)
+inline uint8_t telemetryFrameSequence(const uint8_t *buffer, size_t length) {
+  if (length < 2) return 0;
+  if (((buffer[0] >> 2) & 0x07) == 2) return buffer[1];
+  return (uint8_t)(((buffer[0] & 0x03) << 6) | (buffer[1] >> 2));
+}
+
+// Ground side: recent data frames and parity, and the frames rebuilt
+struct FecDecoder {
+  struct Slot {
+    bool valid;
+    uint8_t sequence;
+    uint8_t length;
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+  } history[FEC_HISTORY];
+  struct Parity {
+    bool valid;
+    uint8_t base, k, m, index;
+    uint8_t length;                // Symbol length
+    uint8_t symbol[FEC_MAX_SYMBOL];
+  } parity[FEC_MAX_PARITY * 2];
+  int nextParity;
+  uint32_t recovered, unrecoverable;
+};
+
+inline void fecDecoderInit(FecDecoder &dec) {
+  for (int i = 0; i < FEC_HISTORY; i++) dec.history[i].valid = false;
+  for (int i = 0; i < FEC_MAX_PARITY * 2; i++) dec.parity[i].valid = false;
+  dec.nextParity = 0;
+  dec.recovered = dec.unrecoverable = 0;
+}
+
+// Record a data frame (received or rebuilt)
+inline void fecDecoderAddData(FecDecoder &dec, uint8_t sequence, const uint8_t *frame, size_t length) {
+  FecDecoder::Slot &slot = dec.history[sequence % FEC_HISTORY];
+  slot.valid = true;
+  slot.sequence = sequence;
+  slot.length = (uint8_t)length;
+  for (size_t i = 0; i < length; i++) slot.frame[i] = frame[i];
+}
+
+inline const FecDecoder::Slot *fecDecoderFind(const FecDecoder &dec, uint8_t sequence) {
+  const FecDecoder::Slot &slot = dec.history[sequence % FEC_HISTORY];
+  return slot.valid && slot.sequence == sequence ? &slot : 0;
+}
+
+// Record a parity frame and rebuild what it makes recoverable. Rebuilt
+// frames are written to out (up to FEC_MAX_PARITY, sequence in
+// outSequence, length in outLength) and added to the history.
+inline int fecDecoderAddParity(FecDecoder &dec, const uint8_t *buffer, size_t length,
+                               uint8_t out[][TELEMETRY_MAX_FRAME], uint8_t *outSequence,
+                               uint8_t *outLength) {
+  if (!telemetryIsParity(buffer, length) || length - FEC_PARITY_HEADER > FEC_MAX_SYMBOL) return 0;
+  uint8_t base = buffer[1];
+  int k = buffer[2] >> 4;
+  int index = buffer[2] & 0x0F;
+  int m = buffer[3];
+  if (k == 0 || k > FEC_MAX_GROUP || m == 0 || m > FEC_MAX_PARITY || index >= m) return 0;
+
+  FecDecoder::Parity &p = dec.parity[dec.nextParity];
+  dec.nextParity = (dec.nextParity + 1) % (FEC_MAX_PARITY * 2);
+  p.valid = true;
+  p.base = base;
+  p.k = (uint8_t)k;
+  p.m = (uint8_t)m;
+  p.index = (uint8_t)index;
+  p.length = (uint8_t)(length - FEC_PARITY_HEADER);
+  for (int b = 0; b < p.length; b++) p.symbol[b] = buffer[FEC_PARITY_HEADER + b];
+
+  // Which data frames of the group are missing, and which parities we hold
+  int missing[FEC_MAX_PARITY];
+  int missingCount = 0;
+  for (int i = 0; i < k; i++) {
+    if (fecDecoderFind(dec, (uint8_t)(base + i))) continue;
+    if (missingCount == FEC_MAX_PARITY) return 0;
+    missing[missingCount++] = i;
+  }
+  if (missingCount == 0) return 0;
+
+  const FecDecoder::Parity *have[FEC_MAX_PARITY];
+  int haveCount = 0;
+  for (int i = 0; i < FEC_MAX_PARITY * 2 && haveCount < missingCount; i++) {
+    const FecDecoder::Parity &q = dec.parity[i];
+    if (q.valid && q.base == base && q.k == k && q.m == m && q.length == p.length) {
+      bool duplicate = false;
+      for (int h = 0; h < haveCount; h++) duplicate |= have[h]->index == q.index;
+      if (!duplicate) have[haveCount++] = &q;
+    }
+  }
+  if (haveCount < missingCount) return 0;  // Wait for more parity
+
+  // Syndromes: parity minus the contribution of the frames we have
+  int n = missingCount;
+  int symbolLength = p.length;
+  uint8_t matrix[FEC_MAX_PARITY][FEC_MAX_PARITY];
+  uint8_t rhs[FEC_MAX_PARITY][FEC_MAX_SYMBOL];
+  for (int r = 0; r < n; r++) {
+    for (int b = 0; b < symbolLength; b++) rhs[r][b] = have[r]->symbol[b];
+    for (int i = 0; i < k; i++) {
+      const FecDecoder::Slot *slot = fecDecoderFind(dec, (uint8_t)(base + i));
+      if (!slot) continue;
+      uint8_t c = fecCoefficient(have[r]->index, i, m);
+      uint8_t symbol[FEC_MAX_SYMBOL] = {0};
+      symbol[0] = slot->length;
+      for (int b = 0; b < slot->length && b + 1 < symbolLength; b++) symbol[b + 1] = slot->frame[b];
+      for (int b = 0; b < symbolLength; b++) rhs[r][b] ^= gfMul(c, symbol[b]);
+    }
+    for (int col = 0; col < n; col++) matrix[r][col] = fecCoefficient(have[r]->index, missing[col], m);
+  }
+
+  // Gauss-Jordan elimination over GF(256)
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    while (pivot < n && matrix[pivot][col] == 0) pivot++;
+    if (pivot == n) {
+      dec.unrecoverable++;
+      return 0;
+    }
+    if (pivot != col) {
+      for (int c = 0; c < n; c++) {
+        uint8_t t = matrix[col][c]; matrix[col][c] = matrix[pivot][c]; matrix[pivot][c] = t;
+      }
+      for (int b = 0; b < symbolLength; b++) {
+        uint8_t t = rhs[col][b]; rhs[col][b] = rhs[pivot][b]; rhs[pivot][b] = t;
+      }
+    }
+    uint8_t inv = gfInv(matrix[col][col]);
+    for (int c = 0; c < n; c++) matrix[col][c] = gfMul(matrix[col][c], inv);
+    for (int b = 0; b < symbolLength; b++) rhs[col][b] = gfMul(rhs[col][b], inv);
+    for (int r = 0; r < n; r++) {
+      uint8_t factor = matrix[r][col];
+      if (r == col || factor == 0) continue;
+      for (int c = 0; c < n; c++) matrix[r][c] ^= gfMul(factor, matrix[col][c]);
+      for (int b = 0; b < symbolLength; b++) rhs[r][b] ^= gfMul(factor, rhs[col][b]);
+    }
+  }
+
+  int rebuilt = 0;
+  for (int r = 0; r < n; r++) {
+    uint8_t frameLength = rhs[r][0];
+    if (frameLength == 0 || frameLength + 1 > symbolLength || frameLength > TELEMETRY_MAX_FRAME) {
+      dec.unrecoverable++;
+      continue;
+    }
+    uint8_t sequence = (uint8_t)(base + missing[r]);
+    for (int b = 0; b < frameLength; b++) out[rebuilt][b] = rhs[r][b + 1];
+    outSequence[rebuilt] = sequence;
+    outLength[rebuilt] = frameLength;
+    fecDecoderAddData(dec, sequence, out[rebuilt], frameLength);
+    rebuilt++;
+  }
+  dec.recovered += rebuilt;
+  return rebuilt;
+}
+
+#endif
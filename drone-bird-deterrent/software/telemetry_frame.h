@@ -0,0 +1,366 @@
+/*
+ * Binary Telemetry Frame
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Fixed, bit-packed, versioned telemetry frame replacing the ~150 byte JSON
+ * document. Fields are quantized and packed MSB first; optional sections
+ * are only present when their bit is set in the section bitmap. The same
+ * header is used by the ESP32 encoder and the ground-station decoder.
+ *
+ * Header (21 bits)
+ *   version        3   TELEMETRY_VERSION
+ *   type           3   TelemetryMessageType
+ *   sequence       8
+ *   sections       7   TELEMETRY_SECTION_* bitmap (6 bits in version 1)
+ * Core (67 bits)
+ *   time           16  s since boot (wraps after 18h)
+ *   state          2   SystemState
+ *   threat         2   ThreatLevel
+ *   battery        7   % (0..100)
+ *   power          10  W, 0.1 W steps (0..102.3)
+ *   altitude       14  m, 0.5 m steps from -500 m
+ *   verticalSpeed  8   m/s, 0.1 m/s steps from -12.8
+ *   temperature    8   degC, 0.5 degC steps from -40
+ * Bird section (28 bits)
+ *   confidence 7 (%), distance 10 (m), bearing 8 (1.5 deg from -180), species 3
+ * Endurance section (50 bits; 30 before version 3)
+ *   time to reserve 10, pessimistic 10, optimistic 10 (10 s steps),
+ *   range to reserve 10, pessimistic 10 (150 m steps, version 3 on)
+ * Power section (8 bits)
+ *   shed tier 2, shed events 6 (mod 64)
+ * Event section (8 bits)
+ *   event code 3 (TelemetryEventCode), value 5
+ * Window section (60 bits) - since the previous status packet
+ *   power min 10, max 10 (as core power), vertical speed min 8, max 8
+ *   (as core), pack voltage min 8 (0.05 V steps from 8 V), max threat 2,
+ *   detections 4 (saturating), state changes 3 (saturating),
+ *   LoRa airtime budget used 7 (%)
+ * Command section (19 bits) - acknowledges an uplink command (lora_uplink.h)
+ *   command counter 16, result 3 (UplinkResult)
+ * Health section (50 bits) - health_monitor.h
+ *   flags 9 (HEALTH_* bitmap), free heap 8 (2 KB steps), I2C errors 8
+ *   (mod 256), LoRa TX failures 6 (mod 64), loop overruns 8 (mod 256),
+ *   Pi message rate 5 (per s, saturating), Pi message age 6 (0.1 s steps)
+ *
+ * With the window section the core power field carries the window mean.
+ * Version 1 frames (no health section) and version 2 frames (no range)
+ * still decode.
+ *
+ * Core frame: 11 bytes. All sections: 39 bytes.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TELEMETRY_VERSION           3
+#define TELEMETRY_MAX_FRAME         40
+
+#define TELEMETRY_SECTION_BIRD      0x01
+#define TELEMETRY_SECTION_ENDURANCE 0x02
+#define TELEMETRY_SECTION_POWER     0x04
+#define TELEMETRY_SECTION_EVENT     0x08
+#define TELEMETRY_SECTION_WINDOW    0x10
+#define TELEMETRY_SECTION_COMMAND   0x20
+#define TELEMETRY_SECTION_HEALTH    0x40
+
+enum TelemetryMessageType {
+  TELEMETRY_STATUS = 0,
+  TELEMETRY_EVENT = 1
+};
+
+enum TelemetryEventCode {
+  TELEMETRY_EVENT_THREAT = 0,   // value = new ThreatLevel
+  TELEMETRY_EVENT_STATE = 1,    // value = new SystemState
+  TELEMETRY_EVENT_STRIKE = 2    // value = peak acceleration, g
+};
+
+struct TelemetrySnapshot {
+  uint8_t type;
+  uint8_t sequence;
+  uint8_t sections;
+  uint32_t timeSeconds;
+  uint8_t state;
+  uint8_t threat;
+  float battery;            // %
+  float power;              // W
+  float altitude;           // m
+  float verticalSpeed;      // m/s
+  float temperature;        // degC
+  // TELEMETRY_SECTION_BIRD
+  uint8_t birdConfidence;   // %
+  float birdDistance;       // m
+  float birdBearing;        // deg
+  uint8_t birdSpecies;
+  // TELEMETRY_SECTION_ENDURANCE
+  float enduranceSeconds;
+  float enduranceLowSeconds;
+  float enduranceHighSeconds;
+  float rangeMeters;
+  float rangeLowMeters;
+  // TELEMETRY_SECTION_POWER
+  uint8_t shedTier;
+  uint8_t shedEvents;
+  // TELEMETRY_SECTION_EVENT
+  uint8_t eventCode;
+  uint8_t eventValue;
+  // TELEMETRY_SECTION_WINDOW
+  float powerMin, powerMax;                  // W
+  float verticalSpeedMin, verticalSpeedMax;  // m/s
+  float packVoltageMin;                      // V
+  uint8_t maxThreat;
+  uint8_t detections;
+  uint8_t stateChanges;
+  float airtimeUsage;                        // % of the duty-cycle budget
+  // TELEMETRY_SECTION_COMMAND
+  uint16_t commandCounter;
+  uint8_t commandResult;
+  // TELEMETRY_SECTION_HEALTH
+  uint16_t healthFlags;
+  float freeHeapKb;
+  uint8_t i2cErrors;                         // mod 256
+  uint8_t loraTxFailures;                    // mod 64
+  uint8_t loopOverruns;                      // mod 256
+  uint8_t piRate;                            // Messages/s
+  float piAgeSeconds;
+};
+
+// MSB-first bit packing into a caller-provided buffer
+struct BitWriter {
+  uint8_t *buffer;
+  size_t capacity;          // bytes
+  size_t bitPosition;
+  bool overflow;
+};
+
+inline void bitWriterInit(BitWriter &w, uint8_t *buffer, size_t capacity) {
+  w.buffer = buffer;
+  w.capacity = capacity;
+  w.bitPosition = 0;
+  w.overflow = false;
+  for (size_t i = 0; i < capacity; i++) buffer[i] = 0;
+}
+
+inline void bitWrite(BitWriter &w, uint32_t value, int bits) {
+  for (int i = bits - 1; i >= 0; i--) {
+    size_t byteIndex = w.bitPosition >> 3;
+    if (byteIndex >= w.capacity) {
+      w.overflow = true;
+      return;
+    }
+    if ((value >> i) & 1) w.buffer[byteIndex] |= (uint8_t)(0x80 >> (w.bitPosition & 7));
+    w.bitPosition++;
+  }
+}
+
+inline size_t bitWriterBytes(const BitWriter &w) {
+  return (w.bitPosition + 7) >> 3;
+}
+
+struct BitReader {
+  const uint8_t *buffer;
+  size_t length;            // bytes
+  size_t bitPosition;
+  bool underflow;
+};
+
+inline void bitReaderInit(BitReader &r, const uint8_t *buffer, size_t length) {
+  r.buffer = buffer;
+  r.length = length;
+  r.bitPosition = 0;
+  r.underflow = false;
+}
+
+inline uint32_t bitRead(BitReader &r, int bits) {
+  uint32_t value = 0;
+  for (int i = 0; i < bits; i++) {
+    size_t byteIndex = r.bitPosition >> 3;
+    if (byteIndex >= r.length) {
+      r.underflow = true;
+      return 0;
+    }
+    value = (value << 1) | ((r.buffer[byteIndex] >> (7 - (r.bitPosition & 7))) & 1);
+    r.bitPosition++;
+  }
+  return value;
+}
+
+// Linear quantization with clamping to the field width
+inline uint32_t telemetryQuantize(float value, float minimum, float step, int bits) {
+  float q = (value - minimum) / step + 0.5f;
+  uint32_t maxCode = (1UL << bits) - 1;
+  if (q <= 0.0f) return 0;
+  if (q >= (float)maxCode) return maxCode;
+  return (uint32_t)q;
+}
+
+inline float telemetryDequantize(uint32_t code, float minimum, float step) {
+  return minimum + code * step;
+}
+
+inline void telemetryWriteHeader(BitWriter &w, const TelemetrySnapshot &t) {
+  bitWrite(w, TELEMETRY_VERSION, 3);
+  bitWrite(w, t.type, 3);
+  bitWrite(w, t.sequence, 8);
+  bitWrite(w, t.sections, 7);
+}
+
+inline void telemetryWriteCore(BitWriter &w, const TelemetrySnapshot &t) {
+  bitWrite(w, t.timeSeconds & 0xFFFF, 16);
+  bitWrite(w, t.state, 2);
+  bitWrite(w, t.threat, 2);
+  bitWrite(w, telemetryQuantize(t.battery, 0.0f, 1.0f, 7), 7);
+  bitWrite(w, telemetryQuantize(t.power, 0.0f, 0.1f, 10), 10);
+  bitWrite(w, telemetryQuantize(t.altitude, -500.0f, 0.5f, 14), 14);
+  bitWrite(w, telemetryQuantize(t.verticalSpeed, -12.8f, 0.1f, 8), 8);
+  bitWrite(w, telemetryQuantize(t.temperature, -40.0f, 0.5f, 8), 8);
+}
+
+inline void telemetryWriteSections(BitWriter &w, const TelemetrySnapshot &t) {
+  if (t.sections & TELEMETRY_SECTION_BIRD) {
+    bitWrite(w, telemetryQuantize(t.birdConfidence, 0.0f, 1.0f, 7), 7);
+    bitWrite(w, telemetryQuantize(t.birdDistance, 0.0f, 1.0f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.birdBearing, -180.0f, 1.5f, 8), 8);
+    bitWrite(w, t.birdSpecies & 0x07, 3);
+  }
+  if (t.sections & TELEMETRY_SECTION_ENDURANCE) {
+    bitWrite(w, telemetryQuantize(t.enduranceSeconds, 0.0f, 10.0f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.enduranceLowSeconds, 0.0f, 10.0f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.enduranceHighSeconds, 0.0f, 10.0f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.rangeMeters, 0.0f, 150.0f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.rangeLowMeters, 0.0f, 150.0f, 10), 10);
+  }
+  if (t.sections & TELEMETRY_SECTION_POWER) {
+    bitWrite(w, t.shedTier & 0x03, 2);
+    bitWrite(w, t.shedEvents & 0x3F, 6);
+  }
+  if (t.sections & TELEMETRY_SECTION_EVENT) {
+    bitWrite(w, t.eventCode & 0x07, 3);
+    bitWrite(w, t.eventValue > 31 ? 31 : t.eventValue, 5);
+  }
+  if (t.sections & TELEMETRY_SECTION_WINDOW) {
+    bitWrite(w, telemetryQuantize(t.powerMin, 0.0f, 0.1f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.powerMax, 0.0f, 0.1f, 10), 10);
+    bitWrite(w, telemetryQuantize(t.verticalSpeedMin, -12.8f, 0.1f, 8), 8);
+    bitWrite(w, telemetryQuantize(t.verticalSpeedMax, -12.8f, 0.1f, 8), 8);
+    bitWrite(w, telemetryQuantize(t.packVoltageMin, 8.0f, 0.05f, 8), 8);
+    bitWrite(w, t.maxThreat & 0x03, 2);
+    bitWrite(w, t.detections > 15 ? 15 : t.detections, 4);
+    bitWrite(w, t.stateChanges > 7 ? 7 : t.stateChanges, 3);
+    bitWrite(w, telemetryQuantize(t.airtimeUsage, 0.0f, 1.0f, 7), 7);
+  }
+  if (t.sections & TELEMETRY_SECTION_COMMAND) {
+    bitWrite(w, t.commandCounter, 16);
+    bitWrite(w, t.commandResult & 0x07, 3);
+  }
+  if (t.sections & TELEMETRY_SECTION_HEALTH) {
+    bitWrite(w, t.healthFlags & 0x1FF, 9);
+    bitWrite(w, telemetryQuantize(t.freeHeapKb, 0.0f, 2.0f, 8), 8);
+    bitWrite(w, t.i2cErrors, 8);
+    bitWrite(w, t.loraTxFailures & 0x3F, 6);
+    bitWrite(w, t.loopOverruns, 8);
+    bitWrite(w, t.piRate > 31 ? 31 : t.piRate, 5);
+    bitWrite(w, telemetryQuantize(t.piAgeSeconds, 0.0f, 0.1f, 6), 6);
+  }
+}
+
+// Returns the frame length in bytes, 0 if it does not fit
+inline size_t telemetryEncode(const TelemetrySnapshot &t, uint8_t *buffer, size_t capacity) {
+  BitWriter w;
+  bitWriterInit(w, buffer, capacity);
+  telemetryWriteHeader(w, t);
+  telemetryWriteCore(w, t);
+  telemetryWriteSections(w, t);
+  return w.overflow ? 0 : bitWriterBytes(w);
+}
+
+inline void telemetryReadCore(BitReader &r, TelemetrySnapshot &t) {
+  t.timeSeconds = bitRead(r, 16);
+  t.state = (uint8_t)bitRead(r, 2);
+  t.threat = (uint8_t)bitRead(r, 2);
+  t.battery = telemetryDequantize(bitRead(r, 7), 0.0f, 1.0f);
+  t.power = telemetryDequantize(bitRead(r, 10), 0.0f, 0.1f);
+  t.altitude = telemetryDequantize(bitRead(r, 14), -500.0f, 0.5f);
+  t.verticalSpeed = telemetryDequantize(bitRead(r, 8), -12.8f, 0.1f);
+  t.temperature = telemetryDequantize(bitRead(r, 8), -40.0f, 0.5f);
+}
+
+// Sections of a frame of the given version
+inline void telemetryReadSections(BitReader &r, TelemetrySnapshot &t, uint32_t version = TELEMETRY_VERSION) {
+  if (t.sections & TELEMETRY_SECTION_BIRD) {
+    t.birdConfidence = (uint8_t)bitRead(r, 7);
+    t.birdDistance = telemetryDequantize(bitRead(r, 10), 0.0f, 1.0f);
+    t.birdBearing = telemetryDequantize(bitRead(r, 8), -180.0f, 1.5f);
+    t.birdSpecies = (uint8_t)bitRead(r, 3);
+  }
+  if (t.sections & TELEMETRY_SECTION_ENDURANCE) {
+    t.enduranceSeconds = telemetryDequantize(bitRead(r, 10), 0.0f, 10.0f);
+    t.enduranceLowSeconds = telemetryDequantize(bitRead(r, 10), 0.0f, 10.0f);
+    t.enduranceHighSeconds = telemetryDequantize(bitRead(r, 10), 0.0f, 10.0f);
+    if (version >= 3) {
+      t.rangeMeters = telemetryDequantize(bitRead(r, 10), 0.0f, 150.0f);
+      t.rangeLowMeters = telemetryDequantize(bitRead(r, 10), 0.0f, 150.0f);
+    } else {
+      t.rangeMeters = t.rangeLowMeters = 0.0f;
+    }
+  }
+  if (t.sections & TELEMETRY_SECTION_POWER) {
+    t.shedTier = (uint8_t)bitRead(r, 2);
+    t.shedEvents = (uint8_t)bitRead(r, 6);
+  }
+  if (t.sections & TELEMETRY_SECTION_EVENT) {
+    t.eventCode = (uint8_t)bitRead(r, 3);
+    t.eventValue = (uint8_t)bitRead(r, 5);
+  }
+  if (t.sections & TELEMETRY_SECTION_WINDOW) {
+    t.powerMin = telemetryDequantize(bitRead(r, 10), 0.0f, 0.1f);
+    t.powerMax = telemetryDequantize(bitRead(r, 10), 0.0f, 0.1f);
+    t.verticalSpeedMin = telemetryDequantize(bitRead(r, 8), -12.8f, 0.1f);
+    t.verticalSpeedMax = telemetryDequantize(bitRead(r, 8), -12.8f, 0.1f);
+    t.packVoltageMin = telemetryDequantize(bitRead(r, 8), 8.0f, 0.05f);
+    t.maxThreat = (uint8_t)bitRead(r, 2);
+    t.detections = (uint8_t)bitRead(r, 4);
+    t.stateChanges = (uint8_t)bitRead(r, 3);
+    t.airtimeUsage = telemetryDequantize(bitRead(r, 7), 0.0f, 1.0f);
+  }
+  if (t.sections & TELEMETRY_SECTION_COMMAND) {
+    t.commandCounter = (uint16_t)bitRead(r, 16);
+    t.commandResult = (uint8_t)bitRead(r, 3);
+  }
+  if (t.sections & TELEMETRY_SECTION_HEALTH) {
+    t.healthFlags = (uint16_t)bitRead(r, 9);
+    t.freeHeapKb = telemetryDequantize(bitRead(r, 8), 0.0f, 2.0f);
+    t.i2cErrors = (uint8_t)bitRead(r, 8);
+    t.loraTxFailures = (uint8_t)bitRead(r, 6);
+    t.loopOverruns = (uint8_t)bitRead(r, 8);
+    t.piRate = (uint8_t)bitRead(r, 5);
+    t.piAgeSeconds = telemetryDequantize(bitRead(r, 6), 0.0f, 0.1f);
+  }
+}
+
+// Width of the section bitmap in a frame of the given version, 0 if unknown
+inline int telemetrySectionBits(uint32_t version) {
+  if (version == 2 || version == TELEMETRY_VERSION) return 7;
+  return version == 1 ? 6 : 0;
+}
+
+// Returns false for a truncated frame or an unknown version
+inline bool telemetryDecode(const uint8_t *buffer, size_t length, TelemetrySnapshot &t) {
+  BitReader r;
+  bitReaderInit(r, buffer, length);
+  uint32_t version = bitRead(r, 3);
+  int sectionBits = telemetrySectionBits(version);
+  if (sectionBits == 0) return false;
+  t.type = (uint8_t)bitRead(r, 3);
+  t.sequence = (uint8_t)bitRead(r, 8);
+  t.sections = (uint8_t)bitRead(r, sectionBits);
+  telemetryReadCore(r, t);
+  telemetryReadSections(r, t, version);
+  return !r.underflow;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Priority Telemetry Queue
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Bounded queue of telemetry snapshots waiting for the radio. Events
+ * (threat escalation, state change, strike) always leave before periodic
+ * status; within a class messages leave in arrival order. A new status
+ * replaces the one still waiting instead of queueing behind it, messages
+ * older than their class limit are dropped rather than sent late, and a
+ * full queue makes room for an event by dropping the oldest status.
+ *
+ * Snapshots are queued rather than encoded frames so the sequence number
+ * is assigned when a frame actually goes on air.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include <stdint.h>
+
+#include "telemetry_frame.h"
+
+#define TELEMETRY_QUEUE_SIZE     8
+
+enum TelemetryPriority {
+  TELEMETRY_PRIORITY_EVENT = 0,
+  TELEMETRY_PRIORITY_STATUS = 1,
+  TELEMETRY_PRIORITIES = 2
+};
+
+// Age beyond which a message is no longer worth its airtime
+static const unsigned long TELEMETRY_MAX_AGE_MS[TELEMETRY_PRIORITIES] = {
+  30000,  // Events
+  3000    // Status - a fresher one is never far behind
+};
+
+struct TelemetryQueueEntry {
+  bool used;
+  uint8_t priority;
+  uint32_t ticket;          // Arrival order
+  unsigned long enqueued;   // ms
+  TelemetrySnapshot snapshot;
+};
+
+struct TelemetryClassStats {
+  uint32_t queued;
+  uint32_t sent;
+  uint32_t coalesced;       // Replaced by a newer message before sending
+  uint32_t stale;           // Dropped for age
+  uint32_t overflow;        // Dropped for space
+  uint32_t latencySumMs;    // Queue wait of sent messages
+  uint32_t latencyMaxMs;
+};
+
+struct TelemetryQueue {
+  TelemetryQueueEntry entries[TELEMETRY_QUEUE_SIZE];
+  uint32_t nextTicket;
+  TelemetryClassStats stats[TELEMETRY_PRIORITIES];
+};
+
+inline void telemetryQueueInit(TelemetryQueue &q) {
+  for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) q.entries[i].used = false;
+  q.nextTicket = 0;
+  for (int c = 0; c < TELEMETRY_PRIORITIES; c++) {
+    TelemetryClassStats &s = q.stats[c];
+    s.queued = s.sent = s.coalesced = s.stale = s.overflow = 0;
+    s.latencySumMs = s.latencyMaxMs = 0;
+  }
+}
+
+// Oldest entry of a class, -1 if none
+inline int telemetryQueueOldest(const TelemetryQueue &q, int priority) {
+  int oldest = -1;
+  for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+    const TelemetryQueueEntry &e = q.entries[i];
+    if (!e.used || e.priority != priority) continue;
+    if (oldest < 0 || e.ticket < q.entries[oldest].ticket) oldest = i;
+  }
+  return oldest;
+}
+
+inline int telemetryQueueCount(const TelemetryQueue &q) {
+  int count = 0;
+  for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) count += q.entries[i].used ? 1 : 0;
+  return count;
+}
+
+// Returns false if the message was dropped
+inline bool telemetryQueuePush(TelemetryQueue &q, int priority, const TelemetrySnapshot &snapshot,
+                               unsigned long nowMs) {
+  q.stats[priority].queued++;
+
+  // Periodic status: refresh the waiting one in place
+  if (priority == TELEMETRY_PRIORITY_STATUS) {
+    int waiting = telemetryQueueOldest(q, priority);
+    if (waiting >= 0) {
+      q.entries[waiting].snapshot = snapshot;
+      q.entries[waiting].enqueued = nowMs;
+      q.stats[priority].coalesced++;
+      return true;
+    }
+  }
+
+  int slot = -1;
+  for (int i = 0; i < TELEMETRY_QUEUE_SIZE && slot < 0; i++) {
+    if (!q.entries[i].used) slot = i;
+  }
+  if (slot < 0) {
+    // Full: events displace status, then the oldest event
+    slot = telemetryQueueOldest(q, TELEMETRY_PRIORITY_STATUS);
+    if (slot < 0 && priority == TELEMETRY_PRIORITY_EVENT) slot = telemetryQueueOldest(q, TELEMETRY_PRIORITY_EVENT);
+    if (slot < 0) {
+      q.stats[priority].overflow++;
+      return false;
+    }
+    q.stats[q.entries[slot].priority].overflow++;
+  }
+
+  TelemetryQueueEntry &e = q.entries[slot];
+  e.used = true;
+  e.priority = (uint8_t)priority;
+  e.ticket = q.nextTicket++;
+  e.enqueued = nowMs;
+  e.snapshot = snapshot;
+  return true;
+}
+
+// Drop messages past their age limit, then return the entry to send next
+// (highest priority, oldest first), -1 when empty. The entry stays queued.
+inline int telemetryQueuePeek(TelemetryQueue &q, unsigned long nowMs) {
+  for (int i = 0; i < TELEMETRY_QUEUE_SIZE; i++) {
+    TelemetryQueueEntry &e = q.entries[i];
+    if (e.used && nowMs - e.enqueued > TELEMETRY_MAX_AGE_MS[e.priority]) {
+      e.used = false;
+      q.stats[e.priority].stale++;
+    }
+  }
+  for (int c = 0; c < TELEMETRY_PRIORITIES; c++) {
+    int next = telemetryQueueOldest(q, c);
+    if (next >= 0) return next;
+  }
+  return -1;
+}
+
+// Remove a peeked entry for sending
+inline void telemetryQueueTake(TelemetryQueue &q, int index, unsigned long nowMs, TelemetrySnapshot &out) {
+  TelemetryQueueEntry &e = q.entries[index];
+  uint32_t latency = (uint32_t)(nowMs - e.enqueued);
+  TelemetryClassStats &s = q.stats[e.priority];
+  s.sent++;
+  s.latencySumMs += latency;
+  if (latency > s.latencyMaxMs) s.latencyMaxMs = latency;
+  out = e.snapshot;
+  e.used = false;
+}
+
+// Next message to send. Returns false when empty.
+inline bool telemetryQueuePop(TelemetryQueue &q, unsigned long nowMs, TelemetrySnapshot &out,
+                              int *priorityOut = 0) {
+  int next = telemetryQueuePeek(q, nowMs);
+  if (next < 0) return false;
+  if (priorityOut) *priorityOut = q.entries[next].priority;
+  telemetryQueueTake(q, next, nowMs, out);
+  return true;
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Telemetry Transport Selection
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Close in, telemetry goes over ESP-NOW to a ground node at the rate of
+ * the IMU profile (20..100 Hz) instead of one LoRa packet a second.
+ * Samples are the usual telemetry frames (telemetry_frame.h), batched
+ * into one ESP-NOW payload:
+ *
+ *   byte 0     version 3 | TELEMETRY_BATCH 3 | 0 2
+ *   byte 1     batch sequence
+ *   bytes 2-5  ms since boot of the first sample
+ *   byte 6     sample count
+ *   then per sample:  ms after the first 2 | frame length 1 | frame
+ *
+ * Every frame is a full one (not a delta), so a lost batch costs only its
+ * own samples. Unicast ESP-NOW is acknowledged at the MAC layer, which is
+ * what the selector runs on: ESP-NOW takes over after a run of acked
+ * probes (sent alongside the LoRa status while out of range) and hands
+ * back to LoRa after a run of unacked batches, so a drone leaving the
+ * base falls back within a few hundred ms and does not flap at the edge.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_TRANSPORT_H
+#define TELEMETRY_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "telemetry_frame.h"
+
+#define ESPNOW_MAX_PAYLOAD       250
+#define TELEMETRY_BATCH          4      // Message type of an ESP-NOW batch
+#define TELEMETRY_BATCH_HEADER   7
+#define TELEMETRY_BATCH_ENTRY    3      // Per-sample overhead
+#define TRANSPORT_UP_STREAK      3      // Acked probes in a row before ESP-NOW takes over
+#define TRANSPORT_DOWN_STREAK    3      // Unacked batches in a row before LoRa takes back
+
+enum TelemetryLink {
+  TELEMETRY_LINK_LORA = 0,
+  TELEMETRY_LINK_ESPNOW = 1
+};
+
+struct TelemetryBatch {
+  uint8_t data[ESPNOW_MAX_PAYLOAD];
+  size_t length;            // 0 until the first sample
+  uint8_t count;
+  uint32_t baseMs;
+};
+
+struct TransportSelector {
+  uint8_t link;             // TelemetryLink
+  uint8_t streak;           // Acked (on LoRa) / unacked (on ESP-NOW) in a row
+  uint32_t sent;
+  uint32_t acked;
+  uint32_t switches;
+};
+
+inline void telemetryBatchClear(TelemetryBatch &b) {
+  b.length = 0;
+  b.count = 0;
+  b.baseMs = 0;
+}
+
+// Encodes the sample in place; false (batch unchanged) when it does not fit
+inline bool telemetryBatchAdd(TelemetryBatch &b, uint8_t sequence, const TelemetrySnapshot &t, uint32_t nowMs) {
+  if (b.length == 0) {
+    b.data[0] = (uint8_t)((TELEMETRY_VERSION << 5) | (TELEMETRY_BATCH << 2));
+    b.data[1] = sequence;
+    b.data[2] = (uint8_t)nowMs;
+    b.data[3] = (uint8_t)(nowMs >> 8);
+    b.data[4] = (uint8_t)(nowMs >> 16);
+    b.data[5] = (uint8_t)(nowMs >> 24);
+    b.data[6] = 0;
+    b.length = TELEMETRY_BATCH_HEADER;
+    b.count = 0;
+    b.baseMs = nowMs;
+  }
+  uint32_t offset = nowMs - b.baseMs;
+  if (b.count == 255 || offset > 0xFFFF || b.length + TELEMETRY_BATCH_ENTRY >= ESPNOW_MAX_PAYLOAD) return false;
+
+  uint8_t *entry = b.data + b.length;
+  size_t frame = telemetryEncode(t, entry + TELEMETRY_BATCH_ENTRY,
+                                 ESPNOW_MAX_PAYLOAD - b.length - TELEMETRY_BATCH_ENTRY);
+  if (frame == 0) return false;
+  entry[0] = (uint8_t)offset;
+  entry[1] = (uint8_t)(offset >> 8);
+  entry[2] = (uint8_t)frame;
+  b.length += TELEMETRY_BATCH_ENTRY + frame;
+  b.data[6] = ++b.count;
+  return true;
+}
+
+inline bool telemetryIsBatch(const uint8_t *buffer, size_t length) {
+  return length >= TELEMETRY_BATCH_HEADER && ((buffer[0] >> 2) & 0x07) == TELEMETRY_BATCH;
+}
+
+// Walks the samples of a received batch: start with offset 0, returns
+// false at the end or on a malformed entry
+inline bool telemetryBatchNext(const uint8_t *buffer, size_t length, size_t &offset,
+                               TelemetrySnapshot &t, uint32_t &ms) {
+  if (offset == 0) offset = TELEMETRY_BATCH_HEADER;
+  if (offset + TELEMETRY_BATCH_ENTRY > length) return false;
+  const uint8_t *entry = buffer + offset;
+  size_t frame = entry[2];
+  if (frame == 0 || offset + TELEMETRY_BATCH_ENTRY + frame > length) return false;
+  if (!telemetryDecode(entry + TELEMETRY_BATCH_ENTRY, frame, t)) return false;
+  uint32_t base = buffer[2] | (uint32_t)buffer[3] << 8 | (uint32_t)buffer[4] << 16 | (uint32_t)buffer[5] << 24;
+  ms = base + (entry[0] | (uint32_t)entry[1] << 8);
+  offset += TELEMETRY_BATCH_ENTRY + frame;
+  return true;
+}
+
+inline void transportSelectorInit(TransportSelector &sel) {
+  sel.link = TELEMETRY_LINK_LORA;
+  sel.streak = 0;
+  sel.sent = 0;
+  sel.acked = 0;
+  sel.switches = 0;
+}
+
+// Outcome of one ESP-NOW send (probe or batch). Returns true when the
+// link changes.
+inline bool transportOnResult(TransportSelector &sel, bool acked) {
+  sel.sent++;
+  if (acked) sel.acked++;
+
+  // The streak only runs while results point away from the current link
+  bool against = sel.link == TELEMETRY_LINK_LORA ? acked : !acked;
+  sel.streak = against ? sel.streak + 1 : 0;
+  uint8_t needed = sel.link == TELEMETRY_LINK_LORA ? TRANSPORT_UP_STREAK : TRANSPORT_DOWN_STREAK;
+  if (sel.streak < needed) return false;
+
+  sel.link = sel.link == TELEMETRY_LINK_LORA ? TELEMETRY_LINK_ESPNOW : TELEMETRY_LINK_LORA;
+  sel.streak = 0;
+  sel.switches++;
+  return true;
+}
+
+// ESP-NOW unusable (radio handed to the log offload): back to LoRa at once
+inline bool transportForceLoRa(TransportSelector &sel) {
+  sel.streak = 0;
+  if (sel.link == TELEMETRY_LINK_LORA) return false;
+  sel.link = TELEMETRY_LINK_LORA;
+  sel.switches++;
+  return true;
+}
+
+#endif
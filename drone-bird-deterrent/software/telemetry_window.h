@@ -0,0 +1,60 @@
+/*
+ * Telemetry Aggregation Window
+ * Aerohacks 2025 - Drone Bird Deterrent System
+ *
+ * Running min / max / mean and event counts between two status packets,
+ * so a current spike or a short-lived threat between 1Hz samples still
+ * reaches the ground. Constant memory: each statistic is updated in place
+ * and the window restarts when its summary is packed into a frame.
+ *
+ * Plain C++ with no Arduino dependencies.
+ */
+
+#ifndef TELEMETRY_WINDOW_H
+#define TELEMETRY_WINDOW_H
+
+#include <stdint.h>
+
+struct WindowStat {
+  float minimum;
+  float maximum;
+  float sum;
+  uint32_t count;
+};
+
+inline void windowStatReset(WindowStat &s) {
+  s.minimum = s.maximum = s.sum = 0.0f;
+  s.count = 0;
+}
+
+inline void windowStatAdd(WindowStat &s, float value) {
+  if (s.count == 0 || value < s.minimum) s.minimum = value;
+  if (s.count == 0 || value > s.maximum) s.maximum = value;
+  s.sum += value;
+  s.count++;
+}
+
+// Mean over the window, fallback if nothing was sampled
+inline float windowStatMean(const WindowStat &s, float fallback) {
+  return s.count ? s.sum / s.count : fallback;
+}
+
+struct TelemetryWindow {
+  WindowStat power;           // W, every INA219 sweep
+  WindowStat verticalSpeed;   // m/s, every IMU sample
+  WindowStat packVoltage;     // V, every loop (brownout supervisor)
+  uint8_t maxThreat;
+  uint16_t detections;        // Detection messages from the Pi
+  uint16_t stateChanges;
+};
+
+inline void telemetryWindowReset(TelemetryWindow &win) {
+  windowStatReset(win.power);
+  windowStatReset(win.verticalSpeed);
+  windowStatReset(win.packVoltage);
+  win.maxThreat = 0;
+  win.detections = 0;
+  win.stateChanges = 0;
+}
+
+#endif